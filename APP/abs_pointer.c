@@ -0,0 +1,239 @@
+/*********************************************************************
+ * File Name          : abs_pointer.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 绝对坐标指针 / 数位板解码
+ *                      - 数位板、触摸屏在非驱动模式下通常声明为 Boot 鼠标接口，
+ *                        但按报告协议上报绝对坐标，鼠标的按长度猜测格式会读错
+ *                      - 鼠标类设备首次出现 (端口或 VID/PID 变化) 时补读配置描述符与报告描述符 (hid_desc.c)：
+ *                        找到含绝对 X 的第一个输入报告，记录 X/Y/压力/笔尖/侧键/橡皮擦/
+ *                        在感应范围/按键 1~2 的位偏移、位宽与逻辑范围
+ *                      - 逻辑范围到输出范围的缩放预先算成 Q16 系数，解码时只做一次乘法和移位
+ *                      - 中断端点的 bInterval 作为轮询周期下限，每个笔迹点都能读到
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "hidkbdservice.h"
+#include "hid_desc.h"
+#include "abs_pointer.h"
+#include "debug.h"
+
+// ===================================================================
+// 字段
+// ===================================================================
+enum {
+    ABS_F_X,
+    ABS_F_Y,
+    ABS_F_PRESSURE,
+    ABS_F_TIP,
+    ABS_F_BARREL,
+    ABS_F_ERASER,
+    ABS_F_RANGE,
+    ABS_F_BTN1,
+    ABS_F_BTN2,
+    ABS_F_NUM
+};
+
+static const uint32_t abs_usage_tbl[ABS_F_NUM] = {
+    HID_USAGE(0x01, 0x30),  // Generic Desktop: X
+    HID_USAGE(0x01, 0x31),  // Generic Desktop: Y
+    HID_USAGE(0x0D, 0x30),  // Digitizer: Tip Pressure
+    HID_USAGE(0x0D, 0x42),  // Digitizer: Tip Switch
+    HID_USAGE(0x0D, 0x44),  // Digitizer: Barrel Switch
+    HID_USAGE(0x0D, 0x45),  // Digitizer: Eraser
+    HID_USAGE(0x0D, 0x32),  // Digitizer: In Range
+    HID_USAGE(0x09, 0x01),  // Button 1 (无笔尖开关的绝对指针当作笔尖)
+    HID_USAGE(0x09, 0x02),  // Button 2 (当作侧键)
+};
+
+// X/Y/压力的输出范围
+static const uint16_t abs_out_max[ABS_F_PRESSURE + 1] = {
+    HID_ABS_XY_MAX, HID_ABS_XY_MAX, HID_ABS_PRESSURE_MAX
+};
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+#define ABS_PORT_NONE             0xFF
+
+static HidField_t abs_field[ABS_F_NUM];
+static uint32_t   abs_scale[ABS_F_PRESSURE + 1];   // X/Y/压力的 Q16 缩放系数
+static uint8_t    abs_port       = ABS_PORT_NONE;  // 已探测的端口 (0 = 根端口，N = HUB 端口 N)
+static uint16_t   abs_vid        = 0;              // 已探测设备的 VID/PID (同一端口换插其他设备时重新探测)
+static uint16_t   abs_pid        = 0;
+static uint8_t    abs_active     = FALSE;          // 当前鼠标是绝对坐标设备
+static uint8_t    abs_rpt_id     = 0;              // 笔迹所在报告 ID (0 = 设备不使用报告 ID)
+static uint8_t    abs_min_len    = 0;              // 覆盖 X/Y 所需的最短报文 (不含报告 ID)
+static uint16_t   abs_poll_ticks = 0;              // 中断端点 bInterval 折算的轮询周期 (tick)
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+/**
+ * @brief 预计算缩放系数，检查必要字段
+ * @return TRUE 至少有有效的绝对 X/Y
+ */
+static uint8_t AbsPtr_Setup(void)
+{
+    uint8_t  f;
+    uint16_t end;
+
+    for (f = ABS_F_X; f <= ABS_F_PRESSURE; f++) {
+        abs_scale[f] = HidDesc_ScaleQ16(&abs_field[f], abs_out_max[f]);
+        if (abs_scale[f] == 0 || (abs_field[f].flags & HID_INPUT_RELATIVE)) {
+            abs_field[f].size = 0;
+        }
+    }
+    if (abs_field[ABS_F_X].size == 0 || abs_field[ABS_F_Y].size == 0) return FALSE;
+
+    abs_min_len = 0;
+    for (f = ABS_F_X; f <= ABS_F_Y; f++) {
+        end = abs_field[f].pos + abs_field[f].size;
+        if ((end + 7) / 8 > abs_min_len) abs_min_len = (end + 7) / 8;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 取 X/Y/压力并映射到输出范围
+ */
+static uint16_t AbsPtr_Scaled(uint8_t f, const uint8_t *buf, uint8_t len)
+{
+    return HidDesc_Scale(&abs_field[f], abs_scale[f],
+                         HidDesc_GetValue(&abs_field[f], 0, buf, len), abs_out_max[f]);
+}
+
+/**
+ * @brief 取开关字段，设备无此字段时返回 -1
+ */
+static int8_t AbsPtr_Switch(uint8_t f, const uint8_t *buf, uint8_t len)
+{
+    if (abs_field[f].size == 0) return -1;
+    return HidDesc_GetValue(&abs_field[f], 0, buf, len) ? 1 : 0;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 鼠标设备拔出或重新枚举：下次出现时重新探测
+ */
+void AbsPtr_Reset(void)
+{
+    if (abs_port == ABS_PORT_NONE) return;   // 未探测过，字段本来就是空的
+    memset(abs_field, 0, sizeof(abs_field));
+    abs_port       = ABS_PORT_NONE;
+    abs_active     = FALSE;
+    abs_rpt_id     = 0;
+    abs_poll_ticks = 0;
+}
+
+/**
+ * @brief 鼠标设备出现在某端口：端口或 VID/PID 与上次探测不同时读取描述符识别绝对坐标字段
+ * @param hub_port  0 = 根端口，N = HUB 端口 N (调用前已 SelectU2HubPort)
+ */
+void AbsPtr_Attach(uint8_t hub_port)
+{
+    HidIfInfo_t info;
+    uint8_t    *desc;
+    uint8_t     len;
+    int16_t     id;
+    uint16_t    vid = hub_port ? DevOnU2HubPort[hub_port - 1].DeviceVID : ThisUsb2Dev.DeviceVID;
+    uint16_t    pid = hub_port ? DevOnU2HubPort[hub_port - 1].DevicePID : ThisUsb2Dev.DevicePID;
+
+    if (abs_port == hub_port && abs_vid == vid && abs_pid == pid) return;
+    AbsPtr_Reset();
+    abs_port = hub_port;
+    abs_vid  = vid;
+    abs_pid  = pid;
+
+    if (HidDesc_ReadConfig(&info) != ERR_SUCCESS) return;
+    desc = HidDesc_ReadReport(&info, &len);
+    if (desc == NULL) return;
+
+    id = HidDesc_FindAbsInput(desc, len, HID_APP_ANY, abs_usage_tbl[ABS_F_X]);
+    if (id >= 0) {
+        abs_rpt_id = (uint8_t)id;
+        HidDesc_MapInput(desc, len, abs_rpt_id, abs_usage_tbl, ABS_F_NUM, abs_field);
+        abs_active = AbsPtr_Setup();
+    }
+    tmos_msg_deallocate(desc);
+
+    if (!abs_active) return;
+
+    // 轮询周期跟随设备的端点间隔 (全速/低速 bInterval 单位 ms)
+    abs_poll_ticks = MS1_TO_SYSTEM_TIME(info.interval ? info.interval : 1);
+    if (abs_poll_ticks == 0) abs_poll_ticks = 1;
+
+    LOG_USB("Abs pointer: port %d id %d, X %d bit [%ld..%ld], pressure %d bit, poll %d ms\n",
+            hub_port, abs_rpt_id, abs_field[ABS_F_X].size,
+            abs_field[ABS_F_X].lmin, abs_field[ABS_F_X].lmax,
+            abs_field[ABS_F_PRESSURE].size, info.interval);
+}
+
+/**
+ * @brief 当前鼠标是否按绝对坐标设备解码
+ */
+uint8_t AbsPtr_IsActive(void)
+{
+    return abs_active;
+}
+
+/**
+ * @brief 绝对坐标设备的轮询周期 (tick)，未识别时返回 0
+ */
+uint16_t AbsPtr_GetPollTicks(void)
+{
+    return abs_active ? abs_poll_ticks : 0;
+}
+
+/**
+ * @brief 解码一帧中断 IN 数据
+ * @param buf     原始数据
+ * @param len     数据长度
+ * @param report  输出 HID_ABS_IN_RPT_LEN 字节数位笔报文 [开关位, X, Y, 压力]
+ * @return TRUE 是笔迹报文；其他报告 ID (如数位板快捷键) 返回 FALSE
+ */
+uint8_t AbsPtr_Decode(const uint8_t *buf, uint8_t len, uint8_t *report)
+{
+    int8_t   tip, barrel, eraser, range;
+    uint16_t x, y, p;
+
+    if (!abs_active) return FALSE;
+    if (abs_rpt_id) {
+        if (len == 0 || buf[0] != abs_rpt_id) return FALSE;
+        buf++;
+        len--;
+    }
+    if (len < abs_min_len) return FALSE;
+
+    // 没有数位板用法的绝对指针 (触摸屏、KVM 绝对鼠标)：按键 1/2 当作笔尖/侧键
+    tip    = AbsPtr_Switch(ABS_F_TIP, buf, len);
+    barrel = AbsPtr_Switch(ABS_F_BARREL, buf, len);
+    eraser = AbsPtr_Switch(ABS_F_ERASER, buf, len);
+    range  = AbsPtr_Switch(ABS_F_RANGE, buf, len);
+    if (tip < 0)    tip    = (AbsPtr_Switch(ABS_F_BTN1, buf, len) > 0);
+    if (barrel < 0) barrel = (AbsPtr_Switch(ABS_F_BTN2, buf, len) > 0);
+    if (range < 0)  range  = 1;
+
+    x = AbsPtr_Scaled(ABS_F_X, buf, len);
+    y = AbsPtr_Scaled(ABS_F_Y, buf, len);
+    if (abs_field[ABS_F_PRESSURE].size) {
+        p = AbsPtr_Scaled(ABS_F_PRESSURE, buf, len);
+    } else {
+        p = tip ? HID_ABS_PRESSURE_MAX : 0;
+    }
+
+    report[0] = (tip    ? HID_ABS_SW_TIP     : 0) |
+                (barrel ? HID_ABS_SW_BARREL  : 0) |
+                (eraser > 0 ? HID_ABS_SW_ERASER : 0) |
+                (range  ? HID_ABS_SW_IN_RANGE : 0);
+    report[1] = LO_UINT16(x);
+    report[2] = HI_UINT16(x);
+    report[3] = LO_UINT16(y);
+    report[4] = HI_UINT16(y);
+    report[5] = LO_UINT16(p);
+    report[6] = HI_UINT16(p);
+    return TRUE;
+}
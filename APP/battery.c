@@ -0,0 +1,190 @@
+/*********************************************************************
+ * File Name          : battery.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 电池电量子系统
+ *                      - 唯一的 ADC 持有者，每次采样前重新配置、采完关断
+ *                      - 放电曲线查表 + 线性插值
+ *                      - 迟滞上报：只有变化超过阈值才通知 Battery Service
+ *                      - 低电量状态带迟滞，供指示灯逻辑使用
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "battservice.h"
+#include "battery.h"
+#include "hidkbd.h"
+#include "debug.h"
+
+// ===================================================================
+// 硬件引脚配置 (Hardware Config)
+// ===================================================================
+
+// 电池检测 (ADC -> PA4)
+#define BATT_ADC_PIN         GPIO_Pin_4
+#define BATT_ADC_CHANNEL     0            // ADC Channel 0
+#define BATT_SAMPLE_COUNT    20           // 软件滤波采样次数
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+
+static signed short ADC_RoughCalib_Value = 0;     // ADC 校准偏移值
+static uint8_t      is_adc_calibrated    = FALSE; // 校准推迟到首次采样，缩短启动路径
+static uint8_t      reported_percent     = 0;     // 已上报给 Battery Service 的电量
+static uint8_t      force_notify         = TRUE;  // 下次采样无条件上报
+static uint8_t      is_batt_low          = FALSE; // 低电量状态 (带迟滞)
+
+// 放电曲线查找表 (mV -> %), 线性插值
+typedef struct { uint16_t mv; uint8_t pct; } BattMap;
+static const BattMap batt_table[] = {
+    {4200, 100},
+    {4100,  95},
+    {4070,  90},
+    {4000,  80},
+    {3910,  70},
+    {3840,  60},
+    {3750,  50},
+    {3660,  40},
+    {3600,  30},
+    {3510,  20},
+    {3450,  15},
+    {3380,  10},
+    {3340,   8},
+    {3300,   6},
+    {3260,   4},
+    {3220,   2},
+    {3180,   1},
+    {3100,   0},
+    {0,      0}  // 结束符（边界保护）
+};
+#define BATT_TABLE_COUNT  (sizeof(batt_table) / sizeof(BattMap))
+
+// ===================================================================
+// 初始化
+// ===================================================================
+void Battery_Init(void)
+{
+    GPIOA_ModeCfg(BATT_ADC_PIN, GPIO_ModeIN_Floating);
+
+    is_adc_calibrated = FALSE;
+    reported_percent  = 0;
+    force_notify      = TRUE;
+    is_batt_low       = FALSE;
+}
+
+// ===================================================================
+// 采样与换算
+// ===================================================================
+
+/**
+ * @brief 采样一次电池电压并换算为百分比
+ * @return 电量百分比 (0~100)
+ */
+static uint8_t Battery_Sample(void)
+{
+    uint32_t adc_sum = 0;
+    uint16_t adc_avg = 0;
+    int32_t  voltage_mv = 0;
+    uint8_t  percent = 0;
+    signed short raw_val;
+
+    // 1. 重新配置 ADC 并切换通道（软件滤波：多次平均），采完关断
+    ADC_ExtSingleChSampInit(SampleFreq_3_2, ADC_PGA_1_2);
+    if (!is_adc_calibrated) {
+        ADC_RoughCalib_Value = ADC_DataCalib_Rough();
+        is_adc_calibrated = TRUE;
+        LOG_BATT("ADC Calib. Offset: %d\n", ADC_RoughCalib_Value);
+    }
+    ADC_ChannelCfg(BATT_ADC_CHANNEL);
+    for (int i = 0; i < BATT_SAMPLE_COUNT; i++) {
+        raw_val = ADC_ExcutSingleConver() + ADC_RoughCalib_Value;
+        if (raw_val < 0) raw_val = 0;
+        adc_sum += raw_val;
+    }
+    ADC_DisablePower();
+    adc_avg = adc_sum / BATT_SAMPLE_COUNT;
+
+    // 2. 电压换算（根据硬件分压电阻）
+    int32_t temp_calc = (int32_t)adc_avg * 2100;
+    voltage_mv = (temp_calc + 512) / 1024 - 2100;
+    if (voltage_mv < 0) voltage_mv = 0;
+
+    // 3. 查表 + 线性插值获得百分比
+    if (voltage_mv >= (int32_t)batt_table[0].mv) {
+        percent = 100;
+    } else if (voltage_mv <= (int32_t)batt_table[BATT_TABLE_COUNT - 2].mv) {
+        percent = 0;
+    } else {
+        for (int i = 0; i < (int)(BATT_TABLE_COUNT - 1); i++) {
+            if (voltage_mv >= (int32_t)batt_table[i + 1].mv) {
+                uint16_t high_mv  = batt_table[i].mv;
+                uint16_t low_mv   = batt_table[i + 1].mv;
+                uint8_t  high_pct = batt_table[i].pct;
+                uint8_t  low_pct  = batt_table[i + 1].pct;
+                // 线性插值
+                percent = low_pct + (uint32_t)(voltage_mv - low_mv) * (high_pct - low_pct) / (high_mv - low_mv);
+                break;
+            }
+        }
+    }
+
+    LOG_BATT("ADC:%d  V:%dmV  Pct:%d%%\n", adc_avg, (int)voltage_mv, percent);
+    return percent;
+}
+
+// ===================================================================
+// 对外接口 (Public APIs)
+// ===================================================================
+
+/**
+ * @brief 执行一次电量检测（唯一的采样入口，由 HidEmu 统一调度）
+ *        - 变化达到迟滞阈值（或被强制）才推送到 Battery Service
+ *        - 同步更新低电量状态
+ * @return 当前已上报的电量百分比
+ */
+uint8_t Battery_Update(void)
+{
+    uint8_t percent = Battery_Sample();
+    uint8_t diff = (percent > reported_percent) ? (percent - reported_percent)
+                                                : (reported_percent - percent);
+
+    // 1. 迟滞上报：抖动小于阈值不通知，到达 0%/100% 端点时总是上报
+    if (force_notify || diff >= BATT_REPORT_HYSTERESIS ||
+        (diff != 0 && (percent == 0 || percent == 100))) {
+        force_notify = FALSE;
+        reported_percent = percent;
+        Batt_SetParameter(BATT_PARAM_LEVEL, sizeof(uint8_t), &reported_percent);
+    }
+
+    // 2. 低电量状态：低于阈值进入，高出迟滞带才退出
+    if (percent <= BATT_LOW_THRESHOLD) {
+        is_batt_low = TRUE;
+    } else if (percent >= BATT_LOW_THRESHOLD + BATT_LOW_HYSTERESIS) {
+        is_batt_low = FALSE;
+    }
+
+    return reported_percent;
+}
+
+/**
+ * @brief 下次检测无条件上报（新连接建立后调用）
+ */
+void Battery_ForceNotify(void)
+{
+    force_notify = TRUE;
+}
+
+/**
+ * @brief 获取当前已上报的电量百分比
+ */
+uint8_t Battery_GetLevel(void)
+{
+    return reported_percent;
+}
+
+/**
+ * @brief 是否处于低电量状态
+ */
+uint8_t Battery_IsLow(void)
+{
+    return is_batt_low;
+}
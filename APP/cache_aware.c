@@ -0,0 +1,294 @@
+/*********************************************************************
+ * File Name          : cache_aware.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 已绑定主机的 GATT 缓存同步状态 (change-aware)
+ *                      - 启动时遍历属性数据库 (GATT_FindHandle) 计算摘要：句柄、类型、
+ *                        服务 UUID、特征属性与报告描述符内容；每个已绑定主机记录它最后同步过的
+ *                        摘要，存入 data flash
+ *                      - 回连加密后：记录的摘要与当前一致，主机缓存有效，不做任何事；
+ *                        不一致或无记录 (固件更新改变了数据库，或绑定早于本功能) 时经库自带
+ *                        GATT 服务发送 Service Changed 指示，主机确认后记为已同步；主机未订阅
+ *                        Service Changed 时无从通知，不记为已同步 (下次回连再试)
+ *                      - 不提供 Database Hash / Client Supported Features：库自带的 GATT 服务
+ *                        无法扩展，主机只能经 Service Changed 得知数据库变化
+ *                      - 新绑定：主机刚做完完整服务发现，直接记为已同步
+ *                      - 主机按连接建立时的地址识别 (控制器已按解析列表解析随机私有地址)
+ *                      - 统计回连后首个报文耗时：连接建立 → 加密 → 首个报文被协议栈接受，
+ *                        按 缓存有效 / 发送 Service Changed / 新绑定 分类累计
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "hiddev.h"
+#include "cache_aware.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+
+// 记录存放在 reconn_adv 之下的一页
+#define CACHE_AWARE_ADDR          (BLE_SNV_ADDR - EEPROM_PAGE_SIZE * 19)
+#define CACHE_AWARE_SLOTS         8       // 记录主机数 (不少于绑定管理器保存的绑定数)
+#define CACHE_AWARE_MAGIC         0xCA02  // 记录有效标志 (结构变化时修改)
+
+// ===================================================================
+// 记录与统计
+// ===================================================================
+typedef struct {
+    uint16_t magic;
+    uint8_t  addr[B_ADDR_LEN];
+    uint32_t digest;                      // 主机最后同步的数据库摘要
+} CacheAwareRec_t;
+
+enum {
+    FIRST_RPT_CACHED,          // 主机缓存有效
+    FIRST_RPT_CHANGED,         // 数据库已变，发送了 Service Changed
+    FIRST_RPT_NEW_BOND,        // 新绑定 (完整服务发现)
+    FIRST_RPT_NUM
+};
+
+static const char *const first_rpt_name[FIRST_RPT_NUM] = { "cached", "service changed", "new bond" };
+
+typedef struct {
+    uint16_t count;
+    uint32_t sec_ms;           // 连接建立到加密完成累计 (ms)
+    uint32_t rpt_ms;           // 连接建立到首个报文累计 (ms)
+} FirstRptStat_t;
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static CacheAwareRec_t rec_tbl[CACHE_AWARE_SLOTS];
+static uint32_t db_digest = 0;
+static uint8_t  cacheAwareTaskId = INVALID_TASK_ID;  // 接收 Service Changed 确认的任务
+
+static uint16_t conn_handle = GAP_CONNHANDLE_INIT;
+static uint8_t  peer_addr[B_ADDR_LEN];
+static uint8_t  is_ind_pending = FALSE;              // Service Changed 等待主机确认
+
+static uint8_t  is_rpt_pending = FALSE;              // 等待本次连接的首个报文
+static uint8_t  rpt_class = FIRST_RPT_CACHED;
+static uint16_t rpt_conn_int = 0;                    // 连接间隔 (1.25ms)
+static uint32_t conn_tick = 0;                       // 连接建立时刻
+static uint32_t sec_tick = 0;                        // 加密完成时刻
+static FirstRptStat_t stat_tbl[FIRST_RPT_NUM];
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+static void CacheAware_Store(void)
+{
+    EEPROM_ERASE(CACHE_AWARE_ADDR, EEPROM_PAGE_SIZE);
+    EEPROM_WRITE(CACHE_AWARE_ADDR, rec_tbl, sizeof(rec_tbl));
+}
+
+static int8_t CacheAware_Find(const uint8_t *addr)
+{
+    for (uint8_t i = 0; i < CACHE_AWARE_SLOTS; i++) {
+        if (rec_tbl[i].magic == CACHE_AWARE_MAGIC && tmos_memcmp(rec_tbl[i].addr, addr, B_ADDR_LEN)) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 将第 idx 项移到表头 (idx 为 CACHE_AWARE_SLOTS - 1 时即淘汰最后一项腾出表头)
+ */
+static void CacheAware_MoveFront(uint8_t idx)
+{
+    CacheAwareRec_t rec = rec_tbl[idx];
+
+    for (; idx > 0; idx--) {
+        rec_tbl[idx] = rec_tbl[idx - 1];
+    }
+    rec_tbl[0] = rec;
+}
+
+/**
+ * @brief 当前主机已与数据库同步：记下当前摘要 (未变化时不写 flash)
+ */
+static void CacheAware_MarkSynced(void)
+{
+    int8_t idx;
+
+    idx = CacheAware_Find(peer_addr);
+    if (idx == 0 && rec_tbl[0].digest == db_digest) {
+        return;
+    }
+    if (idx < 0) {
+        // 新主机：淘汰最久未连的一项
+        CacheAware_MoveFront(CACHE_AWARE_SLOTS - 1);
+        rec_tbl[0].magic = CACHE_AWARE_MAGIC;
+        tmos_memcpy(rec_tbl[0].addr, peer_addr, B_ADDR_LEN);
+    } else {
+        CacheAware_MoveFront((uint8_t)idx);
+    }
+    rec_tbl[0].digest = db_digest;
+    CacheAware_Store();
+
+    LOG_BLE("GATT cache synced\n");
+}
+
+/**
+ * @brief FNV-1a 累加
+ */
+static uint32_t CacheAware_Fold(uint32_t h, const uint8_t *data, uint16_t len)
+{
+    while (len--) {
+        h = (h ^ *data++) * 16777619UL;
+    }
+    return h;
+}
+
+/**
+ * @brief 计算属性数据库摘要
+ *        句柄从 1 连续分配，遇到第一个无属性的句柄结束。每个属性计入句柄与类型，
+ *        服务声明再计入服务 UUID，特征声明再计入特征属性；特征值的句柄与 UUID
+ *        由其后一个属性计入。Report Map 计入全部字节：主机按绑定缓存报告描述符，
+ *        句柄不变而描述符改变 (如新增报告字段) 同样须发送 Service Changed。
+ *        其余属性值 (报告内容、CCCD 等) 不影响主机缓存，不计入
+ */
+static uint32_t CacheAware_Digest(void)
+{
+    uint32_t        h = 2166136261UL;
+    uint16_t        handle, owner, uuid;
+    uint8_t         hdr[2];
+    gattAttribute_t *pAttr;
+
+    for (handle = 1; handle != 0; handle++) {
+        pAttr = GATT_FindHandle(handle, &owner);
+        if (pAttr == NULL) break;
+
+        hdr[0] = LO_UINT16(handle);
+        hdr[1] = HI_UINT16(handle);
+        h = CacheAware_Fold(h, hdr, sizeof(hdr));
+        h = CacheAware_Fold(h, pAttr->type.uuid, pAttr->type.len);
+        if (pAttr->type.len != ATT_BT_UUID_SIZE) continue;
+
+        uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+        if (uuid == GATT_PRIMARY_SERVICE_UUID || uuid == GATT_SECONDARY_SERVICE_UUID) {
+            const gattAttrType_t *pService = (const gattAttrType_t *)pAttr->pValue;
+            h = CacheAware_Fold(h, pService->uuid, pService->len);
+        } else if (uuid == GATT_CHARACTER_UUID) {
+            h = CacheAware_Fold(h, pAttr->pValue, 1);
+        } else if (uuid == REPORT_MAP_UUID) {
+            h = CacheAware_Fold(h, pAttr->pValue, hidReportMapLen);
+        }
+    }
+    return h;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 计算数据库摘要并加载主机记录 (所有 GATT 服务注册之后调用)
+ * @param taskId  发送 Service Changed 指示所用任务 (其 GATT 消息转给 CacheAware_OnIndConfirm)
+ */
+void CacheAware_Init(uint8_t taskId)
+{
+    cacheAwareTaskId = taskId;
+
+    db_digest = CacheAware_Digest();
+    EEPROM_READ(CACHE_AWARE_ADDR, rec_tbl, sizeof(rec_tbl));
+
+    LOG_BLE("GATT db digest %08lx\n", db_digest);
+}
+
+/**
+ * @brief 连接建立：记录主机地址，开始计时
+ */
+void CacheAware_OnConnected(uint16_t connHandle, const uint8_t *addr, uint16_t connInterval)
+{
+    conn_handle = connHandle;
+    tmos_memcpy(peer_addr, addr, B_ADDR_LEN);
+    is_ind_pending = FALSE;
+
+    is_rpt_pending = TRUE;
+    rpt_conn_int = connInterval;
+    conn_tick = TMOS_GetSystemClock();
+    sec_tick = conn_tick;
+}
+
+/**
+ * @brief 配对完成 / 已绑定主机加密完成 (hiddev 回调)
+ */
+void CacheAware_OnPairState(uint16_t connHandle, uint8_t state, uint8_t status)
+{
+    int8_t idx;
+
+    if (connHandle != conn_handle || status != SUCCESS) return;
+
+    if (state == GAPBOND_PAIRING_STATE_COMPLETE) {
+        // 新绑定：主机随后按完整服务发现建立缓存
+        sec_tick = TMOS_GetSystemClock();
+        rpt_class = FIRST_RPT_NEW_BOND;
+        CacheAware_MarkSynced();
+    } else if (state == GAPBOND_PAIRING_STATE_BONDED) {
+        sec_tick = TMOS_GetSystemClock();
+
+        idx = CacheAware_Find(peer_addr);
+        if (idx >= 0 && rec_tbl[idx].digest == db_digest) {
+            rpt_class = FIRST_RPT_CACHED;
+            return;
+        }
+
+        // 主机缓存可能已失效：通知整个句柄范围变化
+        rpt_class = FIRST_RPT_CHANGED;
+        if (GATTServApp_SendServiceChangedInd(connHandle, cacheAwareTaskId) == SUCCESS) {
+            is_ind_pending = TRUE;
+            LOG_BLE("GATT db changed, Service Changed sent\n");
+        } else {
+            // 主机未订阅 Service Changed：无从通知，其缓存可能仍是旧的，不记为已同步
+            LOG_BLE("GATT db changed, host not subscribed to Service Changed\n");
+        }
+    }
+}
+
+/**
+ * @brief 主机确认 Service Changed 指示 (ATT_HANDLE_VALUE_CFM)
+ */
+void CacheAware_OnIndConfirm(uint16_t connHandle)
+{
+    if (connHandle != conn_handle || !is_ind_pending) return;
+    is_ind_pending = FALSE;
+    CacheAware_MarkSynced();
+}
+
+/**
+ * @brief 报文被协议栈接受：结算本次连接的首个报文耗时
+ */
+void CacheAware_OnReport(void)
+{
+    uint32_t       now, sec_ms, rpt_ms;
+    FirstRptStat_t *st;
+
+    if (!is_rpt_pending) return;
+    is_rpt_pending = FALSE;
+
+    now = TMOS_GetSystemClock();
+    sec_ms = (sec_tick - conn_tick) * 5 / 8;
+    rpt_ms = (now - conn_tick) * 5 / 8;
+    st = &stat_tbl[rpt_class];
+    st->count++;
+    st->sec_ms += sec_ms;
+    st->rpt_ms += rpt_ms;
+
+    LOG_BLE("First report (%s): secured +%lu ms, report +%lu ms (~%lu conn events); avg %lu / %lu ms over %d\n",
+            first_rpt_name[rpt_class], sec_ms, rpt_ms,
+            rpt_conn_int ? rpt_ms * 4 / (rpt_conn_int * 5) : 0,
+            st->sec_ms / st->count, st->rpt_ms / st->count, st->count);
+}
+
+/**
+ * @brief 连接断开：未确认的 Service Changed 下次回连重发
+ */
+void CacheAware_OnDisconnected(void)
+{
+    conn_handle = GAP_CONNHANDLE_INIT;
+    is_ind_pending = FALSE;
+    is_rpt_pending = FALSE;
+}
@@ -0,0 +1,74 @@
+/*********************************************************************
+ * File Name          : clk_scale.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 系统主频动态调节
+ *                      - 主频层级由 HID_USB_POLL_EVT 在每次 USB 轮询前按活动状态选择，
+ *                        切换点位于 TMOS 任务上下文，不会打断进行中的 USB 事务
+ *                      - 收到按键立即升频 (HidEmu_ResetIdleTimer)，设备插入枚举前升频
+ *                        (mDelay 按 FREQ_SYS 编译期常数计时，低频下延时会成倍拉长)
+ *                      - PLL 不断电，升频只改 R16_CLK_SYS_CFG，首个按键不等待 PLL 锁定
+ *                      - 调试串口波特率随主频重新计算
+ *                      - 累计各层级驻留时间，降频时输出 (乘以实测各层级电流即得平均电流)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "clk_scale.h"
+#include "hidkbd.h"
+#include "evt_mon.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+
+// 各层级主频 (全部设为 CLK_SOURCE_PLL_60MHz 即关闭降频)
+static const SYS_CLKTypeDef clk_tier_src[CLK_TIER_NUM] = {
+    CLK_SOURCE_PLL_60MHz,   // FULL : USB Host 事务与报文处理
+    CLK_SOURCE_HSE_16MHz,   // IDLE : 50ms/100ms 轮询，蓝牙保持连接
+    CLK_SOURCE_HSE_8MHz,    // SLEEP: 500ms 轮询，蓝牙关闭
+};
+
+#define CLK_UART_BAUDRATE         115200  // 与 UART1_DefInit 一致
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static uint8_t  clk_tier = CLK_TIER_FULL;
+static uint32_t clk_tier_start = 0;                // 进入当前层级的时刻 (TMOS tick)
+static uint32_t clk_residency[CLK_TIER_NUM];       // 各层级累计驻留 (TMOS tick)
+
+/**
+ * @brief 切换主频层级 (同层级直接返回)
+ */
+void ClkScale_Set(uint8_t tier)
+{
+    uint32_t now, irq_status;
+
+    if (tier >= CLK_TIER_NUM || tier == clk_tier) return;
+
+    now = TMOS_GetSystemClock();
+    clk_residency[clk_tier] += now - clk_tier_start;
+    clk_tier_start = now;
+
+#ifdef DEBUG
+    // 等待调试串口发完，再按新主频重算波特率
+    while (!(R8_UART1_LSR & RB_LSR_TX_ALL_EMP));
+#endif
+
+    SYS_DisableAllIrq(&irq_status);
+    SetSysClock(clk_tier_src[tier]);
+    SYS_RecoverIrq(irq_status);
+    EvtMon_SetClock(GetSysClock());
+
+#ifdef DEBUG
+    UART1_BaudRateCfg(CLK_UART_BAUDRATE);
+#endif
+
+    if (tier > clk_tier) {
+        LOG_SYS("Clock -> %lu MHz (full %lus idle %lus sleep %lus)\n", GetSysClock() / 1000000,
+                clk_residency[CLK_TIER_FULL] / TICKS_PER_SEC,
+                clk_residency[CLK_TIER_IDLE] / TICKS_PER_SEC,
+                clk_residency[CLK_TIER_SLEEP] / TICKS_PER_SEC);
+    }
+    clk_tier = tier;
+}
@@ -0,0 +1,270 @@
+/*********************************************************************
+ * File Name          : conn_trace.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 连接事件时间线 (DEBUG_CONN_TRACE)
+ *                      - 链路层每个连接事件 / 广播事件结束时回调，取 RTC 32K 计数作时间戳
+ *                        (不受 clk_scale 调节主频影响，分辨率约 30.5us)
+ *                      - 同一时间轴记录 USB 输入到达 (桥接层交接点) 与通知提交 (HidDev_Report 成功)
+ *                      - 每个连接事件由未应答包数的变化推算带走的通知数 (按 LL 包计)，
+ *                        按提交顺序出队，得到提交到空中的延迟
+ *                      - 相邻事件间隔与标称间隔比较：超过 1.5 倍按整数倍计为缺失事件，
+ *                        其中不超过从机延迟允许的部分另计为主动跳过
+ *                      - ConnTrace_Dump() 通过 UART 输出统计与环形区时间线 (双击 USER 键触发)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "conn_trace.h"
+
+#ifdef DEBUG_CONN_TRACE
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define CT_RING_SIZE              128     // 时间线条目数 (每条 8 字节)
+#define CT_PENDING_MAX            16      // 等待上空的通知提交时刻 FIFO 深度
+#define CT_CARRY_BINS             4       // 每事件通知数直方图：0 / 1 / 2 / 3+
+
+// 条目类型
+#define CT_EVT_CONN               0       // 连接事件结束 (n = 带走的通知数)
+#define CT_EVT_ADV                1       // 广播事件结束
+#define CT_EVT_INPUT              2       // USB 输入进入桥接层
+#define CT_EVT_SUBMIT             3       // 通知提交给协议栈 (n = 报告 ID)
+
+// 32K 计数 -> us (1e6 / 32768 = 15625 / 512)
+#define CT_TICKS_TO_US(t)         ((uint32_t)(((uint64_t)(t) * 15625) >> 9))
+
+// ===================================================================
+// 时间线与统计
+// ===================================================================
+typedef struct {
+    uint32_t t;            // RTC 32K 计数
+    uint16_t lib_us;       // 库回调参数 timeUs (饱和到 16 位)
+    uint8_t  type;         // CT_EVT_*
+    uint8_t  n;
+} CtEntry_t;
+
+typedef struct {
+    uint32_t conn_evts;    // 连接事件数
+    uint32_t adv_evts;     // 广播事件数
+    uint32_t itv_sum_us;   // 相邻连接事件间隔累计 (只计未缺失的间隔)
+    uint32_t itv_count;
+    uint32_t itv_min_us;
+    uint32_t itv_max_us;
+    uint32_t missed;       // 超出从机延迟允许的缺失事件
+    uint32_t skipped;      // 从机延迟允许范围内未出现的事件
+    uint32_t carried[CT_CARRY_BINS];
+    uint32_t delay_sum_us; // 提交到空中延迟
+    uint32_t delay_count;
+    uint32_t delay_max_us;
+    uint32_t pending_drop; // 提交 FIFO 满丢弃的时刻
+} CtStat_t;
+
+static const char *const ct_type_names[] = { "conn", "adv", "input", "submit" };
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static CtEntry_t ct_ring[CT_RING_SIZE];
+static uint8_t   ct_head  = 0;             // 下一个写入位置
+static uint8_t   ct_count = 0;
+
+static uint32_t  ct_pending[CT_PENDING_MAX];
+static uint8_t   ct_pend_head  = 0;
+static uint8_t   ct_pend_count = 0;
+
+static uint16_t  ct_conn_handle = GAP_CONNHANDLE_INIT;
+static uint32_t  ct_nominal_us  = 0;       // 标称连接间隔
+static uint16_t  ct_latency     = 0;       // 从机延迟
+static uint32_t  ct_last_conn   = 0;       // 上一个连接事件时刻
+static uint8_t   ct_last_valid  = FALSE;
+
+static CtStat_t  ct_stat;
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+/**
+ * @brief 追加一条时间线 (链路层回调与主循环都会调用，关中断保护)
+ */
+static void ConnTrace_Push(uint32_t t, uint8_t type, uint8_t n, uint32_t lib_us)
+{
+    uint32_t   irq_status;
+    CtEntry_t *e;
+
+    SYS_DisableAllIrq(&irq_status);
+    e = &ct_ring[ct_head];
+    e->t      = t;
+    e->lib_us = (lib_us > 0xFFFF) ? 0xFFFF : (uint16_t)lib_us;
+    e->type   = type;
+    e->n      = n;
+    ct_head = (ct_head + 1) % CT_RING_SIZE;
+    if (ct_count < CT_RING_SIZE) ct_count++;
+    SYS_RecoverIrq(irq_status);
+}
+
+/**
+ * @brief 连接事件结束回调：实际间隔、缺失事件、带走的通知与上空延迟
+ */
+static void ConnTrace_ConnEvtCB(uint32_t timeUs)
+{
+    uint32_t now = RTC_GetCycle32k();
+    uint32_t unack, carried = 0, gap_us, slots, delay;
+
+    if (ct_conn_handle == GAP_CONNHANDLE_INIT) return;
+
+    // 已提交未确认的通知 - 控制器中仍未应答的包 = 本事件确认的通知
+    unack = LL_GetNumberOfUnAckPacket(ct_conn_handle);
+    if (unack == 0xFFFFFFFF) unack = 0;
+    if (ct_pend_count > unack) carried = ct_pend_count - unack;
+
+    ct_stat.conn_evts++;
+    ct_stat.carried[(carried < CT_CARRY_BINS) ? carried : CT_CARRY_BINS - 1]++;
+
+    for (uint32_t i = 0; i < carried; i++) {
+        delay = CT_TICKS_TO_US(now - ct_pending[ct_pend_head]);
+        ct_pend_head = (ct_pend_head + 1) % CT_PENDING_MAX;
+        ct_pend_count--;
+        ct_stat.delay_sum_us += delay;
+        ct_stat.delay_count++;
+        if (delay > ct_stat.delay_max_us) ct_stat.delay_max_us = delay;
+    }
+
+    if (ct_last_valid && ct_nominal_us) {
+        gap_us = CT_TICKS_TO_US(now - ct_last_conn);
+        slots  = (gap_us + ct_nominal_us / 2) / ct_nominal_us;
+        if (slots <= 1 || gap_us * 2 < ct_nominal_us * 3) {
+            ct_stat.itv_sum_us += gap_us;
+            ct_stat.itv_count++;
+            if (ct_stat.itv_min_us == 0 || gap_us < ct_stat.itv_min_us) ct_stat.itv_min_us = gap_us;
+            if (gap_us > ct_stat.itv_max_us) ct_stat.itv_max_us = gap_us;
+        } else if (slots - 1 <= ct_latency) {
+            ct_stat.skipped += slots - 1;
+        } else {
+            ct_stat.skipped += ct_latency;
+            ct_stat.missed  += slots - 1 - ct_latency;
+        }
+    }
+    ct_last_conn  = now;
+    ct_last_valid = TRUE;
+
+    ConnTrace_Push(now, CT_EVT_CONN, (uint8_t)carried, timeUs);
+}
+
+/**
+ * @brief 广播事件结束回调
+ */
+static void ConnTrace_AdvEvtCB(uint32_t timeUs)
+{
+    ct_stat.adv_evts++;
+    ConnTrace_Push(RTC_GetCycle32k(), CT_EVT_ADV, 0, timeUs);
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+void ConnTrace_Init(void)
+{
+    LL_ConnectEventRegister(ConnTrace_ConnEvtCB);
+    LL_AdvertiseEventRegister(ConnTrace_AdvEvtCB);
+}
+
+/**
+ * @brief 连接参数生效 / 断开 (interval 为 0)
+ */
+void ConnTrace_SetConn(uint16_t connHandle, uint16_t interval, uint16_t latency)
+{
+    uint32_t irq_status;
+
+    SYS_DisableAllIrq(&irq_status);
+    if (interval == 0) {
+        ct_conn_handle = GAP_CONNHANDLE_INIT;
+        ct_pend_count  = 0;
+        ct_last_valid  = FALSE;
+    } else {
+        if (ct_conn_handle != connHandle) ct_last_valid = FALSE;
+        ct_conn_handle = connHandle;
+    }
+    ct_nominal_us = (uint32_t)interval * 1250;
+    ct_latency    = latency;
+    SYS_RecoverIrq(irq_status);
+}
+
+/**
+ * @brief USB 输入进入桥接层
+ */
+void ConnTrace_Input(void)
+{
+    ConnTrace_Push(RTC_GetCycle32k(), CT_EVT_INPUT, 0, 0);
+}
+
+/**
+ * @brief 通知已被协议栈接受：记录提交时刻，等连接事件确认后出队
+ */
+void ConnTrace_Submit(uint8_t rpt_id)
+{
+    uint32_t irq_status;
+    uint32_t now = RTC_GetCycle32k();
+
+    SYS_DisableAllIrq(&irq_status);
+    if (ct_pend_count < CT_PENDING_MAX) {
+        ct_pending[(ct_pend_head + ct_pend_count) % CT_PENDING_MAX] = now;
+        ct_pend_count++;
+    } else {
+        ct_stat.pending_drop++;
+    }
+    SYS_RecoverIrq(irq_status);
+
+    ConnTrace_Push(now, CT_EVT_SUBMIT, rpt_id, 0);
+}
+
+/**
+ * @brief 输出统计与时间线 (us，相对最旧一条)，随后清零统计
+ */
+void ConnTrace_Dump(void)
+{
+    CtStat_t  st;
+    uint32_t  irq_status;
+#ifdef DEBUG
+    CtEntry_t e;
+    uint32_t  t0 = 0;
+    uint8_t   head, count;
+#endif
+
+    SYS_DisableAllIrq(&irq_status);
+    st = ct_stat;
+    memset(&ct_stat, 0, sizeof(ct_stat));
+#ifdef DEBUG
+    head  = ct_head;
+    count = ct_count;
+#endif
+    SYS_RecoverIrq(irq_status);
+
+    PRINT("\n==== Conn trace: nominal %lu us, latency %d ====\n", ct_nominal_us, ct_latency);
+    PRINT("conn evts %lu, adv evts %lu\n", st.conn_evts, st.adv_evts);
+    if (st.itv_count) {
+        PRINT("interval avg %lu min %lu max %lu us\n",
+              st.itv_sum_us / st.itv_count, st.itv_min_us, st.itv_max_us);
+    }
+    PRINT("missed %lu, skipped (latency) %lu\n", st.missed, st.skipped);
+    PRINT("notis per evt: 0:%lu 1:%lu 2:%lu 3+:%lu\n",
+          st.carried[0], st.carried[1], st.carried[2], st.carried[3]);
+    if (st.delay_count) {
+        PRINT("submit->air avg %lu max %lu us (%lu notis, %lu untracked)\n",
+              st.delay_sum_us / st.delay_count, st.delay_max_us, st.delay_count, st.pending_drop);
+    }
+
+#ifdef DEBUG
+    // 时间线：<us> <类型> <n> <库 timeUs>
+    for (uint8_t i = 0; i < count; i++) {
+        SYS_DisableAllIrq(&irq_status);
+        e = ct_ring[(head + CT_RING_SIZE - count + i) % CT_RING_SIZE];
+        SYS_RecoverIrq(irq_status);
+        if (i == 0) t0 = e.t;
+        PRINT("CT %lu %s %d %d\n", CT_TICKS_TO_US(e.t - t0), ct_type_names[e.type], e.n, e.lib_us);
+    }
+#endif
+}
+
+#endif /* DEBUG_CONN_TRACE */
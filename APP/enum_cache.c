@@ -0,0 +1,231 @@
+/*********************************************************************
+ * File Name          : enum_cache.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 枚举结果缓存 (data flash)
+ *                      - 完整枚举成功后记录根端口键盘/鼠标的配置解析结果：
+ *                        速度、EP0 包长、配置值、HID 接口号、设备类型、中断 IN 端点
+ *                      - 重新插入：短复位 -> 读设备描述符确认 VID/PID/bcdDevice
+ *                        -> 命中则只发 SET_ADDRESS / SET_CONFIGURATION / SET_IDLE
+ *                        跳过配置描述符与报告描述符读取、100ms 端口稳定等待
+ *                      - 未命中或任一步失败返回错误，由调用方回退完整枚举
+ *                      - 最近使用的设备排在最前，表满时淘汰最久未用的一项
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "enum_cache.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+
+// 缓存存放在 data flash 中 SNV 前一页 (EEPROM_* 使用 data flash 内偏移地址)
+#define ENUM_CACHE_ADDR           (BLE_SNV_ADDR - EEPROM_PAGE_SIZE)
+#define ENUM_CACHE_SLOTS          4       // 缓存设备数
+#define ENUM_CACHE_MAGIC          0xEC01  // 记录有效标志 (结构变化时修改)
+
+#define ENUM_RESET_STABLE_MS      10      // 复位后端口稳定等待 (完整枚举为 100ms)
+#define ENUM_HID_SET_IDLE         0x0A    // HID 类请求 SET_IDLE
+
+// ===================================================================
+// 缓存记录
+// ===================================================================
+typedef struct {
+    uint16_t magic;
+    uint16_t vid;
+    uint16_t pid;
+    uint16_t bcd;          // bcdDevice：固件版本变化视为不同设备
+    uint8_t  speed;        // 0 = 低速, 1 = 全速
+    uint8_t  ep0_size;     // 端点 0 最大包长
+    uint8_t  cfg_value;    // bConfigurationValue
+    uint8_t  hid_iface;    // 第一个 HID 接口号
+    uint8_t  dev_type;     // DEV_TYPE_KEYBOARD / DEV_TYPE_MOUSE
+    uint8_t  endp[4];      // 中断 IN 端点号 (不含同步位)
+    uint8_t  reserved;
+} EnumCacheRec_t;
+
+static EnumCacheRec_t cache_tbl[ENUM_CACHE_SLOTS];
+
+// HID SET_IDLE (wIndex 在发送前填入接口号)
+__attribute__((aligned(4))) static const uint8_t SetupSetHidIdle[] = {
+    USB_REQ_TYP_OUT | USB_REQ_TYP_CLASS | USB_REQ_RECIP_INTERF, ENUM_HID_SET_IDLE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// ===================================================================
+// Flash 读写
+// ===================================================================
+
+static void EnumCache_Store(void)
+{
+    EEPROM_ERASE(ENUM_CACHE_ADDR, EEPROM_PAGE_SIZE);
+    EEPROM_WRITE(ENUM_CACHE_ADDR, cache_tbl, sizeof(cache_tbl));
+}
+
+void EnumCache_Init(void)
+{
+    EEPROM_READ(ENUM_CACHE_ADDR, cache_tbl, sizeof(cache_tbl));
+}
+
+/**
+ * @brief 是否至少缓存过一个设备 (用于缩短插入后的电源稳定等待)
+ */
+uint8_t EnumCache_HasEntry(void)
+{
+    return (cache_tbl[0].magic == ENUM_CACHE_MAGIC);
+}
+
+static EnumCacheRec_t *EnumCache_Find(uint16_t vid, uint16_t pid, uint16_t bcd)
+{
+    for (uint8_t i = 0; i < ENUM_CACHE_SLOTS; i++) {
+        if (cache_tbl[i].magic == ENUM_CACHE_MAGIC &&
+            cache_tbl[i].vid == vid && cache_tbl[i].pid == pid && cache_tbl[i].bcd == bcd) {
+            return &cache_tbl[i];
+        }
+    }
+    return NULL;
+}
+
+// ===================================================================
+// 快速枚举
+// ===================================================================
+
+/**
+ * @brief 按缓存快速初始化根端口设备
+ * @return ERR_SUCCESS 命中并已配置完成；其他值需回退 InitRootU2Device()
+ */
+uint8_t EnumCache_FastInit(void)
+{
+    EnumCacheRec_t *rec;
+    PUSB_DEV_DESCR  dev;
+    uint8_t i, s, stable;
+
+    if (!EnumCache_HasEntry()) return ERR_USB_UNSUPPORT;
+
+    // 1. 总线复位，端口连续稳定 ENUM_RESET_STABLE_MS 即开始通讯
+    ResetRootU2HubPort();
+    for (i = 0, stable = 0; i < 100; i++) {
+        mDelaymS(1);
+        if (EnableRootU2HubPort() == ERR_SUCCESS) {
+            if (++stable >= ENUM_RESET_STABLE_MS) break;
+        } else {
+            stable = 0;
+        }
+    }
+    if (stable < ENUM_RESET_STABLE_MS) return ERR_USB_DISCON;
+    SetUsb2Speed(ThisUsb2Dev.DeviceSpeed);
+
+    // 2. 读设备描述符确认身份 (不改变设备状态)
+    s = CtrlGetU2DeviceDescr();
+    if (s != ERR_SUCCESS) return s;
+    dev = (PUSB_DEV_DESCR)U2Com_Buffer;
+    rec = EnumCache_Find(dev->idVendor, dev->idProduct, dev->bcdDevice);
+    if (rec == NULL || rec->speed != ThisUsb2Dev.DeviceSpeed || rec->ep0_size != Usb2DevEndp0Size) {
+        SetUsb2Speed(1);
+        return ERR_USB_UNSUPPORT;
+    }
+
+    // 3. 只发送改变设备状态的请求
+    s = CtrlSetUsb2Address(((PUSB_SETUP_REQ)SetupSetUsb2Addr)->wValue);
+    if (s == ERR_SUCCESS) s = CtrlSetUsb2Config(rec->cfg_value);
+    if (s == ERR_SUCCESS) {
+        CopyU2SetupReqPkg(SetupSetHidIdle);
+        pU2SetupReq->wIndex = rec->hid_iface;
+        s = U2HostCtrlTransfer(NULL, NULL);
+        if (s == (USB_PID_STALL | ERR_USB_TRANSFER)) s = ERR_SUCCESS;  // SET_IDLE 为可选请求
+    }
+    if (s != ERR_SUCCESS) {
+        SetUsb2Speed(1);
+        return s;
+    }
+
+    // 4. 恢复库的设备记录，端点同步位从 DATA0 开始
+    ThisUsb2Dev.DeviceAddress = ((PUSB_SETUP_REQ)SetupSetUsb2Addr)->wValue;
+    ThisUsb2Dev.DeviceVID     = rec->vid;
+    ThisUsb2Dev.DevicePID     = rec->pid;
+    ThisUsb2Dev.DeviceType    = rec->dev_type;
+    memcpy(ThisUsb2Dev.GpVar, rec->endp, sizeof(ThisUsb2Dev.GpVar));
+    ThisUsb2Dev.DeviceStatus  = ROOT_DEV_SUCCESS;
+    SetUsb2Speed(1);
+
+    LOG_USB("Enum cache hit %04x:%04x\n", rec->vid, rec->pid);
+
+    // 5. 最近使用的设备移到表头
+    if (rec != &cache_tbl[0]) {
+        EnumCacheRec_t hit = *rec;
+        memmove(&cache_tbl[1], &cache_tbl[0], (uint8_t *)rec - (uint8_t *)&cache_tbl[0]);
+        cache_tbl[0] = hit;
+        EnumCache_Store();
+    }
+    return ERR_SUCCESS;
+}
+
+// ===================================================================
+// 记录
+// ===================================================================
+
+/**
+ * @brief 补读设备/配置描述符，解析出缓存记录
+ * @return TRUE 解析成功
+ */
+static uint8_t EnumCache_Parse(EnumCacheRec_t *rec)
+{
+    uint8_t *buf = U2Com_Buffer;
+    uint16_t i, total;
+
+    if (CtrlGetU2DeviceDescr() != ERR_SUCCESS) return FALSE;
+    rec->vid      = ((PUSB_DEV_DESCR)buf)->idVendor;
+    rec->pid      = ((PUSB_DEV_DESCR)buf)->idProduct;
+    rec->bcd      = ((PUSB_DEV_DESCR)buf)->bcdDevice;
+    rec->ep0_size = Usb2DevEndp0Size;
+
+    if (CtrlGetU2ConfigDescr() != ERR_SUCCESS) return FALSE;
+    total = ((PUSB_CFG_DESCR)buf)->wTotalLength;
+    rec->cfg_value = ((PUSB_CFG_DESCR)buf)->bConfigurationValue;
+
+    // 第一个 HID 接口
+    for (i = 0; i + 2 <= total && buf[i] >= 2; i += buf[i]) {
+        if (buf[i + 1] == USB_DESCR_TYP_INTERF &&
+            ((PUSB_ITF_DESCR)(buf + i))->bInterfaceClass == USB_DEV_CLASS_HID) {
+            rec->hid_iface = ((PUSB_ITF_DESCR)(buf + i))->bInterfaceNumber;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief 完整枚举成功后调用：补读描述符并写入缓存 (仅根端口键盘/鼠标)
+ */
+void EnumCache_Learn(void)
+{
+    EnumCacheRec_t rec;
+    EnumCacheRec_t *old;
+    uint8_t i, move, ok;
+
+    if (ThisUsb2Dev.DeviceType != DEV_TYPE_KEYBOARD && ThisUsb2Dev.DeviceType != DEV_TYPE_MOUSE) {
+        return;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    SelectU2HubPort(0);
+    ok = EnumCache_Parse(&rec);
+    SetUsb2Speed(1);
+    if (!ok) return;
+
+    rec.magic    = ENUM_CACHE_MAGIC;
+    rec.speed    = ThisUsb2Dev.DeviceSpeed;
+    rec.dev_type = ThisUsb2Dev.DeviceType;
+    for (i = 0; i < 4; i++) {
+        rec.endp[i] = ThisUsb2Dev.GpVar[i] & 0x7F;
+    }
+
+    // 记录未变化时不写 flash
+    if (memcmp(&cache_tbl[0], &rec, sizeof(rec)) == 0) return;
+
+    old  = EnumCache_Find(rec.vid, rec.pid, rec.bcd);
+    move = old ? (uint8_t)(old - cache_tbl) : (ENUM_CACHE_SLOTS - 1);
+    memmove(&cache_tbl[1], &cache_tbl[0], move * sizeof(EnumCacheRec_t));
+    cache_tbl[0] = rec;
+    EnumCache_Store();
+    LOG_USB("Enum cache saved %04x:%04x\n", rec.vid, rec.pid);
+}
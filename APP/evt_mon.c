@@ -0,0 +1,129 @@
+/*********************************************************************
+ * File Name          : evt_mon.c
+ * Author             : DIY User & AI Assistant
+ * Description        : TMOS 事件耗时监控 (DEBUG_EVT_MON)
+ *                      - 每个已注册任务的处理函数由 EVT_MON_DEFINE 包装计时
+ *                      - 按 (任务, 事件位) 记录次数、最长耗时、滑动平均耗时
+ *                      - 超过预算的次数单独计数，定位拖长连接事件间隙的处理
+ *                      - 记录时按当时主频换算为 us (主频由 ClkScale_Set 通知)，
+ *                        降频前后的样本可以直接比较
+ *                      - EvtMon_Dump() 通过 UART 输出统计表 (双击 USER 键触发)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "evt_mon.h"
+#include "HAL.h"
+#include "hidkbd.h"
+
+#ifdef DEBUG_EVT_MON
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define EVT_MON_BUDGET_US         1000    // 默认单次处理预算 (us)
+#define EVT_MON_MEAN_SHIFT        4       // 滑动平均系数 1/16
+
+// ===================================================================
+// 预算覆盖表 (未列出的事件使用默认预算)
+// ===================================================================
+typedef struct {
+    uint8_t    task;
+    tmosEvents event;
+    uint16_t   budget_us;
+} EvtBudget_t;
+
+static const EvtBudget_t budget_tbl[] = {
+    {EVT_MON_TASK_HAL,    HAL_REG_INIT_EVENT,  10000},   // 32K 校准，库要求小于 10ms
+    {EVT_MON_TASK_HIDEMU, HID_USB_POLL_EVT,    500},     // 轮询周期内必须留出协议栈时间
+    {EVT_MON_TASK_HIDEMU, START_BATT_READ_EVT, 2000},    // ADC 多次采样
+};
+#define BUDGET_NUM                (sizeof(budget_tbl) / sizeof(budget_tbl[0]))
+
+static const char *const task_names[EVT_MON_TASK_NUM] = {
+    "HAL", "HidDev", "HidEmu", "UserKey", "TxPwr", "RfOut",
+};
+
+// ===================================================================
+// 统计数据
+// ===================================================================
+typedef struct {
+    uint32_t max;       // 最长耗时 (us)
+    uint32_t mean;      // 滑动平均耗时 (us)
+    uint16_t count;     // 处理次数 (饱和)
+    uint16_t overrun;   // 超预算次数 (饱和)
+} EvtStat_t;
+
+static EvtStat_t evt_stat[EVT_MON_TASK_NUM][16];
+static uint32_t  cycles_per_us = FREQ_SYS / 1000000;  // 当前主频，仅由 EvtMon_SetClock 更新
+
+static uint32_t EvtMon_BudgetUs(uint8_t task, uint8_t bit)
+{
+    for (uint8_t i = 0; i < BUDGET_NUM; i++) {
+        if (budget_tbl[i].task == task && budget_tbl[i].event == (1U << bit)) {
+            return budget_tbl[i].budget_us;
+        }
+    }
+    return EVT_MON_BUDGET_US;
+}
+
+/**
+ * @brief 主频切换后调用 (ClkScale_Set)，之后的样本按新主频换算
+ */
+void EvtMon_SetClock(uint32_t sys_clk)
+{
+    cycles_per_us = sys_clk / 1000000;
+}
+
+/**
+ * @brief 记录一次处理 (由 EVT_MON_DEFINE 生成的包装调用)
+ * @param done   本次处理掉的事件位，多位同时处理时记到最低位
+ * @param cycles 处理耗时 (HCLK 周期)
+ * @note  处理中途切换了主频的样本按切换后的主频换算，有偏差
+ */
+void EvtMon_Record(uint8_t task, tmosEvents done, uint32_t cycles)
+{
+    EvtStat_t *st;
+    uint8_t    bit;
+    uint32_t   us;
+
+    if (done == 0 || task >= EVT_MON_TASK_NUM) return;
+
+    us  = cycles / cycles_per_us;
+    bit = __builtin_ctz(done);
+    st  = &evt_stat[task][bit];
+
+    if (st->count == 0) {
+        st->mean = us;
+    } else {
+        st->mean += (int32_t)(us - st->mean) >> EVT_MON_MEAN_SHIFT;
+    }
+    if (us > st->max) st->max = us;
+    if (st->count < 0xFFFF) st->count++;
+    if (us > EvtMon_BudgetUs(task, bit) && st->overrun < 0xFFFF) {
+        st->overrun++;
+    }
+}
+
+/**
+ * @brief 输出统计表 (耗时单位 us)，输出后最大值与超限计数清零
+ */
+void EvtMon_Dump(void)
+{
+    uint8_t t, b;
+
+    PRINT("task     evt     count  mean   max    budget over\n");
+    for (t = 0; t < EVT_MON_TASK_NUM; t++) {
+        for (b = 0; b < 16; b++) {
+            EvtStat_t *st = &evt_stat[t][b];
+            if (st->count == 0) continue;
+            PRINT("%-8s 0x%04x  %-6u %-6lu %-6lu %-6lu %u%s\n",
+                  task_names[t], 1U << b, st->count,
+                  st->mean, st->max,
+                  EvtMon_BudgetUs(t, b), st->overrun, st->overrun ? " !" : "");
+            st->max     = 0;
+            st->overrun = 0;
+        }
+    }
+}
+
+#endif /* DEBUG_EVT_MON */
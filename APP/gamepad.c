@@ -0,0 +1,272 @@
+/*********************************************************************
+ * File Name          : gamepad.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 游戏手柄 / 摇杆解码
+ *                      - 官方库只认 Boot 键盘/鼠标，接口协议为 0 的 HID 设备配置完后返回
+ *                        ERR_USB_UNSUPPORT；此时补读报告描述符，顶层集合为手柄/摇杆且含
+ *                        X/Y/苜蓿键/按键之一时接管，设备类型记为 DEV_TYPE_GAMEPAD
+ *                      - 按描述符记录 X/Y/Z/Rx/Ry/Rz、苜蓿键与按键 1~16 的位置和逻辑范围，
+ *                        轴的缩放系数预先算成 Q16，解码时只做乘法和移位
+ *                      - 轴先去死区再把剩余行程拉伸回满量程；与已发送值相差不到阈值的轴变化不上报，
+ *                        模拟量噪声不会占满通知
+ *                      - 轮询周期跟随端点 bInterval，但不慢于 GAMEPAD_POLL_MIN_HZ
+ *                      - 只支持一个手柄；XInput 等厂商自定义类手柄不是 HID，不在此列
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "hidkbdservice.h"
+#include "hid_desc.h"
+#include "gamepad.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define GAMEPAD_DEADZONE          8       // 轴死区 (输出 -127~127 刻度)，摇杆回中时的漂移落在其内
+#define GAMEPAD_AXIS_THRESHOLD    3       // 轴变化阈值：与已发送值相差小于此值不上报
+#define GAMEPAD_POLL_MIN_HZ       250     // 轮询频率下限 (端点 bInterval 更长时按此轮询)
+
+// ===================================================================
+// 字段
+// ===================================================================
+#define GP_AXIS_MAX               127
+#define GP_AXIS_SPAN              (GP_AXIS_MAX * 2)
+// 死区外行程拉伸回满量程的 Q16 系数 (向上取整，推到头恰好是 127)
+#define GP_DEADZONE_SCALE         ((((uint32_t)GP_AXIS_MAX << 16) + GP_AXIS_MAX - GAMEPAD_DEADZONE - 1) / \
+                                   (GP_AXIS_MAX - GAMEPAD_DEADZONE))
+
+enum {
+    GP_F_X,
+    GP_F_Y,
+    GP_F_Z,
+    GP_F_RX,
+    GP_F_RY,
+    GP_F_RZ,
+    GP_F_HAT,
+    GP_F_BUTTON,
+    GP_F_NUM
+};
+
+static const uint32_t gp_usage_tbl[GP_F_NUM] = {
+    HID_USAGE(0x01, 0x30),  // X
+    HID_USAGE(0x01, 0x31),  // Y
+    HID_USAGE(0x01, 0x32),  // Z
+    HID_USAGE(0x01, 0x33),  // Rx
+    HID_USAGE(0x01, 0x34),  // Ry
+    HID_USAGE(0x01, 0x35),  // Rz
+    HID_USAGE(0x01, 0x39),  // Hat Switch
+    HID_USAGE(0x09, 0x01),  // Button 1 (连续的按键 2~N 并入同一组)
+};
+
+// 可接管的顶层应用集合
+static const uint32_t gp_app_tbl[] = {
+    HID_USAGE(0x01, 0x05),  // Game Pad
+    HID_USAGE(0x01, 0x04),  // Joystick
+    HID_USAGE(0x01, 0x08),  // Multi-axis Controller
+};
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static HidField_t gp_field[GP_F_NUM];
+static uint32_t   gp_scale[HID_GAMEPAD_AXES];  // 各轴的 Q16 缩放系数
+static uint8_t    gp_rpt_id     = 0;           // 报告 ID (0 = 设备不使用报告 ID)
+static uint8_t    gp_hat_shift  = 0;           // 4 向苜蓿键 (0~3) 左移 1 位对齐到 8 向
+static uint16_t   gp_poll_ticks = 0;           // 轮询周期 (tick)
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+/**
+ * @brief 预计算缩放系数，检查字段
+ * @return TRUE 至少有一个轴、苜蓿键或按键
+ */
+static uint8_t Gamepad_Setup(void)
+{
+    HidField_t *hat = &gp_field[GP_F_HAT];
+    uint8_t     f, found = FALSE;
+
+    for (f = GP_F_X; f <= GP_F_RZ; f++) {
+        gp_scale[f] = HidDesc_ScaleQ16(&gp_field[f], GP_AXIS_SPAN);
+        if (gp_scale[f] == 0 || (gp_field[f].flags & HID_INPUT_RELATIVE)) {
+            gp_field[f].size = 0;
+        }
+        if (gp_field[f].size) found = TRUE;
+    }
+
+    // 苜蓿键：8 向 (逻辑范围 0~7) 或 4 向 (0~3)，范围外为松开
+    if (hat->size) {
+        if (hat->lmax - hat->lmin == 7)      gp_hat_shift = 0;
+        else if (hat->lmax - hat->lmin == 3) gp_hat_shift = 1;
+        else                                 hat->size = 0;
+    }
+    if (hat->size) found = TRUE;
+
+    if (gp_field[GP_F_BUTTON].size) {
+        if (gp_field[GP_F_BUTTON].count > HID_GAMEPAD_BUTTONS) {
+            gp_field[GP_F_BUTTON].count = HID_GAMEPAD_BUTTONS;
+        }
+        found = TRUE;
+    }
+    return found;
+}
+
+/**
+ * @brief 读一个轴：缩放到 -127~127，去死区后拉伸回满量程
+ */
+static int8_t Gamepad_Axis(uint8_t f, const uint8_t *buf, uint8_t len)
+{
+    int16_t  v;
+    uint32_t mag;
+
+    if (gp_field[f].size == 0) return 0;
+    v = (int16_t)HidDesc_Scale(&gp_field[f], gp_scale[f],
+                               HidDesc_GetValue(&gp_field[f], 0, buf, len), GP_AXIS_SPAN) - GP_AXIS_MAX;
+
+    mag = (v < 0) ? -v : v;
+    if (mag <= GAMEPAD_DEADZONE) return 0;
+    mag = ((mag - GAMEPAD_DEADZONE) * GP_DEADZONE_SCALE) >> 16;
+    if (mag > GP_AXIS_MAX) mag = GP_AXIS_MAX;
+    return (v < 0) ? -(int8_t)mag : (int8_t)mag;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 接管官方库不支持的 HID 设备 (InitRootU2Device / InitU2DevOnHub 返回 ERR_USB_UNSUPPORT 后调用)
+ * @param hub_port  0 = 根端口，N = HUB 端口 N (调用前已 SelectU2HubPort，设备已 SET_CONFIGURATION)
+ * @return ERR_SUCCESS 已接管为手柄；否则返回 ERR_USB_UNSUPPORT，设备状态不变
+ */
+uint8_t Gamepad_Claim(uint8_t hub_port)
+{
+    static const uint32_t find_tbl[] = {
+        HID_USAGE(0x01, 0x30), HID_USAGE(0x01, 0x39), HID_USAGE(0x09, 0x01)
+    };
+    HidIfInfo_t info;
+    uint8_t    *desc;
+    uint8_t     len, a, u, ok = FALSE;
+    int16_t     id = -1;
+
+    if (HidDesc_ReadConfig(&info) != ERR_SUCCESS || info.protocol != 0) return ERR_USB_UNSUPPORT;
+    desc = HidDesc_ReadReport(&info, &len);
+    if (desc == NULL) return ERR_USB_UNSUPPORT;
+
+    // 手柄/摇杆集合中含 X、苜蓿键或按键 1 的第一个输入报告
+    for (a = 0; a < sizeof(gp_app_tbl) / sizeof(gp_app_tbl[0]) && id < 0; a++) {
+        for (u = 0; u < sizeof(find_tbl) / sizeof(find_tbl[0]) && id < 0; u++) {
+            id = HidDesc_FindAbsInput(desc, len, gp_app_tbl[a], find_tbl[u]);
+        }
+    }
+    if (id >= 0) {
+        gp_rpt_id = (uint8_t)id;
+        HidDesc_MapInput(desc, len, gp_rpt_id, gp_usage_tbl, GP_F_NUM, gp_field);
+        ok = Gamepad_Setup();
+    }
+    tmos_msg_deallocate(desc);
+
+    if (!ok) return ERR_USB_UNSUPPORT;
+
+    // 轮询周期：端点间隔与频率下限取较短者
+    gp_poll_ticks = MS1_TO_SYSTEM_TIME(info.interval ? info.interval : 1);
+    if (gp_poll_ticks > MS1_TO_SYSTEM_TIME(1000 / GAMEPAD_POLL_MIN_HZ)) {
+        gp_poll_ticks = MS1_TO_SYSTEM_TIME(1000 / GAMEPAD_POLL_MIN_HZ);
+    }
+    if (gp_poll_ticks == 0) gp_poll_ticks = 1;
+
+    if (hub_port) {
+        DevOnU2HubPort[hub_port - 1].DeviceStatus = ROOT_DEV_SUCCESS;
+        DevOnU2HubPort[hub_port - 1].DeviceType   = DEV_TYPE_GAMEPAD;
+    } else {
+        ThisUsb2Dev.DeviceStatus = ROOT_DEV_SUCCESS;
+        ThisUsb2Dev.DeviceType   = DEV_TYPE_GAMEPAD;
+    }
+
+    LOG_USB("Gamepad: port %d id %d, %d buttons, hat %d bit, X %d bit [%ld..%ld], poll %d ms\n",
+            hub_port, gp_rpt_id, gp_field[GP_F_BUTTON].count, gp_field[GP_F_HAT].size,
+            gp_field[GP_F_X].size, gp_field[GP_F_X].lmin, gp_field[GP_F_X].lmax, info.interval);
+    return ERR_SUCCESS;
+}
+
+/**
+ * @brief 手柄轮询周期 (tick)，未接管过手柄时返回 0
+ */
+uint16_t Gamepad_GetPollTicks(void)
+{
+    return gp_poll_ticks;
+}
+
+/**
+ * @brief 解码一帧中断 IN 数据
+ * @param report  输出 HID_GAMEPAD_IN_RPT_LEN 字节手柄报文 [按键 16 bit, 苜蓿键, X, Y, Z, Rx, Ry, Rz]
+ * @return TRUE 是手柄报文；其他报告 ID (如力反馈状态) 返回 FALSE
+ */
+uint8_t Gamepad_Decode(const uint8_t *buf, uint8_t len, uint8_t *report)
+{
+    HidField_t *btn = &gp_field[GP_F_BUTTON];
+    HidField_t *hat = &gp_field[GP_F_HAT];
+    uint16_t    buttons = 0;
+    int32_t     v;
+    uint8_t     i;
+
+    if (gp_rpt_id) {
+        if (len == 0 || buf[0] != gp_rpt_id) return FALSE;
+        buf++;
+        len--;
+    }
+
+    for (i = 0; i < btn->count; i++) {
+        if (HidDesc_GetValue(btn, i, buf, len)) buttons |= 1 << i;
+    }
+    report[0] = LO_UINT16(buttons);
+    report[1] = HI_UINT16(buttons);
+
+    report[2] = HID_GAMEPAD_HAT_NULL;
+    if (hat->size) {
+        v = HidDesc_GetValue(hat, 0, buf, len);
+        if (v >= hat->lmin && v <= hat->lmax) {
+            report[2] = (uint8_t)((v - hat->lmin) << gp_hat_shift);
+        }
+    }
+
+    for (i = 0; i < HID_GAMEPAD_AXES; i++) {
+        report[3 + i] = (uint8_t)Gamepad_Axis(GP_F_X + i, buf, len);
+    }
+    return TRUE;
+}
+
+/**
+ * @brief 比较新报文与已发送的报文，决定是否上报
+ * @return GAMEPAD_CHG_BUTTON / GAMEPAD_CHG_AXIS / GAMEPAD_CHG_NONE
+ * @note   轴回到中位或推到头时即使变化小于阈值也上报，保证停留值准确
+ */
+uint8_t Gamepad_Compare(const uint8_t *sent, const uint8_t *now)
+{
+    int16_t d;
+    int8_t  v;
+    uint8_t i, chg = GAMEPAD_CHG_NONE;
+
+    if (memcmp(sent, now, 3) != 0) return GAMEPAD_CHG_BUTTON;
+
+    for (i = 3; i < HID_GAMEPAD_IN_RPT_LEN; i++) {
+        if (sent[i] == now[i]) continue;
+        v = (int8_t)now[i];
+        d = v - (int8_t)sent[i];
+        if (d >= GAMEPAD_AXIS_THRESHOLD || d <= -GAMEPAD_AXIS_THRESHOLD ||
+            v == 0 || v == GP_AXIS_MAX || v == -GP_AXIS_MAX) {
+            chg = GAMEPAD_CHG_AXIS;
+        }
+    }
+    return chg;
+}
+
+/**
+ * @brief 生成松开全部按键、摇杆回中的报文 (手柄拔出或切换输出时释放)
+ */
+void Gamepad_Neutral(uint8_t *report)
+{
+    memset(report, 0, HID_GAMEPAD_IN_RPT_LEN);
+    report[2] = HID_GAMEPAD_HAT_NULL;
+}
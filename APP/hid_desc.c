@@ -0,0 +1,344 @@
+/*********************************************************************
+ * File Name          : hid_desc.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USB HID 报告描述符读取与解析
+ *                      - 补读配置描述符，取第一个 HID 接口的接口号、报告描述符长度与端点间隔
+ *                      - 读取完整报告描述符 (上限 255 字节)，缓冲从协议栈堆临时申请，用完即释放
+ *                      - 只解析输入条目：按用法表记录字段的位偏移、位宽与逻辑范围，
+ *                        各报告 ID 独立累计位偏移，描述符被截断时已解析的部分仍然有效
+ *                      - 字段取值与定点缩放 (缩放系数在识别设备时预先算好)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "hid_desc.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define HID_DESC_MAX              255     // 报告描述符读取上限 (控制传输长度为 8 位)，超出部分不解析
+#define HID_LOCAL_USAGES          8       // 单个主条目前最多记录的用法数
+#define HID_REPORT_IDS            8       // 最多跟踪的报告 ID 数
+#define HID_CFG_BUF_LEN           128     // U2Com_Buffer 长度 (库中定义，头文件未给出大小)
+
+// ===================================================================
+// 报告描述符条目 (HID 1.11 6.2.2)
+// ===================================================================
+#define HID_ITEM_LONG             0xFE
+#define HID_ITEM_TYPE_MAIN        0
+#define HID_ITEM_TYPE_GLOBAL      1
+#define HID_ITEM_TYPE_LOCAL       2
+
+#define HID_MAIN_INPUT            0x8
+#define HID_MAIN_COLLECTION       0xA
+#define HID_MAIN_END_COLLECTION   0xC
+#define HID_GLOBAL_USAGE_PAGE     0x0
+#define HID_GLOBAL_LOGICAL_MIN    0x1
+#define HID_GLOBAL_LOGICAL_MAX    0x2
+#define HID_GLOBAL_REPORT_SIZE    0x7
+#define HID_GLOBAL_REPORT_ID      0x8
+#define HID_GLOBAL_REPORT_COUNT   0x9
+#define HID_LOCAL_USAGE           0x0
+#define HID_LOCAL_USAGE_MIN       0x1
+#define HID_LOCAL_USAGE_MAX       0x2
+
+#define HID_COLLECTION_APP        0x01
+
+// HID GET_DESCRIPTOR (Report)，wIndex/wLength 在发送前填入
+__attribute__((aligned(4))) static const uint8_t SetupGetHidReportDescr[] = {
+    USB_REQ_TYP_IN | USB_REQ_RECIP_INTERF, USB_GET_DESCRIPTOR, 0x00, USB_DESCR_TYP_REPORT, 0x00, 0x00, 0x00, 0x00
+};
+
+// ===================================================================
+// 描述符读取
+// ===================================================================
+
+/**
+ * @brief 读取配置描述符，取第一个接口的 HID 信息
+ * @param info  输出接口信息
+ * @return ERR_SUCCESS；第一个接口不是 HID 或没有 HID 描述符时返回 ERR_USB_UNSUPPORT
+ * @note  调用前需 SelectU2HubPort 选中设备
+ */
+uint8_t HidDesc_ReadConfig(HidIfInfo_t *info)
+{
+    uint8_t *buf = U2Com_Buffer;
+    uint16_t i, total;
+    uint8_t  s, n_iface = 0;
+
+    memset(info, 0, sizeof(HidIfInfo_t));
+    s = CtrlGetU2ConfigDescr();
+    if (s != ERR_SUCCESS) return s;
+    total = ((PUSB_CFG_DESCR)buf)->wTotalLength;
+    if (total > HID_CFG_BUF_LEN) total = HID_CFG_BUF_LEN;
+
+    for (i = 0; i + 2 <= total && buf[i] >= 2; i += buf[i]) {
+        if (buf[i + 1] == USB_DESCR_TYP_INTERF) {
+            PUSB_ITF_DESCR itf = (PUSB_ITF_DESCR)(buf + i);
+            if (n_iface++) break;
+            if (itf->bInterfaceClass != USB_DEV_CLASS_HID) return ERR_USB_UNSUPPORT;
+            info->iface    = itf->bInterfaceNumber;
+            info->subclass = itf->bInterfaceSubClass;
+            info->protocol = itf->bInterfaceProtocol;
+        } else if (buf[i + 1] == USB_DESCR_TYP_HID && i + 9 <= total) {
+            info->rpt_len = buf[i + 7] | ((uint16_t)buf[i + 8] << 8);
+        } else if (buf[i + 1] == USB_DESCR_TYP_ENDP && !info->interval &&
+                   (buf[i + 2] & USB_ENDP_DIR_MASK) &&
+                   (buf[i + 3] & USB_ENDP_TYPE_MASK) == USB_ENDP_TYPE_INTER) {
+            info->interval = buf[i + 6];
+        }
+    }
+    return info->rpt_len ? ERR_SUCCESS : ERR_USB_UNSUPPORT;
+}
+
+/**
+ * @brief 读取报告描述符
+ * @param info  HidDesc_ReadConfig 取得的接口信息
+ * @param len   输出实际读到的长度
+ * @return 描述符缓冲 (协议栈堆，用完由调用者 tmos_msg_deallocate)，失败返回 NULL
+ * @note  需要 Usb2DevEndp0Size 与该设备一致，设备刚枚举完时成立
+ */
+uint8_t *HidDesc_ReadReport(const HidIfInfo_t *info, uint8_t *len)
+{
+    uint16_t want = (info->rpt_len > HID_DESC_MAX) ? HID_DESC_MAX : info->rpt_len;
+    uint8_t *desc;
+
+    *len = 0;
+    desc = tmos_msg_allocate(want);
+    if (desc == NULL) return NULL;
+
+    CopyU2SetupReqPkg(SetupGetHidReportDescr);
+    pU2SetupReq->wIndex  = info->iface;
+    pU2SetupReq->wLength = want;
+    if (U2HostCtrlTransfer(desc, len) != ERR_SUCCESS || *len == 0) {
+        tmos_msg_deallocate(desc);
+        return NULL;
+    }
+    return desc;
+}
+
+// ===================================================================
+// 报告描述符解析
+// ===================================================================
+
+/**
+ * @brief 取报告 ID 对应的位偏移累计值 (首次出现时分配)
+ */
+static uint16_t *HidDesc_IdBits(uint8_t *ids, uint16_t *bits, uint8_t *n_ids, uint8_t rid)
+{
+    uint8_t i;
+
+    for (i = 0; i < *n_ids; i++) {
+        if (ids[i] == rid) return &bits[i];
+    }
+    if (*n_ids >= HID_REPORT_IDS) return NULL;
+    ids[*n_ids]  = rid;
+    bits[*n_ids] = 0;
+    return &bits[(*n_ids)++];
+}
+
+/**
+ * @brief 遍历报告描述符的输入条目
+ * @param want_id  < 0：查找 app 集合中含绝对 usages[0] 的第一个输入报告
+ *                 >= 0：把该报告中与 usages[] 匹配的字段记入 fields[]
+ * @return 查找模式返回报告 ID，未找到返回 -1；记录模式返回 want_id
+ */
+static int16_t HidDesc_Walk(const uint8_t *d, uint16_t len, int16_t want_id, uint32_t app,
+                            const uint32_t *usages, uint8_t num, HidField_t *fields)
+{
+    uint32_t local[HID_LOCAL_USAGES];
+    uint32_t page = 0, umin = 0, umax = 0, uval, u, cur_app = 0;
+    int32_t  sval, lmin = 0, lmax_s = 0, lmax;
+    uint32_t lmax_u = 0;
+    uint8_t  n_usage = 0, has_range = 0, depth = 0;
+    uint8_t  rsize = 0, rcount = 0, rid = 0;
+    uint8_t  ids[HID_REPORT_IDS], n_ids = 0;
+    uint16_t bits[HID_REPORT_IDS], *pos, bit;
+    uint8_t  size, type, tag, k, f;
+    uint16_t i = 0;
+
+    while (i < len) {
+        // 长条目：跳过
+        if (d[i] == HID_ITEM_LONG) {
+            if (i + 1 >= len) break;
+            i += 3 + d[i + 1];
+            continue;
+        }
+
+        size = d[i] & 0x03;
+        if (size == 3) size = 4;
+        type = (d[i] >> 2) & 0x03;
+        tag  = d[i] >> 4;
+        if (i + 1 + size > len) break;
+
+        uval = 0;
+        for (k = 0; k < size; k++) {
+            uval |= (uint32_t)d[i + 1 + k] << (8 * k);
+        }
+        sval = (size == 1) ? (int8_t)uval : (size == 2) ? (int16_t)uval : (int32_t)uval;
+        i += 1 + size;
+
+        if (type == HID_ITEM_TYPE_GLOBAL) {
+            switch (tag) {
+                case HID_GLOBAL_USAGE_PAGE:   page   = uval; break;
+                case HID_GLOBAL_LOGICAL_MIN:  lmin   = sval; break;
+                case HID_GLOBAL_LOGICAL_MAX:  lmax_s = sval; lmax_u = uval; break;
+                case HID_GLOBAL_REPORT_SIZE:  rsize  = (uint8_t)uval; break;
+                case HID_GLOBAL_REPORT_ID:    rid    = (uint8_t)uval; break;
+                case HID_GLOBAL_REPORT_COUNT: rcount = (uint8_t)uval; break;
+                default: break;
+            }
+            continue;
+        }
+
+        if (type == HID_ITEM_TYPE_LOCAL) {
+            // 1~2 字节用法在主条目处结合当时的用法页，4 字节用法自带用法页
+            u = (size == 4) ? uval : (uval & 0xFFFF);
+            if (tag == HID_LOCAL_USAGE && n_usage < HID_LOCAL_USAGES) {
+                local[n_usage++] = u;
+            } else if (tag == HID_LOCAL_USAGE_MIN) {
+                umin = u;
+                has_range = TRUE;
+            } else if (tag == HID_LOCAL_USAGE_MAX) {
+                umax = u;
+            }
+            continue;
+        }
+
+        if (type != HID_ITEM_TYPE_MAIN) continue;
+
+        if (tag == HID_MAIN_COLLECTION) {
+            // 顶层应用集合的用法决定设备种类 (鼠标、手柄、数位板……)
+            if (depth == 0 && uval == HID_COLLECTION_APP) {
+                cur_app = n_usage ? local[0] : 0;
+                if (cur_app && !(cur_app >> 16)) cur_app |= page << 16;
+            }
+            depth++;
+        } else if (tag == HID_MAIN_END_COLLECTION) {
+            if (depth) depth--;
+        } else if (tag == HID_MAIN_INPUT && (pos = HidDesc_IdBits(ids, bits, &n_ids, rid)) != NULL) {
+            // 逻辑最小值非负时，逻辑最大值按无符号数解释 (HID 1.11 6.2.2.7)
+            lmax = (lmin < 0) ? lmax_s : (int32_t)lmax_u;
+
+            for (k = 0; k < rcount && !(uval & HID_INPUT_CONSTANT) && (uval & HID_INPUT_VARIABLE); k++) {
+                if (has_range) {
+                    u = (umin + k <= umax) ? umin + k : umax;
+                } else if (n_usage) {
+                    u = local[(k < n_usage) ? k : n_usage - 1];
+                } else {
+                    break;
+                }
+                if (!(u >> 16)) u |= page << 16;
+
+                if (want_id < 0) {
+                    if (u == usages[0] && !(uval & HID_INPUT_RELATIVE) &&
+                        (app == HID_APP_ANY || app == cur_app)) {
+                        return rid;
+                    }
+                    continue;
+                }
+                if (rid != want_id || rsize == 0 || rsize > 32) continue;
+
+                bit = *pos + k * rsize;
+                for (f = 0; f < num; f++) {
+                    HidField_t *fd = &fields[f];
+
+                    if (fd->size == 0) {
+                        if (u != usages[f]) continue;
+                        fd->pos   = bit;
+                        fd->size  = rsize;
+                        fd->count = 1;
+                        fd->flags = (uint8_t)uval;
+                        fd->lmin  = lmin;
+                        fd->lmax  = lmax;
+                    } else if (u == usages[f] + fd->count && fd->count < 0xFF &&
+                               rsize == fd->size && bit == fd->pos + fd->count * rsize) {
+                        // 用法与位置都紧接上一个：并入同一组 (如按键 1~N)
+                        fd->count++;
+                    }
+                }
+            }
+            *pos += (uint16_t)rsize * rcount;
+        }
+
+        // 主条目之后局部条目失效
+        n_usage   = 0;
+        has_range = FALSE;
+    }
+
+    return (want_id < 0) ? -1 : want_id;
+}
+
+/**
+ * @brief 查找含指定绝对用法的第一个输入报告
+ * @param app    顶层应用集合用法 (HID_APP_ANY 不限)
+ * @param usage  要查找的用法，如 HID_USAGE(0x01, 0x30) 绝对 X
+ * @return 报告 ID (0 = 设备不使用报告 ID)，未找到返回 -1
+ */
+int16_t HidDesc_FindAbsInput(const uint8_t *desc, uint16_t len, uint32_t app, uint32_t usage)
+{
+    return HidDesc_Walk(desc, len, -1, app, &usage, 1, NULL);
+}
+
+/**
+ * @brief 按用法表记录某个输入报告中的字段
+ * @param rpt_id  报告 ID
+ * @param usages  用法表，fields[] 与之一一对应
+ * @param fields  输出字段，未出现的用法 size 为 0
+ */
+void HidDesc_MapInput(const uint8_t *desc, uint16_t len, uint8_t rpt_id,
+                      const uint32_t *usages, uint8_t num, HidField_t *fields)
+{
+    memset(fields, 0, num * sizeof(HidField_t));
+    HidDesc_Walk(desc, len, rpt_id, HID_APP_ANY, usages, num, fields);
+}
+
+// ===================================================================
+// 字段取值
+// ===================================================================
+
+/**
+ * @brief 按位偏移取字段原始值 (小端位序)，逻辑最小值为负时按有符号数扩展
+ * @param idx  组内序号 (0 ~ count-1)
+ * @param buf  报文 (不含报告 ID 字节)
+ * @note  超出报文长度的位按 0 处理
+ */
+int32_t HidDesc_GetValue(const HidField_t *fd, uint8_t idx, const uint8_t *buf, uint8_t len)
+{
+    uint32_t raw = 0;
+    uint16_t b = fd->pos + (uint16_t)idx * fd->size;
+    uint8_t  k;
+
+    for (k = 0; k < fd->size; k++, b++) {
+        if ((b >> 3) >= len) break;
+        if (buf[b >> 3] & (1 << (b & 7))) raw |= 1UL << k;
+    }
+    if (fd->lmin < 0 && fd->size < 32 && (raw & (1UL << (fd->size - 1)))) {
+        raw |= ~0UL << fd->size;
+    }
+    return (int32_t)raw;
+}
+
+/**
+ * @brief 逻辑范围映射到 0 ~ out_max 的 Q16 系数 (向上取整，逻辑最大值恰好映射到 out_max)
+ * @return 0 表示逻辑范围无效
+ */
+uint32_t HidDesc_ScaleQ16(const HidField_t *fd, uint16_t out_max)
+{
+    uint32_t range;
+
+    if (fd->size == 0 || fd->lmax <= fd->lmin) return 0;
+    range = (uint32_t)(fd->lmax - fd->lmin);
+    return (((uint32_t)out_max << 16) + range - 1) / range;
+}
+
+/**
+ * @brief 原始值限制在逻辑范围内后按预先算好的系数缩放到 0 ~ out_max
+ */
+uint16_t HidDesc_Scale(const HidField_t *fd, uint32_t scale, int32_t value, uint16_t out_max)
+{
+    uint32_t v;
+
+    if (value < fd->lmin) value = fd->lmin;
+    if (value > fd->lmax) value = fd->lmax;
+    v = (uint32_t)(((uint64_t)(uint32_t)(value - fd->lmin) * scale) >> 16);
+    return (v > out_max) ? out_max : (uint16_t)v;
+}
@@ -11,9 +11,23 @@
 #include "devinfoservice.h"
 #include "battservice.h"
 #include "hidkbdservice.h"
+#include "latprobeservice.h"
 #include "hiddev.h"
 #include "hidkbd.h"
+#include "battery.h"
+#include "usb_bridge.h"
+#include "user_key.h"
+#include "power.h"
+#include "tx_power.h"
+#include "reconn_adv.h"
+#include "usb_device.h"
+#include "usb_capture.h"
+#include "clk_scale.h"
+#include "conn_trace.h"
+#include "rf_output.h"
+#include "cache_aware.h"
 #include "debug.h"
+#include "evt_mon.h"
 
 // ===================================================================
 // 蓝牙参数配置 (BLE Configuration)
@@ -23,6 +37,8 @@
 #define DEFAULT_DESIRED_MAX_CONN_INTERVAL    8
 #define DEFAULT_DESIRED_SLAVE_LATENCY        0
 #define DEFAULT_DESIRED_CONN_TIMEOUT         500
+#define SUSPEND_DESIRED_SLAVE_LATENCY        199   // 主机挂起时的从机延迟: (1+199)*10ms=2s, 2倍仍小于 5s 超时
+#define PARAM_UPDATE_MAX_RETRY               3     // 连接参数被拒后的最大重试次数
 #define DEFAULT_PASSCODE                     0
 #define DEFAULT_PAIRING_MODE                 GAPBOND_PAIRING_MODE_WAIT_FOR_REQ
 #define DEFAULT_MITM_MODE                    FALSE
@@ -30,13 +46,12 @@
 #define DEFAULT_IO_CAPABILITIES              GAPBOND_IO_CAP_NO_INPUT_NO_OUTPUT
 #define DEFAULT_BATT_CRITICAL_LEVEL          6
 
-// ===================================================================
-// 硬件引脚配置 (Hardware Config)
-// ===================================================================
-
-// 电池检测 (ADC -> PA4)
-#define BATT_ADC_PIN         GPIO_Pin_4
-#define BATT_ADC_CHANNEL     0            // ADC Channel 0
+// 2.4G 模式下射频由私有链路 (rf_output.c) 独占，不开启广播
+#ifdef ENABLE_RF_LINK
+#define HID_ADV_ENABLE                       FALSE
+#else
+#define HID_ADV_ENABLE                       TRUE
+#endif
 
 // ===================================================================
 // 蓝牙广播数据
@@ -82,83 +97,95 @@ static uint8_t is_sys_led_startup = TRUE; // 是否还在上电 SYS 灯长亮阶
 
 uint8_t is_usb_idle = FALSE;  // USB 30秒空闲标志
 
-// 电池相关
-static uint8_t      last_batt_percent   = 0;  // 上次上报的电量
-static signed short ADC_RoughCalib_Value = 0; // ADC 校准偏移值
-
-// 放电曲线查找表 (mV -> %), 线性插值
-typedef struct { uint16_t mv; uint8_t pct; } BattMap;
-static const BattMap batt_table[] = {
-    {4200, 100},
-    {4100,  95},
-    {4070,  90},
-    {4000,  80},
-    {3910,  70},
-    {3840,  60},
-    {3750,  50},
-    {3660,  40},
-    {3600,  30},
-    {3510,  20},
-    {3450,  15},
-    {3380,  10},
-    {3340,   8},
-    {3300,   6},
-    {3260,   4},
-    {3220,   2},
-    {3180,   1},
-    {3100,   0},
-    {0,      0}  // 结束符（边界保护）
-};
-#define BATT_TABLE_COUNT  (sizeof(batt_table) / sizeof(BattMap))
+// 主机实际授予的连接参数 (每个连接一条记录)
+typedef struct {
+    uint16_t connHandle;    // 连接句柄
+    uint16_t interval;      // 连接间隔 (1.25ms 单位, 0 表示空闲记录)
+    uint16_t latency;       // 从机延迟
+    uint16_t timeout;       // 监督超时 (10ms 单位)
+} ConnParams_t;
+static ConnParams_t conn_params[PERIPHERAL_MAX_CONNECTION];
+static uint8_t      param_update_retry = 0;   // 当前目标参数已请求次数
+
+// 主机挂起 (HID Control Point Suspend)
+static uint8_t  is_host_suspended = FALSE;  // 主机是否处于挂起状态
+static uint8_t  suspend_measure   = 0;      // 延迟测量阶段: 0=无, 1=等待进入完成, 2=等待退出完成
+static uint32_t suspend_evt_tick  = 0;      // 挂起/恢复触发时刻 (TMOS tick)
+
+// 冷恢复快速回连 (深度关机唤醒后)
+static uint8_t  is_fast_adv       = FALSE;  // 是否正在使用快速回连广播参数
+static uint16_t adv_int_min_saved = 0;      // 被替换的默认广播参数
+static uint16_t adv_int_max_saved = 0;
+static uint16_t adv_timeout_saved = 0;
 
 // ===================================================================
 // 内部函数声明
 // ===================================================================
 static void    HidEmu_ProcessTMOSMsg(tmos_event_hdr_t *pMsg);
-static void    HidEmu_MeasureBattery(void);
+static void    HidEmu_UpdateBattery(void);
 static void    HidEmu_StateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent);
 static uint8_t HidEmu_RptCB(uint8_t id, uint8_t type, uint16_t uuid, uint8_t oper, uint16_t *pLen, uint8_t *pData);
+static void    HidEmu_EvtCB(uint8_t evt);
+static void    HidEmu_ParamUpdateCB(uint16_t connHandle, uint16_t connInterval,
+                                    uint16_t connSlaveLatency, uint16_t connTimeout);
+static void    HidEmu_RecordConnParams(uint16_t connHandle, uint16_t interval,
+                                       uint16_t latency, uint16_t timeout);
+static uint8_t HidEmu_ConnParamsDesired(uint16_t connHandle);
+static void    HidEmu_RequestConnParams(void);
+static void    HidEmu_EnterHostSuspend(void);
+static void    HidEmu_ExitHostSuspend(void);
+static void    HidEmu_KeyCB(uint8_t keyEvt);
+static void    HidEmu_StartFastAdvertising(void);
+static void    HidEmu_EndFastAdvertising(void);
 
 // 回调结构体
 static hidDevCB_t hidEmuHidCBs = {
     HidEmu_RptCB,
-    NULL,  // EvtCB 未使用
+    HidEmu_EvtCB,
     NULL,
-    HidEmu_StateCB
+    HidEmu_StateCB,
+    HidEmu_ParamUpdateCB,
+    TxPower_OnRssi,
+    ReconnAdv_OnScanParam,
+    CacheAware_OnPairState
 };
 
 // ===================================================================
 // 初始化
 // ===================================================================
+EVT_MON_DEFINE(HidEmu_ProcessEvent, EVT_MON_TASK_HIDEMU)
+
 void HidEmu_Init()
 {
-    hidEmuTaskId = TMOS_ProcessEventRegister(HidEmu_ProcessEvent);
+    hidEmuTaskId = TMOS_ProcessEventRegister(EVT_MON_FN(HidEmu_ProcessEvent));
 
     // 1. 初始化 LED 引脚 (推挽输出)
     GPIOA_ModeCfg(SYS_LED_PIN | BLE_LED_PIN, GPIO_ModeOut_PP_5mA);
 
-    // 2. 初始化 USER 按键 (上拉输入)
-    GPIOB_ModeCfg(USER_KEY_PIN, GPIO_ModeIN_PU);
+    // 2. 初始化 USER 按键 (中断驱动，可唤醒睡眠)
+    UserKey_Init(HidEmu_KeyCB);
 
-    // 3. 上电时 SYS 长亮
+    // 3. 上电时 SYS 长亮 (冷恢复时只短亮提示，尽快回到正常功耗)
     is_sys_led_startup = TRUE;
     SYS_LED_ON();
     BLE_LED_OFF();
-    tmos_start_task(hidEmuTaskId, HID_SYS_LED_OFF_EVT, TIME_SYS_LED_STARTUP);
-
-    // 4. 启动按键轮询
-    tmos_start_task(hidEmuTaskId, HID_USER_KEY_POLL_EVT, TIME_KEY_POLL);
+    tmos_start_task(hidEmuTaskId, HID_SYS_LED_OFF_EVT,
+                    Power_IsColdResume() ? TIME_SYS_LED_WAKE_FLASH : TIME_SYS_LED_STARTUP);
 
-    // 5. GAP 广播与通用配置
+    // 4. GAP 广播与通用配置
     {
-        uint8_t initial_advertising_enable = TRUE;
+        uint8_t initial_advertising_enable = HID_ADV_ENABLE;
         GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &initial_advertising_enable);
         GAPRole_SetParameter(GAPROLE_ADVERT_DATA, sizeof(advertData), advertData);
         GAPRole_SetParameter(GAPROLE_SCAN_RSP_DATA, sizeof(scanRspData), scanRspData);
     }
     GGS_SetParameter(GGS_DEVICE_NAME_ATT, sizeof(attDeviceName), (void *)attDeviceName);
+    ReconnAdv_Init();   // 按最近连接主机的扫描参数准备回连广播
+    if (Power_IsColdResume()) {
+        HidEmu_StartFastAdvertising();
+    }
 
-    // 6. 安全与配对配置 (Bond Manager)
+    // 5. 安全与配对配置 (Bond Manager)
     {
         uint32_t passkey = DEFAULT_PASSCODE;
         uint8_t  pairMode = DEFAULT_PAIRING_MODE;
@@ -173,34 +200,37 @@ void HidEmu_Init()
         GAPBondMgr_SetParameter(GAPBOND_PERI_BONDING_ENABLED,  sizeof(uint8_t),  &bonding);
     }
 
-    // 7. 注册 GATT 服务
+    // 6. 注册 GATT 服务
     {
         uint8_t critical = DEFAULT_BATT_CRITICAL_LEVEL;
         Batt_SetParameter(BATT_PARAM_CRITICAL_LEVEL, sizeof(uint8_t), &critical);
         Hid_AddService();
         HidDev_Register(&hidEmuCfg, &hidEmuHidCBs);
+        // 延迟探测服务排在 HID 服务之后，不改变已绑定主机缓存的句柄
+        LatProbe_AddService();
+        LatProbe_Register(USB_Bridge_GetQueueDepth);
+        // 摘要覆盖以上全部服务
+        CacheAware_Init(hidEmuTaskId);
     }
+    TxPower_Init();  // 发射功率自适应，连接建立后开始调节
+    ConnTrace_Init();
 
-    // 8. ADC 硬件初始化 (电量检测)
-    {
-        GPIOA_ModeCfg(BATT_ADC_PIN, GPIO_ModeIN_Floating);
-        ADC_ExtSingleChSampInit(SampleFreq_3_2, ADC_PGA_1_2);
-        ADC_RoughCalib_Value = ADC_DataCalib_Rough();
-        LOG_BATT("ADC Init. Offset: %d\n", ADC_RoughCalib_Value);
+    // 7. 电池子系统初始化 (唯一的 ADC 持有者)
+    // 冷恢复时首次采样推迟一个周期，回连后连接事件会立即刷新一次
+    Battery_Init();
+    tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT,
+                    Power_IsColdResume() ? TIME_BATT_READ_INTERVAL : TIME_BATT_BOOT_DELAY);
 
-        tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT, TIME_BATT_BOOT_DELAY);
-    }
-
-    // 9. 启动设备主事件
+    // 8. 启动设备主事件
     tmos_set_event(hidEmuTaskId, START_DEVICE_EVT);
 
-    // 10. 启动 USB 桥接的 TMOS 轮询任务 (初始全速)
+    // 9. 启动 USB 桥接的 TMOS 轮询任务 (初始全速)
     tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_ACTIVE);
 
-    // 11. 启动 5 分钟不活动软休眠倒计时
+    // 10. 启动 5 分钟不活动软休眠倒计时
     tmos_start_task(hidEmuTaskId, HID_SLEEP_TIMEOUT_EVT, TIME_SLEEP_TIMEOUT);
 
-    // 12. 启动 30 秒 USB 空闲降频倒计时
+    // 11. 启动 30 秒 USB 空闲降频倒计时
     tmos_start_task(hidEmuTaskId, HID_USB_IDLE_EVT, TIME_USB_IDLE);
 }
 
@@ -216,54 +246,12 @@ uint16_t HidEmu_ProcessEvent(uint8_t task_id, uint16_t events)
         return (events ^ HID_SYS_LED_OFF_EVT);
     }
 
-    // [SYS] 低电量闪烁翻转
-    if (events & HID_SYS_LED_BLINK_EVT) {
-        SYS_LED_TOGGLE();
-        tmos_start_task(hidEmuTaskId, HID_SYS_LED_BLINK_EVT, TIME_SYS_LED_BLINK);
-        return (events ^ HID_SYS_LED_BLINK_EVT);
-    }
-
     // [BLE] 连接后定时熄灭 BLE 灯
     if (events & HID_BLE_LED_OFF_EVT) {
         BLE_LED_OFF();
         return (events ^ HID_BLE_LED_OFF_EVT);
     }
 
-    // [BLE] 广播/断连时闪烁翻转
-    if (events & HID_BLE_LED_BLINK_EVT) {
-        BLE_LED_TOGGLE();
-        tmos_start_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT, TIME_BLE_LED_BLINK);
-        return (events ^ HID_BLE_LED_BLINK_EVT);
-    }
-
-    // [USER 按键] 按键轮询，按下时断开连接并进入软休眠
-    if (events & HID_USER_KEY_POLL_EVT) {
-        static uint8_t key_last_state = 1;
-        uint8_t key_current = READ_USER_KEY();
-
-        // 检测下降沿（按下）
-        if (key_last_state == 1 && key_current == 0) {
-            uint8_t gap_state;
-            GAPRole_GetParameter(GAPROLE_STATE, &gap_state);
-            if (gap_state == GAPROLE_CONNECTED) {
-                is_ble_sleeping = TRUE;
-
-                uint8_t adv_en = FALSE;
-                GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &adv_en);
-
-                SYS_LED_OFF();
-                BLE_LED_OFF();
-                tmos_stop_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT);
-
-                GAPRole_TerminateLink(hidEmuConnHandle);
-            }
-        }
-        key_last_state = key_current;
-
-        tmos_start_task(hidEmuTaskId, HID_USER_KEY_POLL_EVT, TIME_KEY_POLL);
-        return (events ^ HID_USER_KEY_POLL_EVT);
-    }
-
     // 系统消息处理
     if (events & SYS_EVENT_MSG) {
         uint8_t *pMsg;
@@ -279,21 +267,47 @@ uint16_t HidEmu_ProcessEvent(uint8_t task_id, uint16_t events)
         return (events ^ START_DEVICE_EVT);
     }
 
-    // 电池周期检测
+    // 深度关机：软休眠后长时间无操作，进入下电模式 (不返回，唤醒即复位)
+    if (events & HID_SHUTDOWN_EVT) {
+        if (is_ble_sleeping && !is_host_suspended) {
+            if (UsbDev_IsActive()) {
+                // 有线输出在线 (主机供电)：推迟关机
+                tmos_start_task(hidEmuTaskId, HID_SHUTDOWN_EVT, TIME_SHUTDOWN_TIMEOUT);
+            } else {
+                Power_EnterShutdown();
+            }
+        }
+        return (events ^ HID_SHUTDOWN_EVT);
+    }
+
+    // 电池周期检测（全系统唯一的电量采样调度）
     if (events & START_BATT_READ_EVT) {
-        HidEmu_MeasureBattery();
+        HidEmu_UpdateBattery();
         tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT, TIME_BATT_READ_INTERVAL);
         return (events ^ START_BATT_READ_EVT);
     }
 
-    // 连接参数更新
+    // 连接参数更新 (主机挂起时请求最大从机延迟)
+    // 请求后预约一次退避重试；主机按期望参数更新后在回调中取消
     if (events & START_PARAM_UPDATE_EVT) {
+        if (HidEmu_ConnParamsDesired(hidEmuConnHandle)) {
+            return (events ^ START_PARAM_UPDATE_EVT);  // 已是期望参数，无需请求
+        }
         GAPRole_PeripheralConnParamUpdateReq(hidEmuConnHandle,
                                              DEFAULT_DESIRED_MIN_CONN_INTERVAL,
                                              DEFAULT_DESIRED_MAX_CONN_INTERVAL,
-                                             DEFAULT_DESIRED_SLAVE_LATENCY,
+                                             is_host_suspended ? SUSPEND_DESIRED_SLAVE_LATENCY
+                                                               : DEFAULT_DESIRED_SLAVE_LATENCY,
                                              DEFAULT_DESIRED_CONN_TIMEOUT,
                                              hidEmuTaskId);
+        if (param_update_retry < PARAM_UPDATE_MAX_RETRY) {
+            // 被拒后 30 秒内不得重复请求 (TGAP(conn_param_timeout))，之后指数退避
+            tmos_start_task(hidEmuTaskId, START_PARAM_UPDATE_EVT,
+                            TIME_PARAM_RETRY_BASE << param_update_retry);
+            param_update_retry++;
+        } else {
+            LOG_BLE("Param update gave up, keep granted params\n");
+        }
         return (events ^ START_PARAM_UPDATE_EVT);
     }
 
@@ -311,10 +325,10 @@ uint16_t HidEmu_ProcessEvent(uint8_t task_id, uint16_t events)
 
         uint8_t adv_en = FALSE;
         GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &adv_en);
+        RfOut_SetEnable(FALSE);
 
         SYS_LED_OFF();
         BLE_LED_OFF();
-        tmos_stop_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT);
 
         uint8_t gap_state;
         GAPRole_GetParameter(GAPROLE_STATE, &gap_state);
@@ -322,23 +336,41 @@ uint16_t HidEmu_ProcessEvent(uint8_t task_id, uint16_t events)
             GAPRole_TerminateLink(hidEmuConnHandle);
         }
 
+        // 启动深度关机倒计时，期间有输入则在唤醒时取消
+        tmos_start_task(hidEmuTaskId, HID_SHUTDOWN_EVT, TIME_SHUTDOWN_TIMEOUT);
+
         return (events ^ HID_SLEEP_TIMEOUT_EVT);
     }
 
-    // USB 动态轮询（三级电源管理）
+    // USB 动态轮询（三级电源管理 + 主机挂起）
     if (events & HID_USB_POLL_EVT) {
-        extern void USB_Bridge_Poll(void);
+        // 本轮 USB 事务开始前按活动层级选择主频
+        // 2.4G 链路在线时保持全速 (时隙定时器按 Tsys 计数)
+        if (UsbDev_IsActive() || RfOut_IsActive() || !(is_usb_idle || is_ble_sleeping)) {
+            ClkScale_Set(CLK_TIER_FULL);
+        } else if (is_ble_sleeping) {
+            ClkScale_Set(CLK_TIER_SLEEP);
+        } else {
+            ClkScale_Set(CLK_TIER_IDLE);
+        }
+
         USB_Bridge_Poll();
 
-        if (is_ble_sleeping) {
+        if (UsbDev_IsActive() || RfOut_IsActive()) {
+            // 有线/2.4G 输出：与蓝牙状态无关，始终全速轮询
+            tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, USB_Bridge_GetPollTicks());
+        } else if (is_host_suspended) {
+            // 主机挂起：仅检测唤醒按键，100ms
+            tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_SUSPEND);
+        } else if (is_ble_sleeping) {
             // 第三级：蓝牙已关闭，深度降频 500ms
             tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_SLEEP);
         } else if (is_usb_idle) {
             // 第二级：蓝牙保持，USB 降频 50ms
             tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_IDLE);
         } else {
-            // 第一级：正在输入，全速 ~1.25ms
-            tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_ACTIVE);
+            // 第一级：正在输入，按连接间隔派生的全速周期 (1.25ms~10ms)
+            tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, USB_Bridge_GetPollTicks());
         }
 
         return (events ^ HID_USB_POLL_EVT);
@@ -356,64 +388,17 @@ uint16_t HidEmu_ProcessEvent(uint8_t task_id, uint16_t events)
 // ===================================================================
 // 电池测量
 // ===================================================================
-static void HidEmu_MeasureBattery(void)
+static void HidEmu_UpdateBattery(void)
 {
-    uint32_t adc_sum = 0;
-    uint16_t adc_avg = 0;
-    int32_t  voltage_mv = 0;
-    uint8_t  percent = 0;
-    signed short raw_val;
-
-    // 1. 切换通道并采集（软件滤波：20次平均）
-    ADC_ChannelCfg(BATT_ADC_CHANNEL);
-    for (int i = 0; i < 20; i++) {
-        raw_val = ADC_ExcutSingleConver() + ADC_RoughCalib_Value;
-        if (raw_val < 0) raw_val = 0;
-        adc_sum += raw_val;
-    }
-    adc_avg = adc_sum / 20;
-
-    // 2. 电压换算（根据硬件分压电阻）
-    int32_t temp_calc = (int32_t)adc_avg * 2100;
-    voltage_mv = (temp_calc + 512) / 1024 - 2100;
-    if (voltage_mv < 0) voltage_mv = 0;
-
-    // 3. 查表 + 线性插值获得百分比
-    if (voltage_mv >= (int32_t)batt_table[0].mv) {
-        percent = 100;
-    } else if (voltage_mv <= (int32_t)batt_table[BATT_TABLE_COUNT - 2].mv) {
-        percent = 0;
-    } else {
-        for (int i = 0; i < (int)(BATT_TABLE_COUNT - 1); i++) {
-            if (voltage_mv >= (int32_t)batt_table[i + 1].mv) {
-                uint16_t high_mv  = batt_table[i].mv;
-                uint16_t low_mv   = batt_table[i + 1].mv;
-                uint8_t  high_pct = batt_table[i].pct;
-                uint8_t  low_pct  = batt_table[i + 1].pct;
-                // 线性插值
-                percent = low_pct + (uint32_t)(voltage_mv - low_mv) * (high_pct - low_pct) / (high_mv - low_mv);
-                break;
-            }
-        }
-    }
-
-    // 4. 若电量变化，推送到蓝牙服务
-    if (percent != last_batt_percent) {
-        last_batt_percent = percent;
-        Batt_SetParameter(BATT_PARAM_LEVEL, sizeof(uint8_t), &percent);
-    }
+    // 1. 采样并按迟滞推送到 Battery Service
+    Battery_Update();
 
-    // 5. 低电量警告
-    if (percent <= BATT_LOW_THRESHOLD) {
-        tmos_start_task(hidEmuTaskId, HID_SYS_LED_BLINK_EVT, TIME_SYS_LED_BLINK);
-    } else {
-        tmos_stop_task(hidEmuTaskId, HID_SYS_LED_BLINK_EVT);
-        if (!is_sys_led_startup) {
-            SYS_LED_OFF();
-        }
+    // 2. 低电量警告
+    if (Battery_IsLow()) {
+        SYS_LED_BLINK(TIME_SYS_LED_BLINK_MS);
+    } else if (!is_sys_led_startup) {
+        SYS_LED_OFF();
     }
-
-    LOG_BATT("ADC:%d  V:%dmV  Pct:%d%%\n", adc_avg, (int)voltage_mv, percent);
 }
 
 // ===================================================================
@@ -437,7 +422,8 @@ static void HidEmu_StateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent)
                 LOG_BLE("Advertising...\n");
             }
             tmos_stop_task(hidEmuTaskId, HID_BLE_LED_OFF_EVT);
-            tmos_start_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT, TIME_BLE_LED_BLINK);
+            BLE_LED_BLINK(TIME_BLE_LED_BLINK_MS);
+            ReconnAdv_OnAdvStart();
             break;
 
         case GAPROLE_CONNECTED:
@@ -445,17 +431,27 @@ static void HidEmu_StateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent)
             {
                 gapEstLinkReqEvent_t *event = (gapEstLinkReqEvent_t *)pEvent;
                 hidEmuConnHandle = event->connectionHandle;
+                ReconnAdv_OnConnected(event->devAddrType, event->devAddr);
+                CacheAware_OnConnected(event->connectionHandle, event->devAddr, event->connInterval);
+                is_host_suspended = FALSE;
+                suspend_measure = 0;
+                HidEmu_EndFastAdvertising();
+
+                // 记录主机初始授予的连接参数并发布给桥接层
+                HidEmu_RecordConnParams(event->connectionHandle, event->connInterval,
+                                        event->connLatency, event->connTimeout);
 
+                param_update_retry = 0;
                 tmos_start_task(hidEmuTaskId, START_PARAM_UPDATE_EVT, TIME_PARAM_UPDATE_DELAY);
+                TxPower_Start(hidEmuConnHandle);
                 LOG_BLE("Connected! Handle: %d\n", hidEmuConnHandle);
 
                 // 停止闪烁，点亮 BLE 灯，10秒后熄灭
-                tmos_stop_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT);
                 BLE_LED_ON();
                 tmos_start_task(hidEmuTaskId, HID_BLE_LED_OFF_EVT, TIME_BLE_LED_CONNECTED);
 
                 // 强制刷新电量
-                last_batt_percent = 0;
+                Battery_ForceNotify();
                 tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT, TIME_BATT_AFTER_CONNECT);
             }
             break;
@@ -465,12 +461,39 @@ static void HidEmu_StateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent)
                 LOG_BLE("Disconnected. Reason: 0x%02x\n", pEvent->linkTerminate.reason);
             }
             tmos_stop_task(hidEmuTaskId, HID_BLE_LED_OFF_EVT);
+            ReconnAdv_OnAdvStop();
+
+            // 冷恢复快速广播超时未回连，恢复默认广播参数后再重新广播
+            HidEmu_EndFastAdvertising();
+
+            // 高占空比回连广播到时未回连，降为低占空比继续广播
+            if (pEvent->gap.opcode != GAP_LINK_TERMINATED_EVENT) {
+                ReconnAdv_UseLowDuty();
+            }
+
+            // 清除连接参数记录，桥接层恢复默认节拍
+            if (pEvent->gap.opcode == GAP_LINK_TERMINATED_EVENT) {
+                tmos_stop_task(hidEmuTaskId, START_PARAM_UPDATE_EVT);
+                HidEmu_RecordConnParams(pEvent->linkTerminate.connectionHandle, 0, 0, 0);
+                TxPower_Stop();
+                ReconnAdv_OnDisconnected();
+                LatProbe_HandleConnStatusCB(pEvent->linkTerminate.connectionHandle, LINKDB_STATUS_UPDATE_REMOVED);
+                CacheAware_OnDisconnected();
+            }
+
+            // 连接断开即结束主机挂起，恢复正常任务
+            if (is_host_suspended) {
+                is_host_suspended = FALSE;
+                suspend_measure = 0;
+                tmos_start_task(hidEmuTaskId, HID_SLEEP_TIMEOUT_EVT, TIME_SLEEP_TIMEOUT);
+                tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT, TIME_BATT_READ_INTERVAL);
+            }
 
             // 处于休眠状态时，不重新开启广播
             if (!is_ble_sleeping) {
-                uint8_t adv_enable = TRUE;
+                uint8_t adv_enable = HID_ADV_ENABLE;
                 GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &adv_enable);
-                tmos_start_task(hidEmuTaskId, HID_BLE_LED_BLINK_EVT, TIME_BLE_LED_BLINK);
+                BLE_LED_BLINK(TIME_BLE_LED_BLINK_MS);
             }
             break;
 
@@ -508,10 +531,302 @@ static uint8_t HidEmu_RptCB(uint8_t id, uint8_t type, uint16_t uuid,
     return status;
 }
 
+// ===================================================================
+// HID 事件回调 (Control Point / Protocol Mode)
+// ===================================================================
+static void HidEmu_EvtCB(uint8_t evt)
+{
+    switch (evt)
+    {
+        case HID_DEV_SUSPEND_EVT:
+            HidEmu_EnterHostSuspend();
+            break;
+
+        case HID_DEV_EXIT_SUSPEND_EVT:
+            HidEmu_ExitHostSuspend();
+            break;
+
+        case HID_DEV_SET_BOOT_EVT:
+            LOG_BLE("Protocol Mode: Boot\n");
+            break;
+
+        case HID_DEV_SET_REPORT_EVT:
+            LOG_BLE("Protocol Mode: Report\n");
+            break;
+
+        default: break;
+    }
+}
+
+// ===================================================================
+// 连接参数跟踪 (Connection Parameters)
+// ===================================================================
+
+/**
+ * @brief 记录某个连接实际生效的参数，并发布给 USB 桥接层
+ * @param interval 为 0 表示连接已断开，释放记录
+ */
+static void HidEmu_RecordConnParams(uint16_t connHandle, uint16_t interval,
+                                    uint16_t latency, uint16_t timeout)
+{
+    ConnParams_t *p = NULL;
+
+    for (int i = 0; i < PERIPHERAL_MAX_CONNECTION; i++) {
+        if (conn_params[i].interval && conn_params[i].connHandle == connHandle) {
+            p = &conn_params[i];
+            break;
+        }
+        if (p == NULL && conn_params[i].interval == 0) {
+            p = &conn_params[i];
+        }
+    }
+    if (p == NULL) {
+        return;
+    }
+
+    p->connHandle = connHandle;
+    p->interval   = interval;
+    p->latency    = latency;
+    p->timeout    = timeout;
+
+    USB_Bridge_SetConnParams(interval, latency);
+    ConnTrace_SetConn(connHandle, interval, latency);
+    LOG_BLE("Conn %d params: Int %d Lat %d TO %d\n", connHandle, interval, latency, timeout);
+}
+
+/**
+ * @brief 某个连接当前参数是否已满足期望 (间隔在范围内且从机延迟匹配当前模式)
+ */
+static uint8_t HidEmu_ConnParamsDesired(uint16_t connHandle)
+{
+    uint16_t want_latency = is_host_suspended ? SUSPEND_DESIRED_SLAVE_LATENCY
+                                              : DEFAULT_DESIRED_SLAVE_LATENCY;
+
+    for (int i = 0; i < PERIPHERAL_MAX_CONNECTION; i++) {
+        ConnParams_t *p = &conn_params[i];
+        if (p->interval && p->connHandle == connHandle) {
+            return (p->interval >= DEFAULT_DESIRED_MIN_CONN_INTERVAL &&
+                    p->interval <= DEFAULT_DESIRED_MAX_CONN_INTERVAL &&
+                    p->latency == want_latency);
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief 目标参数变化 (如进入/退出挂起) 时立即重新请求，重置退避计数
+ */
+static void HidEmu_RequestConnParams(void)
+{
+    param_update_retry = 0;
+    tmos_set_event(hidEmuTaskId, START_PARAM_UPDATE_EVT);
+}
+
+/**
+ * @brief 连接参数更新完成回调
+ *        - 记录主机实际授予的参数并发布给桥接层
+ *        - 达到期望参数则取消退避重试
+ *        - 测量挂起进入/退出延迟 (从触发到链路实际切换到目标从机延迟)
+ */
+static void HidEmu_ParamUpdateCB(uint16_t connHandle, uint16_t connInterval,
+                                 uint16_t connSlaveLatency, uint16_t connTimeout)
+{
+    HidEmu_RecordConnParams(connHandle, connInterval, connSlaveLatency, connTimeout);
+
+    if (HidEmu_ConnParamsDesired(connHandle)) {
+        tmos_stop_task(hidEmuTaskId, START_PARAM_UPDATE_EVT);
+    }
+
+    if ((suspend_measure == 1 && connSlaveLatency == SUSPEND_DESIRED_SLAVE_LATENCY) ||
+        (suspend_measure == 2 && connSlaveLatency == DEFAULT_DESIRED_SLAVE_LATENCY)) {
+        LOG_BLE("Suspend %s: %d ms\n", (suspend_measure == 1) ? "entry" : "exit",
+                (int)((TMOS_GetSystemClock() - suspend_evt_tick) * 5 / 8));
+        suspend_measure = 0;
+    }
+}
+
+// ===================================================================
+// 主机挂起 (Host Suspend)
+// ===================================================================
+
+/**
+ * @brief 主机挂起：USB 仅保留唤醒检测，请求最大从机延迟，停止 LED 与电量任务
+ */
+static void HidEmu_EnterHostSuspend(void)
+{
+    if (is_host_suspended) {
+        return;
+    }
+    is_host_suspended = TRUE;
+    suspend_evt_tick = TMOS_GetSystemClock();
+    suspend_measure = 1;
+
+    // 1. 停止 LED 任务并熄灭
+    tmos_stop_task(hidEmuTaskId, HID_SYS_LED_OFF_EVT);
+    tmos_stop_task(hidEmuTaskId, HID_BLE_LED_OFF_EVT);
+    is_sys_led_startup = FALSE;
+    SYS_LED_OFF();
+    BLE_LED_OFF();
+
+    // 2. 停止电量检测，挂起期间保持连接（否则无法远程唤醒）
+    tmos_stop_task(hidEmuTaskId, START_BATT_READ_EVT);
+    tmos_stop_task(hidEmuTaskId, HID_SLEEP_TIMEOUT_EVT);
+    tmos_stop_task(hidEmuTaskId, HID_USB_IDLE_EVT);
+    is_usb_idle = TRUE;
+
+    // 3. USB 降为唤醒检测轮询
+    tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_SUSPEND);
+
+    // 4. 请求最大从机延迟
+    HidEmu_RequestConnParams();
+
+    LOG_BLE("Host Suspend\n");
+}
+
+/**
+ * @brief 退出主机挂起 (Exit Suspend 命令或按键远程唤醒)，恢复全速链路
+ */
+static void HidEmu_ExitHostSuspend(void)
+{
+    if (!is_host_suspended) {
+        return;
+    }
+    is_host_suspended = FALSE;
+    suspend_evt_tick = TMOS_GetSystemClock();
+    suspend_measure = 2;
+
+    // 1. 恢复从机延迟为 0
+    HidEmu_RequestConnParams();
+
+    // 2. 恢复 USB 全速轮询与各倒计时
+    is_usb_idle = FALSE;
+    tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, USB_Bridge_GetPollTicks());
+    tmos_start_task(hidEmuTaskId, HID_USB_IDLE_EVT, TIME_USB_IDLE);
+    tmos_start_task(hidEmuTaskId, HID_SLEEP_TIMEOUT_EVT, TIME_SLEEP_TIMEOUT);
+
+    // 3. 恢复电量检测 (同时恢复低电量闪烁)
+    tmos_start_task(hidEmuTaskId, START_BATT_READ_EVT, TIME_BATT_AFTER_CONNECT);
+
+    LOG_BLE("Host Resume\n");
+}
+
+/**
+ * @brief USER 按键事件回调 (由 user_key.c 去抖并识别后上报)
+ *        - 短按：已连接时断开并进入软休眠；软休眠/主机挂起时唤醒
+ *        - 双击：输出 TMOS 事件耗时统计
+ *        - 长按 (2 秒)：输出 USB 抓包环形区
+ *        - 超长按 (6 秒)：进入配对模式 (断开当前主机，开放广播接受新主机)；途中的长按照常输出抓包
+ */
+static void HidEmu_KeyCB(uint8_t keyEvt)
+{
+    switch (keyEvt) {
+        case USER_KEY_SHORT: {
+            uint8_t gap_state;
+            GAPRole_GetParameter(GAPROLE_STATE, &gap_state);
+            if ((gap_state == GAPROLE_CONNECTED && !is_host_suspended) || RfOut_IsActive()) {
+                // 与无操作超时走同一条软休眠路径
+                tmos_set_event(hidEmuTaskId, HID_SLEEP_TIMEOUT_EVT);
+            } else {
+                HidEmu_ResetIdleTimer();
+            }
+            break;
+        }
+
+        case USER_KEY_DOUBLE:
+            // 输出 TMOS 事件耗时统计、连接事件时间线与 2.4G 链路统计 (对应开关未启用时为空)
+            EvtMon_Dump();
+            ConnTrace_Dump();
+            RfOut_Dump();
+            break;
+
+        case USER_KEY_LONG:
+            // 输出 USB 抓包记录 (未启用 DEBUG_USB_CAPTURE 时为空)，不影响当前连接
+            UsbCap_Dump();
+            break;
+
+        case USER_KEY_VERY_LONG:
+            // 已绑定时回连广播只接受已绑定主机，配对新主机须显式进入配对模式
+            // (开放广播在新主机配对完成或超时后结束)；先于唤醒调用，唤醒时开启的广播即为开放广播
+            if (HID_ADV_ENABLE) {
+                uint8_t pairing = TRUE;
+                HidEmu_EndFastAdvertising();
+                HidDev_SetParameter(HIDDEV_PAIRING_MODE, sizeof(uint8_t), &pairing);
+                HidEmu_ResetIdleTimer();
+                LOG_BLE("Pairing mode\n");
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 冷恢复后以高占空比广播，让已绑定主机尽快回连 (未绑定时保持默认参数)
+ *        间隔与时长取 hiddev 回连参数，已按主机扫描节奏调整 (reconn_adv.c)
+ */
+static void HidEmu_StartFastAdvertising(void)
+{
+    uint8_t          bond_count = 0;
+    hidDevAdvParam_t adv;
+
+    GAPBondMgr_GetParameter(GAPBOND_BOND_COUNT, &bond_count);
+    if (bond_count == 0) {
+        return;
+    }
+
+    adv_int_min_saved = GAP_GetParamValue(TGAP_DISC_ADV_INT_MIN);
+    adv_int_max_saved = GAP_GetParamValue(TGAP_DISC_ADV_INT_MAX);
+    adv_timeout_saved = GAP_GetParamValue(TGAP_LIM_ADV_TIMEOUT);
+
+    HidDev_GetParameter(HIDDEV_RECONNECT_ADV, &adv);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, adv.highIntMin);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, adv.highIntMax);
+    GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, adv.highTimeout);
+    is_fast_adv = TRUE;
+}
+
+/**
+ * @brief 结束快速回连广播 (已连接或超时)，恢复默认广播参数
+ */
+static void HidEmu_EndFastAdvertising(void)
+{
+    if (!is_fast_adv) {
+        return;
+    }
+    is_fast_adv = FALSE;
+
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, adv_int_min_saved);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, adv_int_max_saved);
+    GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, adv_timeout_saved);
+}
+
+/**
+ * @brief 本任务收到的底层消息 (Service Changed 指示的确认)
+ */
 static void HidEmu_ProcessTMOSMsg(tmos_event_hdr_t *pMsg)
 {
-    // 预留底层消息处理接口
-    return;
+    if (pMsg->event == GATT_MSG_EVENT) {
+        gattMsgEvent_t *pGattMsg = (gattMsgEvent_t *)pMsg;
+
+        if (pGattMsg->method == ATT_HANDLE_VALUE_CFM) {
+            CacheAware_OnIndConfirm(pGattMsg->connHandle);
+        }
+        GATT_bm_free(&pGattMsg->msg, pGattMsg->method);
+    }
+}
+
+/**
+ * @brief 提交一个输入报告，被协议栈接受时记入连接事件时间线
+ */
+static uint8_t HidEmu_Report(uint8_t id, uint8_t len, uint8_t *pData)
+{
+    uint8_t status = HidDev_Report(id, HID_REPORT_TYPE_INPUT, len, pData);
+    if (status == SUCCESS) {
+        ConnTrace_Submit(id);
+        CacheAware_OnReport();
+    }
+    return status;
 }
 
 // ===================================================================
@@ -524,7 +839,46 @@ static void HidEmu_ProcessTMOSMsg(tmos_event_hdr_t *pMsg)
  */
 uint8_t HidEmu_SendUSBReport(uint8_t *pData)
 {
-    return HidDev_Report(HID_RPT_ID_KEY_IN, HID_REPORT_TYPE_INPUT, 8, pData);
+    uint8_t status = HidEmu_Report(HID_RPT_ID_KEY_IN, 8, pData);
+    if (status == SUCCESS) {
+        Power_ReportFirstKey();
+    }
+    return status;
+}
+
+/**
+ * @brief 发送 NKRO 键盘报文 (HID_NKRO_IN_RPT_LEN 字节)
+ * @param pData [Mods, 位图 usage 0x00~HID_NKRO_KEY_MAX]
+ * @note  仅当 HidEmu_GetKeyReportLen() 返回 NKRO 长度时调用
+ */
+uint8_t HidEmu_SendNkroReport(uint8_t *pData)
+{
+    uint8_t status = HidEmu_Report(HID_RPT_ID_NKRO_IN, HID_NKRO_IN_RPT_LEN, pData);
+    if (status == SUCCESS) {
+        Power_ReportFirstKey();
+    }
+    return status;
+}
+
+/**
+ * @brief 当前连接应使用的键盘报文长度
+ * @return HID_NKRO_IN_RPT_LEN：报告协议、主机已订阅 NKRO 报文且协商的 MTU 能单包容纳位图
+ *         8：默认 MTU (主机拒绝交换)、Boot 协议，或主机未订阅 NKRO (更新前绑定且未重新
+ *            发现服务的主机)，回退标准 6 键报文
+ * @note  单个报文空口时间 (加密链路，LL 开销 14B + L2CAP 4B + ATT 3B + 报文，2M PHY 前导码多 1B)：
+ *        - 鼠标 4B:   LL 载荷 11B，1M PHY 200us / 2M PHY 104us
+ *        - 键盘 8B:   LL 载荷 15B，1M PHY 232us / 2M PHY 120us
+ *        - NKRO 29B:  LL 载荷 36B，1M PHY 400us / 2M PHY 204us (超过 27B，依赖数据长度扩展)
+ *        未扩展数据长度时 NKRO 要拆成 27B + 9B 两个 LL 包，多一组包头开销与一次主从往返
+ */
+uint8_t HidEmu_GetKeyReportLen(void)
+{
+    if (hidProtocolMode == HID_PROTOCOL_MODE_REPORT &&
+        HidDev_GetMaxReportLen() >= HID_NKRO_IN_RPT_LEN &&
+        HidDev_IsNotifyEnabled(HID_RPT_ID_NKRO_IN, HID_REPORT_TYPE_INPUT)) {
+        return HID_NKRO_IN_RPT_LEN;
+    }
+    return 8;
 }
 
 /**
@@ -533,7 +887,76 @@ uint8_t HidEmu_SendUSBReport(uint8_t *pData)
  */
 uint8_t HidEmu_SendMouseReport(uint8_t *pData)
 {
-    return HidDev_Report(HID_RPT_ID_MOUSE_IN, HID_REPORT_TYPE_INPUT, 4, pData);
+    return HidEmu_Report(HID_RPT_ID_MOUSE_IN, 4, pData);
+}
+
+#ifdef ENABLE_COMBO_REPORT
+/**
+ * @brief 发送键鼠合并报文 (HID_COMBO_IN_RPT_LEN 字节)
+ * @param pData [Mods, Res, Key1~Key6, Buttons, X, Y, Wheel]
+ * @note  键盘与鼠标同时变化时一个通知送达，省去一个通知 PDU 与缓冲，
+ *        BLE_TX_NUM_EVENT = 1 时还省去一个连接事件
+ */
+uint8_t HidEmu_SendComboReport(uint8_t *pData)
+{
+    uint8_t status = HidEmu_Report(HID_RPT_ID_COMBO_IN, HID_COMBO_IN_RPT_LEN, pData);
+    if (status == SUCCESS) {
+        Power_ReportFirstKey();
+    }
+    return status;
+}
+
+/**
+ * @brief 当前连接能否使用键鼠合并报文 (报告协议、主机已订阅、单包装得下)
+ */
+uint8_t HidEmu_ComboAvailable(void)
+{
+    return (hidProtocolMode == HID_PROTOCOL_MODE_REPORT &&
+            HidDev_GetMaxReportLen() >= HID_COMBO_IN_RPT_LEN &&
+            HidDev_IsNotifyEnabled(HID_RPT_ID_COMBO_IN, HID_REPORT_TYPE_INPUT));
+}
+#endif
+
+/**
+ * @brief 控制器中已发出但主机未确认的数据包数 (发送积压)，未连接时返回 0
+ */
+uint8_t HidEmu_GetBacklog(void)
+{
+    uint32_t unack;
+
+    if (hidEmuConnHandle == GAP_CONNHANDLE_INIT) return 0;
+    unack = LL_GetNumberOfUnAckPacket(hidEmuConnHandle);
+    if (unack == 0xFFFFFFFF) return 0;   // 句柄已失效 (已断开)
+    return (unack > 0xFF) ? 0xFF : (uint8_t)unack;
+}
+
+/**
+ * @brief 是否已与主机建立连接 (未连接时 HidDev_Report 会重新开启广播)
+ */
+uint8_t HidEmu_IsConnected(void)
+{
+    uint8_t gap_state;
+
+    GAPRole_GetParameter(GAPROLE_STATE, &gap_state);
+    return (gap_state == GAPROLE_CONNECTED);
+}
+
+/**
+ * @brief 发送数位笔报文 (HID_ABS_IN_RPT_LEN 字节)
+ * @param pData [开关位, X, Y, 压力]，坐标与压力已缩放到 HID_ABS_XY_MAX / HID_ABS_PRESSURE_MAX
+ */
+uint8_t HidEmu_SendAbsReport(uint8_t *pData)
+{
+    return HidEmu_Report(HID_RPT_ID_ABS_IN, HID_ABS_IN_RPT_LEN, pData);
+}
+
+/**
+ * @brief 发送手柄报文 (HID_GAMEPAD_IN_RPT_LEN 字节)
+ * @param pData [按键 16 bit, 苜蓿键, X, Y, Z, Rx, Ry, Rz]
+ */
+uint8_t HidEmu_SendGamepadReport(uint8_t *pData)
+{
+    return HidEmu_Report(HID_RPT_ID_GAMEPAD_IN, HID_GAMEPAD_IN_RPT_LEN, pData);
 }
 
 /**
@@ -544,13 +967,20 @@ uint8_t HidEmu_ResetIdleTimer(void)
 {
     uint8_t just_wake = FALSE;
 
+    // 0. 主机挂起时按键即远程唤醒，按键照常发送
+    if (is_host_suspended) {
+        HidEmu_ExitHostSuspend();
+    }
+
     // 1. 从软休眠中唤醒
     if (is_ble_sleeping) {
         is_ble_sleeping = FALSE;
         just_wake = TRUE;
+        tmos_stop_task(hidEmuTaskId, HID_SHUTDOWN_EVT);
 
-        uint8_t adv_enable = TRUE;
+        uint8_t adv_enable = HID_ADV_ENABLE;
         GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &adv_enable);
+        RfOut_SetEnable(TRUE);
 
         SYS_LED_ON();
         tmos_start_task(hidEmuTaskId, HID_SYS_LED_OFF_EVT, TIME_SYS_LED_WAKE_FLASH);
@@ -563,8 +993,9 @@ uint8_t HidEmu_ResetIdleTimer(void)
     is_usb_idle = FALSE;
     tmos_start_task(hidEmuTaskId, HID_USB_IDLE_EVT, TIME_USB_IDLE);
 
-    // 4. 立刻拉满 USB 轮询速度
-    tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, TIME_USB_POLL_ACTIVE);
+    // 4. 立刻恢复全速主频并拉满 USB 轮询速度
+    ClkScale_Set(CLK_TIER_FULL);
+    tmos_start_task(hidEmuTaskId, HID_USB_POLL_EVT, USB_Bridge_GetPollTicks());
 
     return just_wake;
 }
\ No newline at end of file
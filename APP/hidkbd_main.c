@@ -13,14 +13,12 @@
 #include "HAL.h"
 #include "hiddev.h"
 #include "hidkbd.h"
+#include "usb_bridge.h"
+#include "usb_device.h"
+#include "rf_output.h"
+#include "power.h"
 #include "debug.h"
 
-// ===================================================================
-// ? 外部引用 (External References)
-// ===================================================================
-extern void USB_Bridge_Init(void);
-extern void USB_Bridge_Poll(void);
-
 // ===================================================================
 // ? 全局内存配置 (Memory Config)
 // ===================================================================
@@ -58,6 +56,9 @@ int main(void)
     // 1. 基础硬件与时钟初始化
     // ----------------------------------------------------------------
     
+    // 记录复位原因与唤醒时刻 (深度关机唤醒即复位，计时从此处开始)
+    Power_Init();
+
     // DCDC 电源配置 (降低功耗)
 #if(defined(DCDC_ENABLE)) && (DCDC_ENABLE == TRUE)
     PWR_DCDCCfg(ENABLE); 
@@ -67,6 +68,7 @@ int main(void)
     
     // 设置系统主频为 60MHz
     // 推荐 60MHz 而非 48MHz，因为 USB Host 需要较快的响应速度处理中断
+    // 空闲/软休眠层级运行时由 clk_scale.c 降为 HSE 分频，有输入时恢复 60MHz
     SetSysClock(CLK_SOURCE_PLL_60MHz);
 
     // ----------------------------------------------------------------
@@ -92,10 +94,22 @@ int main(void)
     // ----------------------------------------------------------------
     LOG_SYS("[Init] BLE Stack...\n");
     CH58X_BLEInit();            // 库文件初始化
+    Power_BeforeHalInit();      // HAL_Init 重置 RTC，冷恢复计时改由 TMOS 时钟接续
     HAL_Init();                 // 硬件抽象层初始化
+    Power_AfterHalInit();
+#if defined(ENABLE_RF_LINK) && defined(RF_LINK_DONGLE)
+    // 2.4G 接收器：只有射频与 USB 设备口，收到的报文直接转发给电脑
+    RF_RoleInit();
+    UsbDev_Init();
+    RfOut_Init();
+#else
     GAPRole_PeripheralInit();   // 角色初始化
     HidDev_Init();              // HID 服务层初始化
     HidEmu_Init();              // 用户应用层 (键盘逻辑) 初始化
+#ifdef ENABLE_RF_LINK
+    RF_RoleInit();              // 2.4G 输出：广播保持关闭，射频由私有链路独占
+    RfOut_Init();
+#endif
 
     // ----------------------------------------------------------------
     // 5. USB Host 初始化 (Critical)
@@ -103,6 +117,7 @@ int main(void)
     // 务必放在 BLE 初始化之后，避免 USB 初始化的延时影响 BLE 时序
     LOG_SYS("[Init] USB Host...\n");
     USB_Bridge_Init(); 
+#endif
 
     // ----------------------------------------------------------------
     // 6. 看门狗配置 (System Safety)
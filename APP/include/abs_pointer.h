@@ -0,0 +1,29 @@
+/*********************************************************************
+ * File Name          : abs_pointer.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 绝对坐标指针 / 数位板解码头文件
+ *                      - 鼠标类设备首次出现时读取其报告描述符，识别绝对坐标 X/Y、压力与笔开关
+ *                      - 识别成功后该设备的中断数据按描述符解码为数位笔报文，不再走鼠标长度猜测
+ *********************************************************************/
+
+#ifndef ABS_POINTER_H
+#define ABS_POINTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void     AbsPtr_Reset(void);
+extern void     AbsPtr_Attach(uint8_t hub_port);
+extern uint8_t  AbsPtr_IsActive(void);
+extern uint16_t AbsPtr_GetPollTicks(void);
+extern uint8_t  AbsPtr_Decode(const uint8_t *buf, uint8_t len, uint8_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ABS_POINTER_H */
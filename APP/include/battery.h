@@ -0,0 +1,29 @@
+/*********************************************************************
+ * File Name          : battery.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 电池电量子系统头文件
+ *                      - 统一持有 ADC，单一采样调度
+ *                      - 同时服务 Battery Service 与低电量指示
+ *********************************************************************/
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void    Battery_Init(void);
+extern uint8_t Battery_Update(void);
+extern void    Battery_ForceNotify(void);
+extern uint8_t Battery_GetLevel(void);
+extern uint8_t Battery_IsLow(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BATTERY_H */
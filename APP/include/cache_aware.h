@@ -0,0 +1,31 @@
+/*********************************************************************
+ * File Name          : cache_aware.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 已绑定主机的 GATT 缓存同步状态头文件
+ *                      - 按主机记录最后同步的数据库摘要
+ *                      - 摘要变化 (固件更新改变了数据库) 时回连发送 Service Changed
+ *                      - 统计回连后首个报文耗时
+ *********************************************************************/
+
+#ifndef CACHE_AWARE_H
+#define CACHE_AWARE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void CacheAware_Init(uint8_t taskId);
+extern void CacheAware_OnConnected(uint16_t connHandle, const uint8_t *addr, uint16_t connInterval);
+extern void CacheAware_OnPairState(uint16_t connHandle, uint8_t state, uint8_t status);
+extern void CacheAware_OnIndConfirm(uint16_t connHandle);
+extern void CacheAware_OnReport(void);
+extern void CacheAware_OnDisconnected(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CACHE_AWARE_H */
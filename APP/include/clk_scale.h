@@ -0,0 +1,33 @@
+/*********************************************************************
+ * File Name          : clk_scale.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 系统主频动态调节头文件
+ *                      - 按活动层级切换主频：输入中 PLL 60MHz，空闲/软休眠降为 HSE 分频
+ *                      - PLL 始终保持上电 (USB 时钟来源)，升频只需改分频寄存器
+ *********************************************************************/
+
+#ifndef CLK_SCALE_H
+#define CLK_SCALE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 主频层级 (与 hidkbd.c 的 USB 轮询层级对应)
+// ===================================================================
+#define CLK_TIER_FULL             0     // 正在输入 / 有线输出 / 枚举
+#define CLK_TIER_IDLE             1     // USB 空闲降频、主机挂起
+#define CLK_TIER_SLEEP            2     // 软休眠 (蓝牙关闭)
+#define CLK_TIER_NUM              3
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void ClkScale_Set(uint8_t tier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLK_SCALE_H */
@@ -0,0 +1,45 @@
+/*********************************************************************
+ * File Name          : conn_trace.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 连接事件时间线头文件 (DEBUG_CONN_TRACE)
+ *                      - 通过 LL_ConnectEventRegister / LL_AdvertiseEventRegister 为每个
+ *                        射频事件打 32K 时间戳，与 USB 输入、通知提交一起记入 RAM 环形区
+ *                      - 统计实际连接间隔、缺失事件、每个事件带走的通知数、提交到空中的延迟
+ *                      - 未定义 DEBUG_CONN_TRACE 时宏展开为空，无任何开销
+ *********************************************************************/
+
+#ifndef CONN_TRACE_H
+#define CONN_TRACE_H
+
+#include "debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DEBUG_CONN_TRACE
+
+    // ===================================================================
+    // 对外接口声明 (Public API)
+    // ===================================================================
+    extern void ConnTrace_Init(void);
+    extern void ConnTrace_SetConn(uint16_t connHandle, uint16_t interval, uint16_t latency);
+    extern void ConnTrace_Input(void);
+    extern void ConnTrace_Submit(uint8_t rpt_id);
+    extern void ConnTrace_Dump(void);
+
+#else
+
+    #define ConnTrace_Init()                            do{}while(0)
+    #define ConnTrace_SetConn(connHandle, interval, latency) do{}while(0)
+    #define ConnTrace_Input()                           do{}while(0)
+    #define ConnTrace_Submit(rpt_id)                    do{}while(0)
+    #define ConnTrace_Dump()                            do{}while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONN_TRACE_H */
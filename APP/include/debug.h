@@ -20,6 +20,10 @@ extern "C" {
 // #define DEBUG_BATT    // 启用电池电压日志
 // #define DEBUG_KEY     // 启用键盘按键矩阵日志
 // #define DEBUG_MOUSE   // 启用鼠标坐标日志
+// #define DEBUG_EVT_MON // 启用 TMOS 事件耗时监控 (双击 USER 键输出统计表)
+// #define DEBUG_USB_CAPTURE // 启用 USB 中断 IN 抓包到 data flash (长按 USER 键输出)
+// #define DEBUG_SYNTH_INPUT // 测试模式：合成键盘/鼠标输入替代 USB 数据源，统计蓝牙发送吞吐
+// #define DEBUG_CONN_TRACE // 启用连接事件时间线 (双击 USER 键输出统计与时间线)
 // #define ENABLE_LED    // 启用 LED 指示灯 (关闭可省电)
 
 // ============================================================
@@ -27,7 +31,9 @@ extern "C" {
 // 只要开启了任意一个日志功能，就自动定义 DEBUG_ENABLED
 // ============================================================
 #if defined(DEBUG_SYS) || defined(DEBUG_USB) || defined(DEBUG_BLE)  || \
-    defined(DEBUG_BATT)|| defined(DEBUG_KEY) || defined(DEBUG_MOUSE)
+    defined(DEBUG_BATT)|| defined(DEBUG_KEY) || defined(DEBUG_MOUSE) || \
+    defined(DEBUG_EVT_MON) || defined(DEBUG_USB_CAPTURE) || defined(DEBUG_SYNTH_INPUT) || \
+    defined(DEBUG_CONN_TRACE)
     
     #ifndef DEBUG_ENABLED
         #define DEBUG_ENABLED  1  // 用于 main.c 判断是否初始化 UART1
@@ -100,13 +106,21 @@ extern "C" {
 // 硬件初始化宏 (放在 main.c 的 GPIO 初始化部分)
 #ifdef ENABLE_LED
 
-    #define SYS_LED_ON()             GPIOA_ResetBits(SYS_LED_PIN)
-    #define SYS_LED_OFF()            GPIOA_SetBits(SYS_LED_PIN)
-    #define SYS_LED_TOGGLE()         GPIOA_InverseBits(SYS_LED_PIN)
+    // 统一由 HAL LED 引擎驱动 (HAL/LED.c, LED1 = SYS, LED2 = BLE)
+    // ON/OFF 会同时取消正在进行的闪烁；闪烁由 HAL 任务按需唤醒，只在亮/灭沿执行
+    #include "LED.h"
 
-    #define BLE_LED_ON()             GPIOA_ResetBits(BLE_LED_PIN)
-    #define BLE_LED_OFF()            GPIOA_SetBits(BLE_LED_PIN)
-    #define BLE_LED_TOGGLE()         GPIOA_InverseBits(BLE_LED_PIN)
+    #define LED_BLINK_DUTY           HAL_LED_DEFAULT_DUTY_CYCLE  // 闪烁占空比 (%)，低占空比省电
+
+    #define SYS_LED_ON()             HalLedSet(HAL_LED_1, HAL_LED_MODE_ON)
+    #define SYS_LED_OFF()            HalLedSet(HAL_LED_1, HAL_LED_MODE_OFF)
+    #define SYS_LED_TOGGLE()         HalLedSet(HAL_LED_1, HAL_LED_MODE_TOGGLE)
+    #define SYS_LED_BLINK(ms)        HalLedBlink(HAL_LED_1, 0, LED_BLINK_DUTY, (ms))
+
+    #define BLE_LED_ON()             HalLedSet(HAL_LED_2, HAL_LED_MODE_ON)
+    #define BLE_LED_OFF()            HalLedSet(HAL_LED_2, HAL_LED_MODE_OFF)
+    #define BLE_LED_TOGGLE()         HalLedSet(HAL_LED_2, HAL_LED_MODE_TOGGLE)
+    #define BLE_LED_BLINK(ms)        HalLedBlink(HAL_LED_2, 0, LED_BLINK_DUTY, (ms))
 
 #else
 
@@ -114,10 +128,12 @@ extern "C" {
     #define SYS_LED_ON()             do{}while(0)
     #define SYS_LED_OFF()            do{}while(0)
     #define SYS_LED_TOGGLE()         do{}while(0)
+    #define SYS_LED_BLINK(ms)        do{}while(0)
 
     #define BLE_LED_ON()             do{}while(0)
     #define BLE_LED_OFF()            do{}while(0)
     #define BLE_LED_TOGGLE()         do{}while(0)
+    #define BLE_LED_BLINK(ms)        do{}while(0)
 
 #endif
 
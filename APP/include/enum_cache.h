@@ -0,0 +1,28 @@
+/*********************************************************************
+ * File Name          : enum_cache.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 枚举结果缓存头文件
+ *                      - 按 VID/PID/bcdDevice 缓存根端口 HID 设备的配置解析结果
+ *                      - 重新插入命中缓存时只发送改变设备状态的必要请求
+ *********************************************************************/
+
+#ifndef ENUM_CACHE_H
+#define ENUM_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void    EnumCache_Init(void);
+extern uint8_t EnumCache_HasEntry(void);
+extern uint8_t EnumCache_FastInit(void);
+extern void    EnumCache_Learn(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENUM_CACHE_H */
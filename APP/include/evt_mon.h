@@ -0,0 +1,63 @@
+/*********************************************************************
+ * File Name          : evt_mon.h
+ * Author             : DIY User & AI Assistant
+ * Description        : TMOS 事件耗时监控头文件
+ *                      - 在任务注册处包一层计时函数，按 (任务, 事件位) 统计耗时
+ *                      - 未定义 DEBUG_EVT_MON 时宏展开为原处理函数，无任何开销
+ *********************************************************************/
+
+#ifndef EVT_MON_H
+#define EVT_MON_H
+
+#include "debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 被监控的任务槽位
+// ===================================================================
+#define EVT_MON_TASK_HAL          0
+#define EVT_MON_TASK_HIDDEV       1
+#define EVT_MON_TASK_HIDEMU       2
+#define EVT_MON_TASK_USERKEY      3
+#define EVT_MON_TASK_TXPWR        4
+#define EVT_MON_TASK_RFOUT        5
+#define EVT_MON_TASK_NUM          6
+
+#ifdef DEBUG_EVT_MON
+
+    // 时间戳：SysTick 自由运行计数器低 32 位 (HCLK 周期)
+    #define EVT_MON_NOW()         (*(volatile uint32_t *)&SysTick->CNT)
+
+    extern void EvtMon_SetClock(uint32_t sys_clk);
+    extern void EvtMon_Record(uint8_t task, tmosEvents done, uint32_t cycles);
+    extern void EvtMon_Dump(void);
+
+    // 生成 fn##_Mon 包装：进出各取一次时间戳，按本次处理掉的事件位记录
+    // 用法：在处理函数声明之后、注册之前写 EVT_MON_DEFINE(fn, 槽位)
+    #define EVT_MON_DEFINE(fn, task)                                    \
+        static tmosEvents fn##_Mon(tmosTaskID task_id, tmosEvents events) \
+        {                                                               \
+            uint32_t   t0   = EVT_MON_NOW();                            \
+            tmosEvents left = fn(task_id, events);                      \
+            EvtMon_Record((task), events & ~left, EVT_MON_NOW() - t0);  \
+            return left;                                                \
+        }
+    #define EVT_MON_FN(fn)        fn##_Mon
+
+#else
+
+    #define EVT_MON_DEFINE(fn, task)
+    #define EVT_MON_FN(fn)        fn
+    #define EvtMon_SetClock(sys_clk) do{}while(0)
+    #define EvtMon_Dump()         do{}while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVT_MON_H */
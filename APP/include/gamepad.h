@@ -0,0 +1,37 @@
+/*********************************************************************
+ * File Name          : gamepad.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 游戏手柄 / 摇杆解码头文件
+ *                      - 官方库不认接口协议为 0 的 HID 设备，枚举失败后由本模块按报告描述符接管
+ *                      - 解码为 BLE 手柄报文：16 键 + 苜蓿键 + 6 轴，轴带死区，变化小于阈值不上报
+ *********************************************************************/
+
+#ifndef GAMEPAD_H
+#define GAMEPAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 接管后的设备类型 (与库中 DEV_TYPE_KEYBOARD/MOUSE 同一编码方式)
+#define DEV_TYPE_GAMEPAD          (USB_DEV_CLASS_HID | 0x40)
+
+// Gamepad_Compare 返回值
+#define GAMEPAD_CHG_NONE          0       // 无变化或轴变化小于阈值
+#define GAMEPAD_CHG_AXIS          1       // 轴变化超过阈值，可按连接间隔合并
+#define GAMEPAD_CHG_BUTTON        2       // 按键/苜蓿键变化，应立即发送
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern uint8_t  Gamepad_Claim(uint8_t hub_port);
+extern uint16_t Gamepad_GetPollTicks(void);
+extern uint8_t  Gamepad_Decode(const uint8_t *buf, uint8_t len, uint8_t *report);
+extern uint8_t  Gamepad_Compare(const uint8_t *sent, const uint8_t *now);
+extern void     Gamepad_Neutral(uint8_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GAMEPAD_H */
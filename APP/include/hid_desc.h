@@ -0,0 +1,63 @@
+/*********************************************************************
+ * File Name          : hid_desc.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB HID 报告描述符读取与解析头文件
+ *                      - 官方库只读报告描述符前 65 字节且不解析，按接口协议区分键盘/鼠标
+ *                      - 绝对坐标指针、游戏手柄等按描述符定位字段 (位偏移、位宽、逻辑范围)
+ *********************************************************************/
+
+#ifndef HID_DESC_H
+#define HID_DESC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 用法 (页 << 16 | 用法 ID)
+#define HID_USAGE(page, id)       (((uint32_t)(page) << 16) | (id))
+
+// 顶层应用集合不限
+#define HID_APP_ANY               0
+
+// 输入条目标志 (HID 1.11 6.2.2.5)
+#define HID_INPUT_CONSTANT        0x01
+#define HID_INPUT_VARIABLE        0x02
+#define HID_INPUT_RELATIVE        0x04
+#define HID_INPUT_NULL_STATE      0x40
+
+// 第一个 HID 接口的信息 (配置描述符中取得)
+typedef struct {
+    uint8_t  iface;         // 接口号
+    uint8_t  subclass;      // 1 = 支持 Boot 协议
+    uint8_t  protocol;      // 1 = 键盘，2 = 鼠标，0 = 其他
+    uint8_t  interval;      // 第一个中断 IN 端点的 bInterval (全速/低速单位 ms)
+    uint16_t rpt_len;       // 报告描述符长度
+} HidIfInfo_t;
+
+// 报告中的一个字段 (或一组用法连续、位宽相同的字段，如按键 1~N)
+typedef struct {
+    uint16_t pos;           // 报文内位偏移 (不含报告 ID 字节)
+    uint8_t  size;          // 位宽，0 = 设备无此字段
+    uint8_t  count;         // 连续用法个数
+    uint8_t  flags;         // 输入条目标志
+    int32_t  lmin;          // 逻辑范围
+    int32_t  lmax;
+} HidField_t;
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern uint8_t  HidDesc_ReadConfig(HidIfInfo_t *info);
+extern uint8_t *HidDesc_ReadReport(const HidIfInfo_t *info, uint8_t *len);
+extern int16_t  HidDesc_FindAbsInput(const uint8_t *desc, uint16_t len, uint32_t app, uint32_t usage);
+extern void     HidDesc_MapInput(const uint8_t *desc, uint16_t len, uint8_t rpt_id,
+                                 const uint32_t *usages, uint8_t num, HidField_t *fields);
+extern int32_t  HidDesc_GetValue(const HidField_t *fd, uint8_t idx, const uint8_t *buf, uint8_t len);
+extern uint32_t HidDesc_ScaleQ16(const HidField_t *fd, uint16_t out_max);
+extern uint16_t HidDesc_Scale(const HidField_t *fd, uint32_t scale, int32_t value, uint16_t out_max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HID_DESC_H */
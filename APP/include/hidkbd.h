@@ -20,11 +20,9 @@ extern "C" {
 #define START_PARAM_UPDATE_EVT    0x0004  // 连接参数更新请求
 #define START_PHY_UPDATE_EVT      0x0008  // PHY 速率更新请求
 #define START_BATT_READ_EVT       0x0010  // 触发一次电量检测
+#define HID_SHUTDOWN_EVT          0x0020  // 深度关机超时事件
 #define HID_SYS_LED_OFF_EVT       0x0100  // SYS 灯定时熄灭
-#define HID_SYS_LED_BLINK_EVT     0x0200  // SYS 灯低电量闪烁
 #define HID_BLE_LED_OFF_EVT       0x0400  // BLE 灯定时熄灭
-#define HID_BLE_LED_BLINK_EVT     0x0800  // BLE 灯广播闪烁
-#define HID_USER_KEY_POLL_EVT     0x1000  // 用户按键轮询
 #define HID_SLEEP_TIMEOUT_EVT     0x2000  // 软休眠超时事件
 #define HID_USB_POLL_EVT          0x4000  // USB 数据轮询
 #define HID_USB_IDLE_EVT          0x8000  // USB 空闲降频超时
@@ -39,18 +37,26 @@ extern "C" {
 #define TIME_SYS_LED_STARTUP      (TICKS_PER_SEC * 10)  // 上电 SYS 灯点亮: 10秒
 #define TIME_BLE_LED_CONNECTED    (TICKS_PER_SEC * 10)  // 连接后 BLE 灯点亮: 10秒
 #define TIME_SYS_LED_WAKE_FLASH   (TICKS_PER_SEC * 1)   // 唤醒时 SYS 灯闪亮: 1秒
-#define TIME_BLE_LED_BLINK        800UL                  // BLE 广播闪烁周期: 0.5秒
-#define TIME_SYS_LED_BLINK        (TICKS_PER_SEC * 1)   // 低电量 SYS 闪烁周期: 1秒
+#define TIME_BLE_LED_BLINK_MS     1000                  // BLE 广播闪烁周期 (毫秒, HAL LED 引擎调度)
+#define TIME_SYS_LED_BLINK_MS     2000                  // 低电量 SYS 闪烁周期 (毫秒, HAL LED 引擎调度)
 
-// --- 按键与轮询 ---
-#define TIME_KEY_POLL             160UL   // 按键轮询间隔: 100ms
-#define TIME_USB_POLL_ACTIVE      2UL     // USB 全速轮询: ~1.25ms
+// --- USER 按键 (中断驱动，仅在按键动作后计时) ---
+#define TIME_KEY_DEBOUNCE         32UL    // 去抖时间: 20ms
+#define TIME_KEY_LONG_PRESS       (TICKS_PER_SEC * 2)  // 长按判定: 2秒
+#define TIME_KEY_PAIRING_PRESS    (TICKS_PER_SEC * 6)  // 超长按判定 (配对模式): 6秒
+#define TIME_KEY_DOUBLE_WINDOW    480UL   // 双击等待窗口: 300ms
+
+// --- USB 轮询 ---
+#define TIME_USB_POLL_ACTIVE      2UL     // USB 全速轮询下限: ~1.25ms (实际周期随连接间隔派生)
 #define TIME_USB_POLL_IDLE        80UL    // USB 降速轮询: 50ms
 #define TIME_USB_POLL_SLEEP       800UL   // USB 休眠轮询: 500ms
+#define TIME_USB_POLL_SUSPEND     160UL   // 主机挂起时 USB 唤醒检测轮询: 100ms
+#define TIME_USB_POLL_WIRED       1UL     // 有线输出时 USB 轮询: ~0.625ms (设备口端点 1ms 取一次)
 
 // --- 电源管理 ---
 #define TIME_SLEEP_TIMEOUT        (TICKS_PER_SEC * 60 * 10)  // 软休眠超时: 10分钟
 #define TIME_USB_IDLE             (TICKS_PER_SEC * 30)       // USB 空闲降频: 30秒
+#define TIME_SHUTDOWN_TIMEOUT     (TICKS_PER_SEC * 60 * 60 * 2)  // 软休眠后进入深度关机: 2小时
 
 // --- 电量检测 ---
 #define TIME_BATT_BOOT_DELAY      (TICKS_PER_SEC * 2)   // 上电首次检测延迟: 2秒
@@ -59,11 +65,17 @@ extern "C" {
 
 // --- 连接参数 ---
 #define TIME_PARAM_UPDATE_DELAY   12800UL  // 连接参数更新延迟
+#define TIME_PARAM_RETRY_BASE     (TICKS_PER_SEC * 30)  // 参数被拒后重试基准间隔: 30秒，每次翻倍
+
+// --- 发射功率自适应 ---
+#define TIME_TXPWR_RSSI_INTERVAL  (TICKS_PER_SEC * 1)   // 连接期间 RSSI 读取周期: 1秒
 
 // ===================================================================
 // 业务阈值配置
 // ===================================================================
 #define BATT_LOW_THRESHOLD        15  // 低电量警告阈值 (%)
+#define BATT_LOW_HYSTERESIS       3   // 低电量解除迟滞 (%)，高于 阈值+迟滞 才熄灭警告
+#define BATT_REPORT_HYSTERESIS    2   // 电量上报迟滞 (%)，变化小于该值不通知主机
 
 // ===================================================================
 // 对外接口声明 (Public API)
@@ -0,0 +1,30 @@
+/*********************************************************************
+ * File Name          : power.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 电源管理头文件
+ *                      - 深度关机 (Shutdown) 层级：唤醒源配置与进入
+ *                      - 冷恢复识别与唤醒到首个按键的耗时统计
+ *********************************************************************/
+
+#ifndef POWER_H
+#define POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void    Power_Init(void);
+extern void    Power_BeforeHalInit(void);
+extern void    Power_AfterHalInit(void);
+extern uint8_t Power_IsColdResume(void);
+extern void    Power_EnterShutdown(void);
+extern void    Power_ReportFirstKey(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POWER_H */
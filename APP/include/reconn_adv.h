@@ -0,0 +1,33 @@
+/*********************************************************************
+ * File Name          : reconn_adv.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 按主机扫描参数调整回连广播头文件
+ *                      - 记录每个主机通过 Scan Parameters 服务写入的扫描间隔/窗口
+ *                      - 回连广播间隔与高占空比时长按最近连接主机的扫描节奏推导
+ *                      - 统计每种策略的回连耗时与广播事件数
+ *                      - 统计开放/白名单广播期间被接受的扫描请求数 (DEBUG_BLE)
+ *********************************************************************/
+
+#ifndef RECONN_ADV_H
+#define RECONN_ADV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void ReconnAdv_Init(void);
+extern void ReconnAdv_OnConnected(uint8_t addrType, const uint8_t *addr);
+extern void ReconnAdv_OnDisconnected(void);
+extern void ReconnAdv_OnScanParam(uint16_t connHandle, uint16_t scanInterval, uint16_t scanWindow);
+extern void ReconnAdv_OnAdvStart(void);
+extern void ReconnAdv_OnAdvStop(void);
+extern void ReconnAdv_UseLowDuty(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RECONN_ADV_H */
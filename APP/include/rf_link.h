@@ -0,0 +1,138 @@
+/*********************************************************************
+ * File Name          : rf_link.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 2.4G 私有链路协议核心头文件 (与平台无关)
+ *                      - 1ms 时隙，每个时隙按种子生成的跳频表换一个信道
+ *                      - 帧头携带时隙号，接收端据此对齐跳频相位，失步后驻留单信道重新捕获
+ *                      - 停等 ARQ：每帧一个 ACK，未确认则下一时隙 (另一信道) 重传
+ *                      - 8 位序号去重，报文均为状态量，重复投递无副作用
+ *                      - 只依赖 stdint / string，固件 (rf_output.c) 与主机模拟器
+ *                        (Tools/rf_link_sim.c) 共用同一份代码
+ *********************************************************************/
+
+#ifndef RF_LINK_H
+#define RF_LINK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 协议参数
+// ===================================================================
+#define RFL_HOP_NUM               16      // 跳频表长度 (时隙号对其取模)
+#define RFL_CHANNEL_NUM           37      // 可用信道 0~36 (避开 37/38/39 广播信道)
+#define RFL_QUEUE_MAX             8       // 发送端待确认报文队列深度
+#define RFL_PAYLOAD_MAX           8       // 最长载荷 (标准键盘报文)
+#define RFL_HDR_LEN               3       // 帧头: [类型] [序号] [时隙号]
+#define RFL_FRAME_MAX             (RFL_HDR_LEN + RFL_PAYLOAD_MAX)
+#define RFL_ACK_LEN               2       // ACK: [RFL_TYPE_ACK] [时隙号]
+
+#define RFL_RETRY_MAX             32      // 键盘报文重传上限 (之后若更新的键盘状态已包含它的按键沿则放弃)
+#define RFL_KEEPALIVE_SLOTS       100     // 发送端空闲时的保活帧间隔 (时隙)
+#define RFL_LINK_TIMEOUT          500     // 超过此时隙数未收到 ACK 视为链路断开
+#define RFL_SYNC_LOSS             250     // 接收端连续静默时隙数达到此值进入失步捕获
+#define RFL_LOST_DWELL            256     // 失步时在单信道驻留的时隙数 (覆盖发送端一轮保活重传)
+
+// 角色
+#define RFL_ROLE_DEVICE           0       // 适配器：发送输入报文，等待 ACK
+#define RFL_ROLE_DONGLE           1       // 接收器：接收报文，回 ACK 并投递到 USB
+
+// 帧类型
+#define RFL_TYPE_KEEPALIVE        0
+#define RFL_TYPE_KBD              1       // 8 字节 Boot 键盘报文
+#define RFL_TYPE_MOUSE            2       // 4 字节鼠标报文 [Btn, X, Y, Wheel]
+#define RFL_TYPE_ACK              0x0F
+
+// 返回值
+#define RFL_OK                    0
+#define RFL_ERR_FULL              1       // 队列已满 (调用方保留报文稍后重试)
+#define RFL_ERR_PARAM             2
+
+// ===================================================================
+// 数据结构
+// ===================================================================
+typedef struct {
+    uint32_t submitted;    // 入队报文数
+    uint32_t acked;        // 已确认报文数
+    uint32_t superseded;   // 重传超限且按键沿已包含在更新状态中而放弃的报文
+    uint32_t frames_tx;    // 发出的帧 (含重传与保活)
+    uint32_t retrans;      // 重传帧
+    uint32_t keepalives;   // 保活帧
+    uint32_t lat_sum;      // 入队到确认的时隙数累计
+    uint32_t lat_max;
+    uint32_t lat_hist[4];  // 1 / 2 / 3~4 / 5+ 时隙
+    uint32_t frames_rx;    // 接收端收到的有效帧
+    uint32_t delivered;    // 接收端投递的报文
+    uint32_t duplicates;   // 接收端丢弃的重复帧
+    uint32_t resyncs;      // 接收端失步后重新捕获次数
+} RfLinkStat_t;
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  len;
+    uint8_t  seq;
+    uint8_t  retries;
+    uint32_t submit_slot;
+    uint8_t  data[RFL_PAYLOAD_MAX];
+} RfLinkEntry_t;
+
+typedef struct {
+    uint8_t  role;
+    uint8_t  hop[RFL_HOP_NUM];     // 跳频表 (信道号)
+    uint8_t  slot;                 // 当前时隙号 (取模 256，与帧头一致)
+    uint32_t clock;                // 本端时隙计数 (统计用，不上空)
+
+    // 发送端
+    RfLinkEntry_t queue[RFL_QUEUE_MAX];
+    uint8_t  q_head;
+    uint8_t  q_count;
+    uint8_t  tx_seq;               // 下一条新报文的序号
+    uint8_t  in_flight;            // 本时隙发出的帧类型 (0xFF = 未发送)
+    uint8_t  acked;                // 本时隙已收到 ACK
+    uint8_t  ka_retries;           // 保活帧连续未确认次数
+    uint8_t  ack_valid;            // 曾收到过 ACK
+    uint32_t last_tx;              // 上次发帧的时隙计数
+    uint32_t last_ack;             // 上次收到 ACK 的时隙计数
+    uint8_t  kbd_acked[RFL_PAYLOAD_MAX]; // 接收端最近确认的键盘状态 (放弃判断基准)
+
+    // 接收端
+    uint8_t  rx_seq;               // 最近投递的序号
+    uint8_t  rx_seq_valid;
+    uint8_t  lost;                 // 失步捕获中
+    uint8_t  park;                 // 失步时驻留的跳频表下标
+    uint16_t dwell;                // 在驻留信道上已等待的时隙数
+    uint16_t silent;               // 连续未收到帧的时隙数
+
+    RfLinkStat_t stat;
+} RfLink_t;
+
+// 接收端投递回调: 类型、载荷、长度
+typedef void (*RfLinkDeliverCB_t)(uint8_t type, const uint8_t *data, uint8_t len);
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void    RfLink_Init(RfLink_t *l, uint8_t role, uint32_t seed);
+extern uint8_t RfLink_Channel(const RfLink_t *l);
+extern void    RfLink_Tick(RfLink_t *l);
+extern uint8_t RfLink_IsUp(const RfLink_t *l);
+
+// 发送端 (适配器)
+extern uint8_t RfLink_Submit(RfLink_t *l, uint8_t type, const uint8_t *data, uint8_t len);
+extern uint8_t RfLink_QueueDepth(const RfLink_t *l);
+extern uint8_t RfLink_Pending(const RfLink_t *l, uint8_t type);
+extern uint8_t RfLink_BuildFrame(RfLink_t *l, uint8_t *frame);
+extern void    RfLink_OnAck(RfLink_t *l, const uint8_t *ack, uint8_t len);
+
+// 接收端 (接收器)
+extern uint8_t RfLink_OnFrame(RfLink_t *l, const uint8_t *frame, uint8_t len,
+                              uint8_t *ack, RfLinkDeliverCB_t deliver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_LINK_H */
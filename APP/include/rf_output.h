@@ -0,0 +1,43 @@
+/*********************************************************************
+ * File Name          : rf_output.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 2.4G 私有链路输出头文件 (ENABLE_RF_LINK)
+ *                      - 适配器：键盘/鼠标报文经 rf_link.c 协议发给另一块 CH58x 接收器，
+ *                        取代蓝牙输出 (不广播，射频由本模块独占)
+ *                      - 接收器 (另定义 RF_LINK_DONGLE)：收到的报文经 USB 设备口转发给电脑
+ *                      - 未定义 ENABLE_RF_LINK 时宏展开为空，无任何开销
+ *********************************************************************/
+
+#ifndef RF_OUTPUT_H
+#define RF_OUTPUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ENABLE_RF_LINK
+
+    // ===================================================================
+    // 对外接口声明 (Public API)
+    // ===================================================================
+    extern void    RfOut_Init(void);
+    extern void    RfOut_SetEnable(uint8_t enable);
+    extern uint8_t RfOut_IsActive(void);
+    extern uint8_t RfOut_SendKeyboard(uint8_t *report);
+    extern uint8_t RfOut_SendMouse(uint8_t *report);
+    extern void    RfOut_Dump(void);
+
+#else
+
+    #define RfOut_Init()                do{}while(0)
+    #define RfOut_SetEnable(enable)     do{}while(0)
+    #define RfOut_IsActive()            0
+    #define RfOut_Dump()                do{}while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RF_OUTPUT_H */
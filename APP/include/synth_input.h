@@ -0,0 +1,62 @@
+/*********************************************************************
+ * File Name          : synth_input.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 合成输入生成器头文件 (DEBUG_SYNTH_INPUT 测试模式)
+ *                      - 按预设的速率/突发模式生成按键沿与鼠标位移，替代 USB 数据源
+ *                      - 统计实际发送速率、发送失败重试、队列深度，按连接参数分段输出
+ *                      - 未定义 DEBUG_SYNTH_INPUT 时统计宏展开为空，无任何开销
+ *********************************************************************/
+
+#ifndef SYNTH_INPUT_H
+#define SYNTH_INPUT_H
+
+#include "debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 统计项 (由桥接层发送路径上报)
+// ===================================================================
+#define SYNTH_KEY_SENT            0     // 键盘报文被协议栈接受
+#define SYNTH_KEY_RETRY           1     // 键盘报文发送失败 (留在队列重发)
+#define SYNTH_KEY_DROP            2     // 队列满覆写队尾
+#define SYNTH_MOUSE_SENT          3     // 鼠标报文被协议栈接受
+#define SYNTH_MOUSE_RETRY         4     // 鼠标报文发送失败 (保留累计位移重发)
+#define SYNTH_COMBO_SENT          5     // 键盘报文以键鼠合并报文发出 (已计入 SYNTH_KEY_SENT)
+#define SYNTH_KEY_MERGE           6     // 排队的只含释放的中间状态被新报文合并
+#define SYNTH_BACKLOG_HOLD        7     // 新报文因控制器积压留在桥接层 (按报文计，不按轮询计)
+#define SYNTH_STAT_NUM            8
+
+// SynthIn_Poll 返回值
+#define SYNTH_HAS_KEY             0x01
+#define SYNTH_HAS_MOUSE           0x02
+
+#ifdef DEBUG_SYNTH_INPUT
+
+    // ===================================================================
+    // 对外接口声明 (Public API)
+    // ===================================================================
+    extern uint8_t SynthIn_Poll(uint8_t *kbd_raw, uint8_t *mouse_data);
+    extern void    SynthIn_Count(uint8_t stat);
+    extern void    SynthIn_QueueDepth(uint8_t depth);
+    extern void    SynthIn_ConnParams(uint16_t connInterval, uint16_t connLatency);
+
+    #define SYNTH_COUNT(stat)                    SynthIn_Count(stat)
+    #define SYNTH_QUEUE(depth)                   SynthIn_QueueDepth(depth)
+    #define SYNTH_CONN_PARAMS(interval, latency) SynthIn_ConnParams(interval, latency)
+
+#else
+
+    #define SYNTH_COUNT(stat)                    do{}while(0)
+    #define SYNTH_QUEUE(depth)                   do{}while(0)
+    #define SYNTH_CONN_PARAMS(interval, latency) do{}while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_INPUT_H */
@@ -0,0 +1,28 @@
+/*********************************************************************
+ * File Name          : tx_power.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 发射功率自适应头文件
+ *                      - 连接期间周期读取 RSSI，带迟滞地升降发射功率
+ *                      - 未应答包数作为链路可靠性反馈
+ *********************************************************************/
+
+#ifndef TX_POWER_H
+#define TX_POWER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void TxPower_Init(void);
+extern void TxPower_Start(uint16_t connHandle);
+extern void TxPower_Stop(void);
+extern void TxPower_OnRssi(uint16_t connHandle, int8_t rssi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TX_POWER_H */
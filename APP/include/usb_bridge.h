@@ -0,0 +1,32 @@
+/*********************************************************************
+ * File Name          : usb_bridge.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB Host 转 Bluetooth 桥接层头文件
+ *                      - 桥接初始化与轮询入口
+ *                      - 连接参数发布接口 (轮询/聚合/队列随连接间隔调整)
+ *                      - 键盘队列深度查询 (延迟探测服务)
+ *                      - 深度关机前的 USB 收尾 (远程唤醒布防)
+ *********************************************************************/
+
+#ifndef USB_BRIDGE_H
+#define USB_BRIDGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void     USB_Bridge_Init(void);
+extern void     USB_Bridge_Poll(void);
+extern void     USB_Bridge_SetConnParams(uint16_t connInterval, uint16_t connLatency);
+extern uint16_t USB_Bridge_GetPollTicks(void);
+extern uint8_t  USB_Bridge_GetQueueDepth(void);
+extern void     USB_Bridge_Shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_BRIDGE_H */
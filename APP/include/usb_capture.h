@@ -0,0 +1,42 @@
+/*********************************************************************
+ * File Name          : usb_capture.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 中断 IN 抓包头文件 (DEBUG_USB_CAPTURE)
+ *                      - 记录每个中断 IN 数据包 (时刻/端口/端点/长度/内容) 到 data flash 环形区
+ *                      - 记录先进 RAM 页缓冲，总线静默时才写 flash，不影响轮询时序
+ *                      - 未定义 DEBUG_USB_CAPTURE 时宏展开为空，无任何开销
+ *********************************************************************/
+
+#ifndef USB_CAPTURE_H
+#define USB_CAPTURE_H
+
+#include "debug.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DEBUG_USB_CAPTURE
+
+    // ===================================================================
+    // 对外接口声明 (Public API)
+    // ===================================================================
+    extern void UsbCap_Init(void);
+    extern void UsbCap_Record(uint8_t port, uint8_t endp, uint8_t *buf, uint8_t len);
+    extern void UsbCap_Idle(void);
+    extern void UsbCap_Dump(void);
+
+#else
+
+    #define UsbCap_Init()                      do{}while(0)
+    #define UsbCap_Record(port, endp, buf, len) do{ (void)(port); }while(0)
+    #define UsbCap_Idle()                      do{}while(0)
+    #define UsbCap_Dump()                      do{}while(0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_CAPTURE_H */
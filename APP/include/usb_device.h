@@ -0,0 +1,29 @@
+/*********************************************************************
+ * File Name          : usb_device.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 设备口 (有线输出) 头文件
+ *                      - USB1 枚举为 Boot 键盘 + 鼠标复合 HID 设备，1ms 中断端点
+ *                      - 设备口被主机配置且未挂起时，桥接层改走有线输出
+ *********************************************************************/
+
+#ifndef USB_DEVICE_H
+#define USB_DEVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void    UsbDev_Init(void);
+extern uint8_t UsbDev_IsActive(void);
+extern uint8_t UsbDev_KeepAwake(void);
+extern uint8_t UsbDev_SendKeyboard(uint8_t *report);
+extern uint8_t UsbDev_SendMouse(uint8_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_DEVICE_H */
@@ -0,0 +1,25 @@
+/*********************************************************************
+ * File Name          : usb_hub.h
+ * Author             : DIY User & AI Assistant
+ * Description        : 外部 HUB 端口维护头文件
+ *                      - 按 HUB 状态变化中断端点的 bInterval 查询，无变化时不产生控制传输
+ *                      - 只对变化位图中置位的端口查询状态
+ *********************************************************************/
+
+#ifndef USB_HUB_H
+#define USB_HUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void UsbHub_Poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_HUB_H */
@@ -0,0 +1,35 @@
+/*********************************************************************
+ * File Name          : user_key.h
+ * Author             : DIY User & AI Assistant
+ * Description        : USER 按键驱动头文件
+ *                      - GPIO 电平中断 + 定时去抖，无周期唤醒
+ *                      - 短按 / 长按 / 超长按 / 双击识别，通过回调上报
+ *********************************************************************/
+
+#ifndef USER_KEY_H
+#define USER_KEY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===================================================================
+// 按键事件 (回调参数)
+// ===================================================================
+#define USER_KEY_SHORT            0x01  // 短按 (双击窗口超时后确认)
+#define USER_KEY_LONG             0x02  // 长按 (按住达到长按时长，松开前即上报)
+#define USER_KEY_DOUBLE           0x03  // 双击
+#define USER_KEY_VERY_LONG        0x04  // 超长按 (长按后继续按住达到超长按时长，松开前即上报)
+
+typedef void (*UserKeyCB_t)(uint8_t keyEvt);
+
+// ===================================================================
+// 对外接口声明 (Public API)
+// ===================================================================
+extern void UserKey_Init(UserKeyCB_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USER_KEY_H */
@@ -0,0 +1,133 @@
+/*********************************************************************
+ * File Name          : power.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 电源管理 - 深度关机层级
+ *                      - 软休眠数小时无操作后进入 Shutdown 下电模式 (RAM 不保持)
+ *                      - 唤醒源：USB 插入 / 数据线跳变 (远程唤醒) / USER 按键
+ *                      - 绑定信息由协议栈保存在 SNV (data flash)，下电不丢失
+ *                      - 唤醒即复位，由复位原因识别冷恢复并统计唤醒到首个按键的耗时
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "HAL.h"
+#include "power.h"
+#include "usb_bridge.h"
+#include "debug.h"
+
+// ===================================================================
+// 硬件引脚配置 (Hardware Config)
+// ===================================================================
+
+// USB2 Host 数据线 (PB13 = UD2+, PB12 = UD2-)
+#define USB2_DATA_PINS       (bU2DP | bU2DM)
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+
+static uint8_t  is_cold_resume   = FALSE;  // 本次上电是否为下电模式唤醒
+static uint8_t  first_key_pending = FALSE; // 冷恢复后尚未送达首个按键
+static uint32_t wake_rtc         = 0;      // 唤醒 (复位) 时刻的 RTC 计数
+static uint32_t boot_ms          = 0;      // 唤醒到 HAL_Init 之前的耗时 (HAL_TimeInit 会重置 RTC)
+static uint32_t hal_tick         = 0;      // HAL_Init 完成时刻的 TMOS 计数
+
+// ===================================================================
+// 初始化
+// ===================================================================
+
+/**
+ * @brief 记录复位原因与唤醒时刻 (main 入口处最先调用，保证计时起点尽量靠前)
+ */
+void Power_Init(void)
+{
+    wake_rtc = RTC_GetCycle32k();
+    is_cold_resume = (SYS_GetLastResetSta() == RST_STATUS_GPWSM);
+    first_key_pending = is_cold_resume;
+}
+
+/**
+ * @brief HAL_Init 之前调用：结算唤醒到此刻的 RTC 耗时 (随后 RTC_InitTime 重置计数)
+ */
+void Power_BeforeHalInit(void)
+{
+    uint32_t now, elapsed;
+
+    now = RTC_GetCycle32k();
+    elapsed = (now >= wake_rtc) ? (now - wake_rtc) : (now + (RTC_TIMER_MAX_VALUE - wake_rtc));
+    boot_ms = (uint32_t)(((uint64_t)elapsed * 1000) / FREQ_RTC);
+}
+
+/**
+ * @brief HAL_Init 之后调用：之后的耗时按 TMOS 时钟计
+ */
+void Power_AfterHalInit(void)
+{
+    hal_tick = TMOS_GetSystemClock();
+}
+
+/**
+ * @brief 本次启动是否为深度关机后的冷恢复
+ */
+uint8_t Power_IsColdResume(void)
+{
+    return is_cold_resume;
+}
+
+// ===================================================================
+// 深度关机
+// ===================================================================
+
+/**
+ * @brief 配置唤醒源并进入 Shutdown 下电模式，不返回 (唤醒后芯片复位)
+ *        - USB 设备先被置为允许远程唤醒，再停止 SOF 使其进入挂起
+ *        - 数据线改为下拉输入 + 上升沿中断：插入 (上拉出现) 与远程唤醒 (K 态) 都会产生上升沿
+ *        - USER 按键保持 user_key.c 布防的电平中断
+ */
+void Power_EnterShutdown(void)
+{
+    uint32_t irq_status;
+
+    LOG_SYS("Enter shutdown\n");
+
+    // 1. USB：允许远程唤醒并释放数据线
+    USB_Bridge_Shutdown();
+    R16_PIN_ANALOG_IE &= ~RB_PIN_USB2_IE;  // 关闭 USB2 模拟收发，改由 GPIO 数字输入检测
+    GPIOB_ModeCfg(USB2_DATA_PINS, GPIO_ModeIN_PD);
+
+    // 2. 指示灯全部熄灭
+    SYS_LED_OFF();
+    BLE_LED_OFF();
+
+#ifdef DEBUG
+    while ((R8_UART1_LSR & RB_LSR_TX_ALL_EMP) == 0) {
+        __nop();  // 等待日志发完
+    }
+#endif
+
+    // 3. 布防唤醒源后进入下电模式 (不保持 RAM)
+    SYS_DisableAllIrq(&irq_status);
+    GPIOB_ITModeCfg(USB2_DATA_PINS, GPIO_ITMode_RiseEdge);
+    PWR_PeriphWakeUpCfg(ENABLE, RB_SLP_GPIO_WAKE, Long_Delay);
+    LowPower_Shutdown(0);
+
+    // 正常情况下不会执行到这里 (唤醒即复位)
+    SYS_RecoverIrq(irq_status);
+}
+
+// ===================================================================
+// 冷恢复耗时统计
+// ===================================================================
+
+/**
+ * @brief 冷恢复后首个按键送达主机时调用，报告唤醒到首个按键的耗时 (只报告一次)
+ */
+void Power_ReportFirstKey(void)
+{
+    if (!first_key_pending) {
+        return;
+    }
+    first_key_pending = FALSE;
+
+    LOG_SYS("Cold resume: wake to first key %lu ms (%lu ms before HAL_Init)\n",
+            boot_ms + (TMOS_GetSystemClock() - hal_tick) * 5 / 8, boot_ms);
+}
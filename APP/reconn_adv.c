@@ -0,0 +1,384 @@
+/*********************************************************************
+ * File Name          : reconn_adv.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 按主机扫描参数调整回连广播
+ *                      - 主机通过 Scan Parameters 服务写入扫描间隔/窗口，按主机地址
+ *                        记入 data flash (最近连接的主机排在最前，表满淘汰最久未连的一项)
+ *                      - 回连广播按最近连接主机的扫描节奏推导：
+ *                        高占空比间隔不大于扫描窗口 (扣除广播随机延迟)，每个扫描窗口
+ *                        至少落入一次广播；持续时间覆盖数个扫描周期即可，不再固定 5 秒
+ *                        低占空比间隔在窗口足够宽时放宽到窗口宽度，占空比更低仍每周期命中
+ *                      - 未知主机沿用 hiddev 的默认参数
+ *                      - 每次回连统计广播时长与广播事件数 (功耗近似)，按策略累计输出
+ *                      - 按过滤策略 (开放 / 仅已绑定主机) 统计广播时长与被接受的扫描请求数，
+ *                        每个被接受的请求多一次 SCAN_RSP 发送与一次协议栈处理 (DEBUG_BLE 下开启)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "hiddev.h"
+#include "reconn_adv.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+
+// 记录存放在 enum_cache (1 页) 与 usb_capture (16 页) 之下的一页
+#define RECONN_ADV_ADDR           (BLE_SNV_ADDR - EEPROM_PAGE_SIZE * 18)
+#define RECONN_ADV_SLOTS          4       // 记录主机数
+#define RECONN_ADV_MAGIC          0xAD01  // 记录有效标志 (结构变化时修改)
+
+// 以下间隔单位均为 0.625ms (与扫描参数、TMOS tick 相同)
+#define RECONN_ADV_INT_FLOOR      32      // 可连接广播的最小间隔 20ms
+#define RECONN_ADV_MARGIN         20      // 窗口余量：广播随机延迟 10ms + 三信道发送约 2.5ms
+#define RECONN_HIGH_INT_CAP       160     // 高占空比间隔上限 100ms (宽窗口/连续扫描时限制回连延迟)
+#define RECONN_HIGH_SCAN_PERIODS  3       // 高占空比阶段覆盖的扫描周期数
+#define RECONN_HIGH_TIMEOUT_MAX   10      // 高占空比阶段最长时间 (秒)
+#define RECONN_LOW_INT_CAP        480     // 低占空比间隔上限 300ms
+
+// 扫描请求通知每个请求唤醒一次 CPU，只在输出统计时开启
+#ifdef DEBUG_BLE
+#define RECONN_SCAN_REQ_NOTIFY    1
+#else
+#define RECONN_SCAN_REQ_NOTIFY    0
+#endif
+
+// ===================================================================
+// 记录与统计
+// ===================================================================
+typedef struct {
+    uint16_t magic;
+    uint8_t  addr_type;
+    uint8_t  addr[B_ADDR_LEN];
+    uint8_t  reserved;
+    uint16_t scan_int;     // 主机扫描间隔
+    uint16_t scan_win;     // 主机扫描窗口
+} ReconnAdvRec_t;
+
+enum {
+    RECONN_STRATEGY_DEFAULT,   // hiddev 固定参数
+    RECONN_STRATEGY_ALIGNED,   // 按主机扫描参数推导
+    RECONN_STRATEGY_NUM
+};
+
+static const char *const strategy_name[RECONN_STRATEGY_NUM] = { "default", "aligned" };
+
+typedef struct {
+    uint16_t count;        // 回连次数
+    uint32_t ms;           // 累计广播时长 (ms)
+    uint32_t events;       // 累计广播事件数
+} ReconnStat_t;
+
+#if RECONN_SCAN_REQ_NOTIFY
+enum {
+    ADV_FILTER_OPEN,           // 接受任意主机的扫描/连接请求 (未绑定或配对模式)
+    ADV_FILTER_ACCEPT_LIST,    // 只接受白名单 (已绑定主机)
+    ADV_FILTER_NUM
+};
+
+static const char *const filter_name[ADV_FILTER_NUM] = { "open", "accept list" };
+
+typedef struct {
+    uint32_t ms;           // 累计广播时长 (ms)
+    uint32_t scan_req;     // 累计被接受的扫描请求
+} FilterStat_t;
+#endif
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static ReconnAdvRec_t   rec_tbl[RECONN_ADV_SLOTS];
+static hidDevAdvParam_t adv_default;                 // hiddev 默认参数
+static uint8_t          cur_strategy = RECONN_STRATEGY_DEFAULT;
+
+static uint8_t  peer_valid = FALSE;                  // 当前连接的主机地址
+static uint8_t  peer_type;
+static uint8_t  peer_addr[B_ADDR_LEN];
+
+static uint8_t  is_measuring = FALSE;                // 断开后等待回连中
+static uint8_t  is_adv_running = FALSE;
+static uint32_t adv_start_tick = 0;                  // 当前广播段开始时刻
+static uint16_t adv_seg_int = 0;                     // 当前广播段平均间隔
+static uint32_t adv_ticks = 0;                       // 本次回连累计广播时长 (tick)
+static uint32_t adv_events = 0;                      // 本次回连累计广播事件数
+static ReconnStat_t stat_tbl[RECONN_STRATEGY_NUM];
+
+#if RECONN_SCAN_REQ_NOTIFY
+static uint8_t  adv_filter = ADV_FILTER_OPEN;        // 当前广播段的过滤策略
+static uint32_t adv_scan_req_start = 0;              // 当前广播段开始时的扫描请求计数
+static FilterStat_t filter_tbl[ADV_FILTER_NUM];
+#endif
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+static void ReconnAdv_Store(void)
+{
+    EEPROM_ERASE(RECONN_ADV_ADDR, EEPROM_PAGE_SIZE);
+    EEPROM_WRITE(RECONN_ADV_ADDR, rec_tbl, sizeof(rec_tbl));
+}
+
+static int8_t ReconnAdv_Find(uint8_t addr_type, const uint8_t *addr)
+{
+    for (uint8_t i = 0; i < RECONN_ADV_SLOTS; i++) {
+        if (rec_tbl[i].magic == RECONN_ADV_MAGIC && rec_tbl[i].addr_type == addr_type &&
+            tmos_memcmp(rec_tbl[i].addr, addr, B_ADDR_LEN)) {
+            return (int8_t)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 将第 idx 项移到表头 (idx 为 RECONN_ADV_SLOTS - 1 时即淘汰最后一项腾出表头)
+ */
+static void ReconnAdv_MoveFront(uint8_t idx)
+{
+    ReconnAdvRec_t rec = rec_tbl[idx];
+
+    for (; idx > 0; idx--) {
+        rec_tbl[idx] = rec_tbl[idx - 1];
+    }
+    rec_tbl[0] = rec;
+}
+
+/**
+ * @brief 按主机扫描参数推导回连广播参数
+ * @return 使用的策略 (RECONN_STRATEGY_*)
+ */
+static uint8_t ReconnAdv_Derive(const ReconnAdvRec_t *rec, hidDevAdvParam_t *p)
+{
+    uint16_t fit;
+    uint32_t timeout;
+
+    *p = adv_default;
+    if (rec->magic != RECONN_ADV_MAGIC || rec->scan_int == 0) {
+        return RECONN_STRATEGY_DEFAULT;
+    }
+
+    // 高占空比：间隔不大于扫描窗口，每个窗口至少一次广播；窗口太窄时取最快速率靠随机延迟错开
+    fit = RECONN_ADV_INT_FLOOR;
+    if (rec->scan_win > RECONN_ADV_INT_FLOOR + RECONN_ADV_MARGIN) {
+        fit = rec->scan_win - RECONN_ADV_MARGIN;
+        if (fit > RECONN_HIGH_INT_CAP) fit = RECONN_HIGH_INT_CAP;
+    }
+    p->highIntMin = fit;
+    p->highIntMax = fit;
+
+    // 持续时间覆盖数个扫描周期 (秒，向上取整)
+    timeout = ((uint32_t)rec->scan_int * RECONN_HIGH_SCAN_PERIODS * 5 + 7999) / 8000;
+    if (timeout > RECONN_HIGH_TIMEOUT_MAX) timeout = RECONN_HIGH_TIMEOUT_MAX;
+    p->highTimeout = (uint16_t)timeout;
+
+    // 低占空比：窗口比默认间隔宽时放宽到窗口宽度，仍每个扫描周期命中
+    if (rec->scan_win > adv_default.lowIntMax + RECONN_ADV_MARGIN) {
+        fit = rec->scan_win - RECONN_ADV_MARGIN;
+        if (fit > RECONN_LOW_INT_CAP) fit = RECONN_LOW_INT_CAP;
+        p->lowIntMin = fit;
+        p->lowIntMax = fit;
+    }
+    return RECONN_STRATEGY_ALIGNED;
+}
+
+/**
+ * @brief 按最近连接的主机更新 hiddev 回连广播参数
+ */
+static void ReconnAdv_Apply(void)
+{
+    hidDevAdvParam_t p;
+
+    cur_strategy = ReconnAdv_Derive(&rec_tbl[0], &p);
+    HidDev_SetParameter(HIDDEV_RECONNECT_ADV, sizeof(p), &p);
+
+    LOG_BLE("Reconnect adv (%s): high %d x%d s, low %d\n", strategy_name[cur_strategy],
+            p.highIntMin, p.highTimeout, p.lowIntMin);
+}
+
+/**
+ * @brief 结算一段广播的扫描请求数，输出两种过滤策略的请求速率 (次/分钟)
+ */
+static void ReconnAdv_CountScanReq(uint32_t elapsed)
+{
+#if RECONN_SCAN_REQ_NOTIFY
+    uint32_t      req = 0;
+    FilterStat_t *st = &filter_tbl[adv_filter];
+#ifdef DEBUG
+    uint32_t      rate[ADV_FILTER_NUM];
+#endif
+
+    HidDev_GetParameter(HIDDEV_SCAN_REQ_COUNT, &req);
+    req -= adv_scan_req_start;
+    st->ms += elapsed * 5 / 8;
+    st->scan_req += req;
+
+#ifdef DEBUG
+    for (uint8_t i = 0; i < ADV_FILTER_NUM; i++) {
+        rate[i] = (filter_tbl[i].ms >= 1000) ? filter_tbl[i].scan_req * 60 / (filter_tbl[i].ms / 1000) : 0;
+    }
+    LOG_BLE("Adv (%s): %lu ms, %lu scan req; per min: %s %lu, %s %lu\n",
+            filter_name[adv_filter], elapsed * 5 / 8, req,
+            filter_name[ADV_FILTER_OPEN], rate[ADV_FILTER_OPEN],
+            filter_name[ADV_FILTER_ACCEPT_LIST], rate[ADV_FILTER_ACCEPT_LIST]);
+#endif
+#endif
+}
+
+static uint8_t ReconnAdv_IsBonded(void)
+{
+    uint8_t bond_count = 0;
+
+    GAPBondMgr_GetParameter(GAPBOND_BOND_COUNT, &bond_count);
+    return (bond_count > 0);
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+void ReconnAdv_Init(void)
+{
+    EEPROM_READ(RECONN_ADV_ADDR, rec_tbl, sizeof(rec_tbl));
+    HidDev_GetParameter(HIDDEV_RECONNECT_ADV, &adv_default);
+    ReconnAdv_Apply();
+
+    // 上电/冷恢复后的首次回连同样计入统计
+    is_measuring = ReconnAdv_IsBonded();
+
+#if RECONN_SCAN_REQ_NOTIFY
+    GAP_SetParamValue(TGAP_ADV_SCAN_REQ_NOTIFY, 1);
+#endif
+}
+
+/**
+ * @brief 广播开始 (GAPROLE_ADVERTISING)：记录本段广播的起点、间隔与过滤策略
+ */
+void ReconnAdv_OnAdvStart(void)
+{
+    if (is_adv_running) return;
+    is_adv_running = TRUE;
+    adv_start_tick = TMOS_GetSystemClock();
+    adv_seg_int = (GAP_GetParamValue(TGAP_DISC_ADV_INT_MIN) + GAP_GetParamValue(TGAP_DISC_ADV_INT_MAX)) / 2;
+    if (adv_seg_int == 0) adv_seg_int = 1;
+
+#if RECONN_SCAN_REQ_NOTIFY
+    {
+        uint8_t policy = GAP_FILTER_POLICY_ALL;
+
+        GAPRole_GetParameter(GAPROLE_ADV_FILTER_POLICY, &policy);
+        adv_filter = (policy == GAP_FILTER_POLICY_ALL) ? ADV_FILTER_OPEN : ADV_FILTER_ACCEPT_LIST;
+        HidDev_GetParameter(HIDDEV_SCAN_REQ_COUNT, &adv_scan_req_start);
+    }
+#endif
+}
+
+/**
+ * @brief 广播结束 (超时、进入休眠或已连接)：累计广播时长与事件数
+ */
+void ReconnAdv_OnAdvStop(void)
+{
+    uint32_t elapsed;
+
+    if (!is_adv_running) return;
+    is_adv_running = FALSE;
+
+    elapsed = TMOS_GetSystemClock() - adv_start_tick;
+    ReconnAdv_CountScanReq(elapsed);
+    if (!is_measuring) return;
+
+    adv_ticks  += elapsed;
+    adv_events += elapsed / adv_seg_int + 1;
+}
+
+/**
+ * @brief 连接建立：结算本次回连统计，当前主机移到表头并按其扫描参数准备下次回连
+ */
+void ReconnAdv_OnConnected(uint8_t addrType, const uint8_t *addr)
+{
+    int8_t        idx;
+    ReconnStat_t *st;
+    uint32_t      ms;
+
+    ReconnAdv_OnAdvStop();
+    if (is_measuring) {
+        is_measuring = FALSE;
+        ms = adv_ticks * 5 / 8;
+        st = &stat_tbl[cur_strategy];
+        st->count++;
+        st->ms += ms;
+        st->events += adv_events;
+        LOG_BLE("Reconnect (%s): %lu ms, ~%lu adv events; avg %lu ms, %lu events over %d\n",
+                strategy_name[cur_strategy], ms, adv_events,
+                st->ms / st->count, st->events / st->count, st->count);
+    }
+
+    peer_valid = TRUE;
+    peer_type = addrType;
+    tmos_memcpy(peer_addr, addr, B_ADDR_LEN);
+
+    idx = ReconnAdv_Find(addrType, addr);
+    if (idx > 0) {
+        ReconnAdv_MoveFront((uint8_t)idx);
+        ReconnAdv_Store();
+        ReconnAdv_Apply();
+    }
+}
+
+/**
+ * @brief 连接断开：开始统计本次回连
+ */
+void ReconnAdv_OnDisconnected(void)
+{
+    peer_valid = FALSE;
+    is_measuring = ReconnAdv_IsBonded();
+    adv_ticks = 0;
+    adv_events = 0;
+}
+
+/**
+ * @brief 高占空比回连广播超时：已绑定时改用低占空比参数继续广播 (不限时)
+ *        配对模式的开放广播由 hiddev 管理时长，不改参数
+ */
+void ReconnAdv_UseLowDuty(void)
+{
+    hidDevAdvParam_t p;
+    uint8_t          pairing = FALSE;
+
+    HidDev_GetParameter(HIDDEV_PAIRING_MODE, &pairing);
+    if (!ReconnAdv_IsBonded() || pairing) return;
+    HidDev_GetParameter(HIDDEV_RECONNECT_ADV, &p);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, p.lowIntMin);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, p.lowIntMax);
+    GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, 0);
+}
+
+/**
+ * @brief 主机写入 Scan Interval Window (hiddev 回调)
+ */
+void ReconnAdv_OnScanParam(uint16_t connHandle, uint16_t scanInterval, uint16_t scanWindow)
+{
+    int8_t idx;
+
+    if (!peer_valid || scanInterval == 0 || scanWindow == 0 || scanWindow > scanInterval) return;
+
+    idx = ReconnAdv_Find(peer_type, peer_addr);
+    if (idx == 0 && rec_tbl[0].scan_int == scanInterval && rec_tbl[0].scan_win == scanWindow) {
+        return;   // 未变化，不写 flash
+    }
+    if (idx < 0) {
+        // 新主机：淘汰最久未连的一项
+        ReconnAdv_MoveFront(RECONN_ADV_SLOTS - 1);
+        rec_tbl[0].magic = RECONN_ADV_MAGIC;
+        rec_tbl[0].addr_type = peer_type;
+        tmos_memcpy(rec_tbl[0].addr, peer_addr, B_ADDR_LEN);
+        rec_tbl[0].reserved = 0;
+    } else {
+        ReconnAdv_MoveFront((uint8_t)idx);
+    }
+    rec_tbl[0].scan_int = scanInterval;
+    rec_tbl[0].scan_win = scanWindow;
+    ReconnAdv_Store();
+
+    LOG_BLE("Host scan: interval %d, window %d (x0.625ms)\n", scanInterval, scanWindow);
+    ReconnAdv_Apply();
+}
@@ -0,0 +1,332 @@
+/*********************************************************************
+ * File Name          : rf_link.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 2.4G 私有链路协议核心 (与平台无关)
+ *                      - 双方每 1ms 调用一次 RfLink_Tick() 推进时隙，信道取跳频表[时隙号 % 16]
+ *                      - 适配器 (DEVICE)：每个时隙发队首报文，收到 ACK 出队，否则下一时隙换信道重传；
+ *                        空闲时每 100 个时隙发保活帧，未确认则连发一轮 (逐个信道) 以便接收端重新捕获
+ *                      - 接收器 (DONGLE)：收到帧即按帧头时隙号对齐相位并回 ACK；
+ *                        连续静默 250 个时隙判为失步，驻留单个信道等待，每 256 个时隙换一个
+ *                      - 键盘报文超过重传上限时，仅当它带来的每个按下/松开沿在队列中下一个
+ *                        键盘状态里依然成立才放弃 (跳过它接收端也看得到这些沿)；否则继续重传，
+ *                        与鼠标报文一样由队列满 (RFL_ERR_FULL) 让桥接层保留报文反压
+ *                      - 帧格式: [类型] [序号] [时隙号] [载荷 0~8]，ACK: [0x0F] [时隙号]
+ *                        (接入地址与 CRC 由射频硬件处理)
+ *********************************************************************/
+
+#include <string.h>
+#include "rf_link.h"
+
+#define RFL_NONE                  0xFF    // in_flight: 本时隙未发帧
+
+// ===================================================================
+// 内部函数
+// ===================================================================
+
+/**
+ * @brief 由种子生成跳频表：可用信道洗牌后取前 RFL_HOP_NUM 个 (互不相同)
+ */
+static void RfLink_BuildHop(RfLink_t *l, uint32_t seed)
+{
+    uint8_t  pool[RFL_CHANNEL_NUM];
+    uint8_t  i, j, t;
+    uint32_t x = seed ? seed : 0x2545F491;
+
+    for (i = 0; i < RFL_CHANNEL_NUM; i++) pool[i] = i;
+    for (i = 0; i < RFL_HOP_NUM; i++) {
+        // xorshift32
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        j = i + (uint8_t)(x % (RFL_CHANNEL_NUM - i));
+        t = pool[i]; pool[i] = pool[j]; pool[j] = t;
+        l->hop[i] = pool[i];
+    }
+}
+
+/**
+ * @brief 键码是否在 Boot 键盘报文的按键区 (第 2 字节起)
+ */
+static uint8_t RfLink_KeyIn(const uint8_t *rpt, uint8_t len, uint8_t code)
+{
+    uint8_t i;
+
+    for (i = 2; i < len; i++) {
+        if (rpt[i] == code) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 跳过 cur 直接从 prev 到 next 时，cur 相对 prev 的每个沿是否仍然可见
+ *        (按下的键在 next 中仍按着，松开的键在 next 中仍松开，修饰键按位同理)
+ */
+static uint8_t RfLink_EdgesKept(const uint8_t *prev, const uint8_t *cur, const uint8_t *next, uint8_t len)
+{
+    uint8_t i;
+
+    if ((prev[0] ^ cur[0]) & (cur[0] ^ next[0])) return 0;
+    for (i = 2; i < len; i++) {
+        if (cur[i] && !RfLink_KeyIn(prev, len, cur[i]) && !RfLink_KeyIn(next, len, cur[i])) return 0;
+        if (prev[i] && !RfLink_KeyIn(cur, len, prev[i]) && RfLink_KeyIn(next, len, prev[i])) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief 队首键盘报文能否放弃：队列中下一个键盘状态已包含它的全部按键沿
+ *        (与接收端最近确认的键盘状态比较)
+ */
+static uint8_t RfLink_Superseded(const RfLink_t *l)
+{
+    const RfLinkEntry_t *head = &l->queue[l->q_head];
+    const RfLinkEntry_t *next;
+    uint8_t              i;
+
+    for (i = 1; i < l->q_count; i++) {
+        next = &l->queue[(l->q_head + i) % RFL_QUEUE_MAX];
+        if (next->type != RFL_TYPE_KBD) continue;
+        if (next->len != head->len || head->len < 2) return 0;
+        return RfLink_EdgesKept(l->kbd_acked, head->data, next->data, head->len);
+    }
+    return 0;
+}
+
+static void RfLink_Pop(RfLink_t *l)
+{
+    l->q_head = (l->q_head + 1) % RFL_QUEUE_MAX;
+    l->q_count--;
+}
+
+/**
+ * @brief 发送端结束当前时隙：按是否收到 ACK 出队或计入重传
+ */
+static void RfLink_CloseSlot(RfLink_t *l)
+{
+    RfLinkEntry_t *e;
+    uint32_t       lat;
+
+    if (l->in_flight == RFL_NONE) return;
+
+    if (l->in_flight == RFL_TYPE_KEEPALIVE) {
+        // 保活未确认：下一时隙换信道再发，一轮覆盖全部信道后等下个保活周期
+        if (l->acked || ++l->ka_retries >= RFL_HOP_NUM) {
+            l->ka_retries = 0;
+        }
+    } else if (l->acked) {
+        e   = &l->queue[l->q_head];
+        lat = l->clock - e->submit_slot;
+        l->stat.acked++;
+        l->stat.lat_sum += lat;
+        if (lat > l->stat.lat_max) l->stat.lat_max = lat;
+        l->stat.lat_hist[(lat <= 1) ? 0 : (lat == 2) ? 1 : (lat <= 4) ? 2 : 3]++;
+        if (e->type == RFL_TYPE_KBD) {
+            memset(l->kbd_acked, 0, sizeof(l->kbd_acked));
+            memcpy(l->kbd_acked, e->data, e->len);
+        }
+        RfLink_Pop(l);
+    } else {
+        e = &l->queue[l->q_head];
+        if (e->retries < 0xFF) e->retries++;
+        if (e->retries >= RFL_RETRY_MAX && e->type == RFL_TYPE_KBD && RfLink_Superseded(l)) {
+            l->stat.superseded++;
+            RfLink_Pop(l);
+        }
+    }
+
+    l->in_flight = RFL_NONE;
+    l->acked     = 0;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 初始化链路状态
+ * @param seed  跳频表种子 (两端必须一致)
+ */
+void RfLink_Init(RfLink_t *l, uint8_t role, uint32_t seed)
+{
+    memset(l, 0, sizeof(*l));
+    l->role      = role;
+    l->in_flight = RFL_NONE;
+    l->lost      = (role == RFL_ROLE_DONGLE);   // 接收端上电即处于捕获状态
+    RfLink_BuildHop(l, seed);
+}
+
+/**
+ * @brief 当前时隙使用的信道 (0~36)
+ */
+uint8_t RfLink_Channel(const RfLink_t *l)
+{
+    if (l->lost) return l->hop[l->park];
+    return l->hop[l->slot % RFL_HOP_NUM];
+}
+
+/**
+ * @brief 推进一个时隙 (每 1ms 一次；接收端收到帧并回 ACK 后立即调用)
+ */
+void RfLink_Tick(RfLink_t *l)
+{
+    if (l->role == RFL_ROLE_DEVICE) {
+        RfLink_CloseSlot(l);
+    } else if (l->lost) {
+        if (++l->dwell >= RFL_LOST_DWELL) {
+            l->dwell = 0;
+            l->park  = (l->park + 1) % RFL_HOP_NUM;
+        }
+    } else if (++l->silent >= RFL_SYNC_LOSS) {
+        // 失步：驻留在下一时隙的信道上等待发送端跳过来
+        l->lost  = 1;
+        l->dwell = 0;
+        l->park  = (uint8_t)(l->slot + 1) % RFL_HOP_NUM;
+        l->rx_seq_valid = 0;
+    }
+
+    l->slot++;
+    l->clock++;
+}
+
+/**
+ * @brief 链路是否在线 (发送端: 近期收到过 ACK；接收端: 未失步)
+ */
+uint8_t RfLink_IsUp(const RfLink_t *l)
+{
+    if (l->role == RFL_ROLE_DONGLE) return !l->lost;
+    return l->ack_valid && (l->clock - l->last_ack) < RFL_LINK_TIMEOUT;
+}
+
+/**
+ * @brief 报文入队 (发送端)
+ * @return RFL_OK / RFL_ERR_FULL (调用方保留报文稍后重试) / RFL_ERR_PARAM
+ */
+uint8_t RfLink_Submit(RfLink_t *l, uint8_t type, const uint8_t *data, uint8_t len)
+{
+    RfLinkEntry_t *e;
+
+    if (type != RFL_TYPE_KBD && type != RFL_TYPE_MOUSE) return RFL_ERR_PARAM;
+    if (len > RFL_PAYLOAD_MAX) return RFL_ERR_PARAM;
+    if (l->q_count >= RFL_QUEUE_MAX) return RFL_ERR_FULL;
+
+    e = &l->queue[(l->q_head + l->q_count) % RFL_QUEUE_MAX];
+    e->type        = type;
+    e->len         = len;
+    e->seq         = l->tx_seq++;
+    e->retries     = 0;
+    e->submit_slot = l->clock;
+    memcpy(e->data, data, len);
+    l->q_count++;
+    l->stat.submitted++;
+    return RFL_OK;
+}
+
+/**
+ * @brief 待确认报文数 (发送端)
+ */
+uint8_t RfLink_QueueDepth(const RfLink_t *l)
+{
+    return l->q_count;
+}
+
+/**
+ * @brief 队列中某类报文的条数 (发送端；鼠标已有一条在排队时调用方继续累计位移)
+ */
+uint8_t RfLink_Pending(const RfLink_t *l, uint8_t type)
+{
+    uint8_t i, n = 0;
+
+    for (i = 0; i < l->q_count; i++) {
+        if (l->queue[(l->q_head + i) % RFL_QUEUE_MAX].type == type) n++;
+    }
+    return n;
+}
+
+/**
+ * @brief 生成本时隙要发送的帧 (发送端，每个时隙最多一帧)
+ * @param frame  输出缓冲 (至少 RFL_FRAME_MAX 字节)
+ * @return 帧长度，0 表示本时隙不发送
+ */
+uint8_t RfLink_BuildFrame(RfLink_t *l, uint8_t *frame)
+{
+    RfLinkEntry_t *e;
+    uint8_t        len;
+
+    if (l->role != RFL_ROLE_DEVICE || l->in_flight != RFL_NONE) return 0;
+
+    if (l->q_count) {
+        e = &l->queue[l->q_head];
+        frame[0] = e->type;
+        frame[1] = e->seq;
+        memcpy(frame + RFL_HDR_LEN, e->data, e->len);
+        len = RFL_HDR_LEN + e->len;
+        if (e->retries) l->stat.retrans++;
+        l->in_flight = e->type;
+    } else if (l->ka_retries || (l->clock - l->last_tx) >= RFL_KEEPALIVE_SLOTS) {
+        frame[0] = RFL_TYPE_KEEPALIVE;
+        frame[1] = 0;
+        len = RFL_HDR_LEN;
+        l->stat.keepalives++;
+        l->in_flight = RFL_TYPE_KEEPALIVE;
+    } else {
+        return 0;
+    }
+
+    frame[2] = l->slot;
+    l->last_tx = l->clock;
+    l->stat.frames_tx++;
+    return len;
+}
+
+/**
+ * @brief 本时隙收到 ACK (发送端)
+ */
+void RfLink_OnAck(RfLink_t *l, const uint8_t *ack, uint8_t len)
+{
+    if (l->in_flight == RFL_NONE) return;
+    if (len < RFL_ACK_LEN || ack[0] != RFL_TYPE_ACK) return;
+
+    l->acked     = 1;
+    l->ack_valid = 1;
+    l->last_ack  = l->clock;
+}
+
+/**
+ * @brief 收到一帧 (接收端)：对齐时隙、去重、投递，并生成 ACK
+ * @param ack      输出 ACK (RFL_ACK_LEN 字节)
+ * @param deliver  新报文投递回调
+ * @return ACK 长度，0 表示帧无效不应答
+ */
+uint8_t RfLink_OnFrame(RfLink_t *l, const uint8_t *frame, uint8_t len,
+                       uint8_t *ack, RfLinkDeliverCB_t deliver)
+{
+    uint8_t type;
+
+    if (l->role != RFL_ROLE_DONGLE || len < RFL_HDR_LEN) return 0;
+    type = frame[0];
+    if (type != RFL_TYPE_KEEPALIVE && type != RFL_TYPE_KBD && type != RFL_TYPE_MOUSE) return 0;
+
+    if (l->lost) {
+        l->lost = 0;
+        l->stat.resyncs++;
+    }
+    l->slot   = frame[2];
+    l->silent = 0;
+    l->stat.frames_rx++;
+
+    if (type != RFL_TYPE_KEEPALIVE) {
+        if (l->rx_seq_valid && frame[1] == l->rx_seq) {
+            // ACK 丢失导致的重传：再应答一次，不重复投递
+            l->stat.duplicates++;
+        } else {
+            l->rx_seq       = frame[1];
+            l->rx_seq_valid = 1;
+            l->stat.delivered++;
+            if (deliver) deliver(type, frame + RFL_HDR_LEN, len - RFL_HDR_LEN);
+        }
+    }
+
+    ack[0] = RFL_TYPE_ACK;
+    ack[1] = frame[2];
+    return RFL_ACK_LEN;
+}
@@ -0,0 +1,338 @@
+/*********************************************************************
+ * File Name          : rf_output.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 2.4G 私有链路输出 (ENABLE_RF_LINK)
+ *                      - TMR1 每 1ms 中断一次，置 TMOS 事件推进时隙 (协议核心见 rf_link.c)
+ *                      - 适配器：时隙事件里结束上一时隙、换信道、RF_Tx 自动模式发帧并等待 ACK；
+ *                        桥接层报文入队后在下一个时隙发出 (队列满或鼠标已在排队时返回失败，
+ *                        由桥接层保留/累计，与有线口端点忙的处理一致)
+ *                      - 接收器 (RF_LINK_DONGLE)：RF_Rx 自动模式收帧并由硬件回 ACK，
+ *                        ACK 发完后立即跳到下一时隙信道，定时器重置为 1.5 个时隙：
+ *                        发送端下一帧按时到达则重新对齐，未到达则按时隙继续跳频
+ *                      - 射频状态回调只搬运数据并置事件，协议状态只在 TMOS 任务中访问
+ *                      - 定时器按 Tsys 计数：链路在线时适配器保持全速主频 (hidkbd.c 按 RfOut_IsActive 选择)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "rf_output.h"
+#include "rf_link.h"
+#include "usb_device.h"
+#include "debug.h"
+#include "evt_mon.h"
+
+#ifdef ENABLE_RF_LINK
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+// 两端固件必须一致 (相当于配对信息；不同套件请改成不同的值)
+#define RF_LINK_SEED              0x5EED1224      // 跳频表种子
+#define RF_LINK_ACCESS_ADDR       0x71764129      // 接入地址
+#define RF_LINK_CRC_INIT          0x555555
+
+#define RF_SLOT_CYCLES            (FREQ_SYS / 1000)              // 1ms 时隙 (TMR1 计数)
+#define RF_RESYNC_CYCLES          (RF_SLOT_CYCLES * 3 / 2)       // 接收器收帧后的首个时隙边界
+#define RF_DONGLE_KBD_FIFO        4       // 接收器 USB 端点忙时暂存的键盘报文
+
+// ===================================================================
+// TMOS 任务事件位定义 (Task Events)
+// ===================================================================
+#define RFOUT_SLOT_EVT            0x0001  // 1ms 时隙边界 (TMR1 中断置位)
+#define RFOUT_RX_EVT              0x0002  // 接收器：一帧处理完毕 (ACK 已发出或失败)
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static uint8_t   rfOutTaskId = INVALID_TASK_ID;
+static RfLink_t  rf_link;
+static uint8_t   rf_enabled  = FALSE;
+
+__attribute__((aligned(4))) static uint8_t rf_tx_buf[RFL_FRAME_MAX];
+
+// 射频回调 -> 任务 的交接 (回调在协议栈上下文中调用，不直接访问 rf_link)
+static volatile uint8_t rf_rx_ready = FALSE;
+static uint8_t   rf_rx_buf[RFL_FRAME_MAX];
+static uint8_t   rf_rx_len = 0;
+
+#ifdef RF_LINK_DONGLE
+// 接收器：USB 端点忙时暂存 (键盘保序排队，鼠标累计位移)
+static uint8_t   dgl_kbd[RF_DONGLE_KBD_FIFO][8];
+static uint8_t   dgl_kbd_head  = 0;
+static uint8_t   dgl_kbd_count = 0;
+static uint8_t   dgl_mouse_btn = 0;
+static int16_t   dgl_mouse_x = 0, dgl_mouse_y = 0, dgl_mouse_w = 0;
+static uint8_t   dgl_mouse_dirty = FALSE;
+__attribute__((aligned(4))) static uint8_t rf_ack_buf[RFL_ACK_LEN];
+#endif
+
+// ===================================================================
+// 中断与射频回调
+// ===================================================================
+
+/**
+ * @brief TMR1 周期中断：时隙边界 (接收器收帧后临时延长的周期在此恢复)
+ */
+__INTERRUPT
+__HIGH_CODE
+void TMR1_IRQHandler(void)
+{
+    if (TMR1_GetITFlag(TMR0_3_IT_CYC_END)) {
+        TMR1_ClearITFlag(TMR0_3_IT_CYC_END);
+        R32_TMR1_CNT_END = RF_SLOT_CYCLES;
+        tmos_set_event(rfOutTaskId, RFOUT_SLOT_EVT);
+    }
+}
+
+/**
+ * @brief 射频状态回调
+ * @param sta    状态 (TX_MODE_* / RX_MODE_*)
+ * @param rsr    接收状态: bit0 CRC 错误, bit1 类型不匹配
+ * @param rxBuf  [RSSI] [长度] [数据...]
+ */
+static void RfOut_StatusCB(uint8_t sta, uint8_t rsr, uint8_t *rxBuf)
+{
+    switch (sta) {
+        case TX_MODE_RX_DATA:       // 适配器：收到 ACK
+        case RX_MODE_RX_DATA:       // 接收器：收到帧 (硬件随后自动回 ACK)
+            if (rsr == 0 && rxBuf[1] <= RFL_FRAME_MAX) {
+                tmos_memcpy(rf_rx_buf, rxBuf + 2, rxBuf[1]);
+                rf_rx_len   = rxBuf[1];
+                rf_rx_ready = TRUE;
+            }
+            break;
+
+#ifdef RF_LINK_DONGLE
+        case RX_MODE_TX_FINISH:     // 接收器：ACK 已发出
+        case RX_MODE_TX_FAIL:
+            tmos_set_event(rfOutTaskId, RFOUT_RX_EVT);
+            break;
+#endif
+
+        default: break;
+    }
+}
+
+// ===================================================================
+// 接收器 (Dongle)
+// ===================================================================
+#ifdef RF_LINK_DONGLE
+
+/**
+ * @brief 暂存的报文交给 USB 设备口 (端点忙则留到下一时隙)
+ */
+static void RfOut_DongleFlush(void)
+{
+    uint8_t report[4];
+
+    while (dgl_kbd_count && UsbDev_SendKeyboard(dgl_kbd[dgl_kbd_head]) == SUCCESS) {
+        dgl_kbd_head = (dgl_kbd_head + 1) % RF_DONGLE_KBD_FIFO;
+        dgl_kbd_count--;
+    }
+
+    if (!dgl_mouse_dirty) return;
+    report[0] = dgl_mouse_btn;
+    report[1] = (uint8_t)(int8_t)((dgl_mouse_x > 127) ? 127 : (dgl_mouse_x < -127) ? -127 : dgl_mouse_x);
+    report[2] = (uint8_t)(int8_t)((dgl_mouse_y > 127) ? 127 : (dgl_mouse_y < -127) ? -127 : dgl_mouse_y);
+    report[3] = (uint8_t)(int8_t)((dgl_mouse_w > 127) ? 127 : (dgl_mouse_w < -127) ? -127 : dgl_mouse_w);
+    if (UsbDev_SendMouse(report) == SUCCESS) {
+        dgl_mouse_x -= (int8_t)report[1];
+        dgl_mouse_y -= (int8_t)report[2];
+        dgl_mouse_w -= (int8_t)report[3];
+        dgl_mouse_dirty = (dgl_mouse_x || dgl_mouse_y || dgl_mouse_w);
+    }
+}
+
+/**
+ * @brief 协议核心投递的新报文
+ */
+static void RfOut_Deliver(uint8_t type, const uint8_t *data, uint8_t len)
+{
+    if (type == RFL_TYPE_KBD && len == 8) {
+        if (dgl_kbd_count == RF_DONGLE_KBD_FIFO) {
+            // 满：覆盖队尾 (键盘报文是状态量，最新状态优先)
+            dgl_kbd_count--;
+        }
+        tmos_memcpy(dgl_kbd[(dgl_kbd_head + dgl_kbd_count) % RF_DONGLE_KBD_FIFO], data, 8);
+        dgl_kbd_count++;
+    } else if (type == RFL_TYPE_MOUSE && len == 4) {
+        dgl_mouse_btn   = data[0];
+        dgl_mouse_x    += (int8_t)data[1];
+        dgl_mouse_y    += (int8_t)data[2];
+        dgl_mouse_w    += (int8_t)data[3];
+        dgl_mouse_dirty = TRUE;
+    }
+    RfOut_DongleFlush();
+}
+
+/**
+ * @brief 在当前时隙信道上重新开始接收 (ACK 内容需预先装入，硬件收帧后自动发出)
+ */
+static void RfOut_DongleListen(void)
+{
+    RF_Shut();
+    RF_SetChannel(RfLink_Channel(&rf_link));
+    rf_ack_buf[0] = RFL_TYPE_ACK;
+    rf_ack_buf[1] = rf_link.slot;
+    RF_Rx(rf_ack_buf, RFL_ACK_LEN, 0xFF, 0xFF);
+}
+
+#endif /* RF_LINK_DONGLE */
+
+// ===================================================================
+// TMOS 任务
+// ===================================================================
+static uint16_t RfOut_ProcessEvent(uint8_t task_id, uint16_t events)
+{
+#ifdef RF_LINK_DONGLE
+    uint8_t ack[RFL_ACK_LEN];
+
+    // 收帧：对齐时隙并投递，立即跳到下一时隙信道，下一个边界放在 1.5 个时隙后
+    if (events & RFOUT_RX_EVT) {
+        if (rf_rx_ready) {
+            rf_rx_ready = FALSE;
+            if (RfLink_OnFrame(&rf_link, rf_rx_buf, rf_rx_len, ack, RfOut_Deliver)) {
+                RfLink_Tick(&rf_link);
+                TMR1_TimerInit(RF_RESYNC_CYCLES);
+                tmos_clear_event(rfOutTaskId, RFOUT_SLOT_EVT);
+                events &= ~RFOUT_SLOT_EVT;
+            }
+        }
+        RfOut_DongleListen();
+        return (events ^ RFOUT_RX_EVT);
+    }
+
+    // 时隙边界未收到帧：继续按时隙跳频 (失步时由协议核心驻留单信道)
+    if (events & RFOUT_SLOT_EVT) {
+        RfLink_Tick(&rf_link);
+        RfOut_DongleListen();
+        RfOut_DongleFlush();
+        return (events ^ RFOUT_SLOT_EVT);
+    }
+#else
+    uint8_t len;
+
+    // 时隙边界：先结算上一时隙的 ACK，再在新信道上发本时隙的帧
+    if (events & RFOUT_SLOT_EVT) {
+        if (rf_rx_ready) {
+            rf_rx_ready = FALSE;
+            RfLink_OnAck(&rf_link, rf_rx_buf, rf_rx_len);
+        }
+        RfLink_Tick(&rf_link);
+        if (rf_enabled && (len = RfLink_BuildFrame(&rf_link, rf_tx_buf)) != 0) {
+            RF_Shut();
+            RF_SetChannel(RfLink_Channel(&rf_link));
+            RF_Tx(rf_tx_buf, len, 0xFF, 0xFF);
+        }
+        return (events ^ RFOUT_SLOT_EVT);
+    }
+#endif
+
+    return 0;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+EVT_MON_DEFINE(RfOut_ProcessEvent, EVT_MON_TASK_RFOUT)
+
+/**
+ * @brief 初始化射频与时隙定时器 (RF_RoleInit 之后调用)
+ */
+void RfOut_Init(void)
+{
+    rfConfig_t cfg;
+
+    rfOutTaskId = TMOS_ProcessEventRegister(EVT_MON_FN(RfOut_ProcessEvent));
+
+#ifdef RF_LINK_DONGLE
+    RfLink_Init(&rf_link, RFL_ROLE_DONGLE, RF_LINK_SEED);
+#else
+    RfLink_Init(&rf_link, RFL_ROLE_DEVICE, RF_LINK_SEED);
+#endif
+
+    tmos_memset(&cfg, 0, sizeof(cfg));
+    cfg.LLEMode       = LLE_MODE_AUTO | LLE_MODE_PHY_2M;
+    cfg.Channel       = RfLink_Channel(&rf_link);
+    cfg.accessAddress = RF_LINK_ACCESS_ADDR;
+    cfg.CRCInit       = RF_LINK_CRC_INIT;
+    cfg.rfStatusCB    = RfOut_StatusCB;
+    cfg.RxMaxlen      = RFL_FRAME_MAX;
+    RF_Config(&cfg);
+
+    TMR1_TimerInit(RF_SLOT_CYCLES);
+    TMR1_ITCfg(ENABLE, TMR0_3_IT_CYC_END);
+    PFIC_EnableIRQ(TMR1_IRQn);
+
+    rf_enabled = TRUE;
+#ifdef RF_LINK_DONGLE
+    RfOut_DongleListen();
+    LOG_SYS("[Init] RF dongle, seed %08lx\n", (uint32_t)RF_LINK_SEED);
+#else
+    LOG_SYS("[Init] RF link, seed %08lx\n", (uint32_t)RF_LINK_SEED);
+#endif
+}
+
+/**
+ * @brief 暂停/恢复发送 (适配器软休眠时停发保活，接收器随之失步驻留)
+ */
+void RfOut_SetEnable(uint8_t enable)
+{
+    rf_enabled = enable;
+    if (enable) {
+        TMR1_Enable();
+    } else {
+        TMR1_Disable();
+        RF_Shut();
+    }
+}
+
+/**
+ * @brief 链路是否在线 (适配器：近期收到过 ACK)
+ */
+uint8_t RfOut_IsActive(void)
+{
+    return rf_enabled && RfLink_IsUp(&rf_link);
+}
+
+/**
+ * @brief 键盘报文入队 (8 字节 Boot 格式)
+ * @return SUCCESS / FAILURE (队列满，桥接层排队重试)
+ */
+uint8_t RfOut_SendKeyboard(uint8_t *report)
+{
+    return (RfLink_Submit(&rf_link, RFL_TYPE_KBD, report, 8) == RFL_OK) ? SUCCESS : FAILURE;
+}
+
+/**
+ * @brief 鼠标报文入队 [Btn, X, Y, Wheel]
+ * @return SUCCESS / FAILURE (已有一帧在排队，桥接层继续累计位移)
+ */
+uint8_t RfOut_SendMouse(uint8_t *report)
+{
+    if (RfLink_Pending(&rf_link, RFL_TYPE_MOUSE)) return FAILURE;
+    return (RfLink_Submit(&rf_link, RFL_TYPE_MOUSE, report, 4) == RFL_OK) ? SUCCESS : FAILURE;
+}
+
+/**
+ * @brief 通过 UART 输出链路统计 (双击 USER 键)，随后清零
+ */
+void RfOut_Dump(void)
+{
+    RfLinkStat_t *st = &rf_link.stat;
+
+    PRINT("\n==== RF link: %s, queue %d ====\n", RfLink_IsUp(&rf_link) ? "up" : "down",
+          RfLink_QueueDepth(&rf_link));
+    PRINT("tx %lu, retrans %lu, keepalive %lu, rx %lu, dup %lu, resync %lu\n",
+          st->frames_tx, st->retrans, st->keepalives, st->frames_rx, st->duplicates, st->resyncs);
+    PRINT("reports %lu, acked %lu, superseded %lu, delivered %lu\n",
+          st->submitted, st->acked, st->superseded, st->delivered);
+    if (st->acked) {
+        PRINT("submit->ack avg %lu.%02lu max %lu ms; 1:%lu 2:%lu 3-4:%lu 5+:%lu\n",
+              st->lat_sum / st->acked, (st->lat_sum % st->acked) * 100 / st->acked, st->lat_max,
+              st->lat_hist[0], st->lat_hist[1], st->lat_hist[2], st->lat_hist[3]);
+    }
+    tmos_memset(st, 0, sizeof(*st));
+}
+
+#endif /* ENABLE_RF_LINK */
@@ -0,0 +1,242 @@
+/*********************************************************************
+ * File Name          : synth_input.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 合成输入生成器 (DEBUG_SYNTH_INPUT 测试模式)
+ *                      - 蓝牙连接后按预设表逐段运行，每段 SYNTH_PHASE_MS：
+ *                        按键沿按固定间隔成组生成 (按下/松开交替，键码 a~z 轮换)，
+ *                        鼠标按固定间隔生成位移，沿正方形轨迹移动不漂出屏幕
+ *                      - 生成的数据从 USB_Bridge_Poll 的输入交接点进入发送路径，
+ *                        与真实 USB 数据经过同样的解析、去重、队列与聚合
+ *                      - 每段结束或连接参数变化时通过 UART 输出：
+ *                        生成数、实际发送数与速率、发送失败重试、队满覆写、队列最大深度、
+ *                        键鼠合并报文数与总通知速率 (合并报文只算一个通知)
+ *                      - 生成速率受 USB 轮询周期限制，每次轮询最多产生一个按键沿和一个鼠标样本
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "synth_input.h"
+
+#ifdef DEBUG_SYNTH_INPUT
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define SYNTH_PHASE_MS            10000   // 每个预设的运行时长
+#define SYNTH_MOUSE_LEG           64      // 鼠标每条边的样本数 (之后转 90 度)
+#define SYNTH_KEY_FIRST           0x04    // 轮换键码范围: a
+#define SYNTH_KEY_LAST            0x1D    //               z
+
+// ===================================================================
+// 预设表 (按顺序循环运行)
+// ===================================================================
+typedef struct {
+    uint16_t key_period_ms;     // 按键沿间隔 (0 = 不生成按键)
+    uint8_t  key_burst;         // 每组连续沿数 (0 = 不分组)
+    uint16_t key_gap_ms;        // 组间停顿
+    uint16_t mouse_period_ms;   // 鼠标样本间隔 (0 = 不生成鼠标)
+    int8_t   mouse_step;        // 每个样本的位移
+} SynthPreset_t;
+
+static const SynthPreset_t synth_presets[] = {
+    // key_ms burst gap_ms  mouse_ms step
+    {  100,    0,    0,     0,       0 },   // 正常打字：10 沿/s
+    {  10,     20,   500,   0,       0 },   // 快速连击：20 沿 @100 沿/s，停 0.5s
+    {  1,      0,    0,     0,       0 },   // 按键饱和：每次轮询一个沿
+    {  0,      0,    0,     8,       4 },   // 鼠标 125Hz
+    {  0,      0,    0,     1,       1 },   // 鼠标饱和：每次轮询一个样本
+    {  20,     10,   200,   8,       4 },   // 键鼠混合
+};
+#define SYNTH_PRESET_NUM          (sizeof(synth_presets) / sizeof(synth_presets[0]))
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+typedef struct {
+    uint16_t key_gen;               // 生成的按键沿
+    uint16_t mouse_gen;             // 生成的鼠标样本
+    uint16_t count[SYNTH_STAT_NUM]; // 发送路径上报的计数 (饱和)
+    uint8_t  queue_max;             // 键盘队列最大深度
+} SynthStat_t;
+
+static uint8_t     synth_running  = FALSE;
+static uint8_t     synth_preset   = 0;
+static uint16_t    synth_interval = 0;     // 当前连接间隔 (1.25ms 单位)
+static uint16_t    synth_latency  = 0;
+static uint32_t    phase_start    = 0;     // 本段开始时刻 (TMOS tick)
+static SynthStat_t synth_stat;
+
+static uint32_t    key_next       = 0;     // 下一个按键沿时刻
+static uint8_t     key_in_burst   = 0;     // 本组已生成的沿数
+static uint8_t     key_down       = FALSE;
+static uint8_t     key_code       = SYNTH_KEY_FIRST;
+
+static uint32_t    mouse_next     = 0;     // 下一个鼠标样本时刻
+static uint8_t     mouse_sample   = 0;     // 当前边已生成的样本数
+static uint8_t     mouse_dir      = 0;     // 0 右 / 1 下 / 2 左 / 3 上
+
+// ===================================================================
+// 分段管理
+// ===================================================================
+
+static void SynthIn_StartPhase(uint8_t preset)
+{
+    uint32_t now = TMOS_GetSystemClock();
+
+    synth_preset = preset;
+    phase_start  = now;
+    memset(&synth_stat, 0, sizeof(synth_stat));
+
+    key_next     = now;
+    key_in_burst = 0;
+    mouse_next   = now;
+    mouse_sample = 0;
+    mouse_dir    = 0;
+}
+
+/**
+ * @brief 输出本段统计 (速率按本段实际时长折算)
+ */
+static void SynthIn_Report(void)
+{
+#ifdef DEBUG
+    const SynthStat_t *st = &synth_stat;
+    uint32_t ms = (TMOS_GetSystemClock() - phase_start) * 5 / 8;
+    uint32_t noti = (uint32_t)st->count[SYNTH_KEY_SENT] + st->count[SYNTH_MOUSE_SENT];
+
+    if (ms == 0) return;
+    PRINT("SYNTH p%d int %d lat %d %lums | key gen %u sent %u (%lu/s) retry %u drop %u merge %u hold %u qmax %u"
+          " | mouse gen %u sent %u (%lu/s) retry %u | combo %u noti %lu/s\n",
+          synth_preset, synth_interval, synth_latency, ms,
+          st->key_gen, st->count[SYNTH_KEY_SENT], st->count[SYNTH_KEY_SENT] * 1000UL / ms,
+          st->count[SYNTH_KEY_RETRY], st->count[SYNTH_KEY_DROP], st->count[SYNTH_KEY_MERGE],
+          st->count[SYNTH_BACKLOG_HOLD], st->queue_max,
+          st->mouse_gen, st->count[SYNTH_MOUSE_SENT], st->count[SYNTH_MOUSE_SENT] * 1000UL / ms,
+          st->count[SYNTH_MOUSE_RETRY], st->count[SYNTH_COMBO_SENT], noti * 1000UL / ms);
+#endif
+}
+
+/**
+ * @brief 时刻是否已到 (按差值比较，兼容计数回绕)
+ */
+static uint8_t SynthIn_Due(uint32_t now, uint32_t t)
+{
+    return ((int32_t)(now - t) >= 0);
+}
+
+/**
+ * @brief 推进下一个时刻：落后超过一个周期时不补发，从当前时刻重新计时
+ */
+static uint32_t SynthIn_Next(uint32_t now, uint32_t t, uint16_t ms)
+{
+    t += MS1_TO_SYSTEM_TIME(ms);
+    return SynthIn_Due(now, t) ? now : t;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 生成本次轮询的输入 (由 USB_Bridge_Poll 在测试模式下调用)
+ * @param kbd_raw    输出标准 8 字节键盘报文
+ * @param mouse_data 输出 [Btn, X, Y, Wheel]
+ * @return SYNTH_HAS_KEY / SYNTH_HAS_MOUSE 的组合
+ */
+uint8_t SynthIn_Poll(uint8_t *kbd_raw, uint8_t *mouse_data)
+{
+    const SynthPreset_t *pre = &synth_presets[synth_preset];
+    uint32_t now = TMOS_GetSystemClock();
+    uint8_t  has = 0;
+
+    if (!synth_running) return 0;
+
+    // 1. 段结束：先松开按住的键，再输出统计并切换到下一个预设
+    if ((now - phase_start) >= MS1_TO_SYSTEM_TIME(SYNTH_PHASE_MS)) {
+        if (key_down) {
+            key_down = FALSE;
+            memset(kbd_raw, 0, 8);
+            return SYNTH_HAS_KEY;
+        }
+        SynthIn_Report();
+        SynthIn_StartPhase((synth_preset + 1) % SYNTH_PRESET_NUM);
+        return 0;
+    }
+
+    // 2. 按键沿：按下/松开交替，松开后换下一个键码
+    if (pre->key_period_ms && SynthIn_Due(now, key_next)) {
+        memset(kbd_raw, 0, 8);
+        if (!key_down) {
+            kbd_raw[2] = key_code;
+        } else if (++key_code > SYNTH_KEY_LAST) {
+            key_code = SYNTH_KEY_FIRST;
+        }
+        key_down = !key_down;
+        synth_stat.key_gen++;
+        has |= SYNTH_HAS_KEY;
+
+        if (pre->key_burst && ++key_in_burst >= pre->key_burst) {
+            key_in_burst = 0;
+            key_next = now + MS1_TO_SYSTEM_TIME(pre->key_gap_ms);
+        } else {
+            key_next = SynthIn_Next(now, key_next, pre->key_period_ms);
+        }
+    }
+
+    // 3. 鼠标位移：沿正方形轨迹移动
+    if (pre->mouse_period_ms && SynthIn_Due(now, mouse_next)) {
+        int8_t step = pre->mouse_step;
+
+        mouse_data[0] = 0;
+        mouse_data[1] = (uint8_t)((mouse_dir == 0) ? step : (mouse_dir == 2) ? -step : 0);
+        mouse_data[2] = (uint8_t)((mouse_dir == 1) ? step : (mouse_dir == 3) ? -step : 0);
+        mouse_data[3] = 0;
+        if (++mouse_sample >= SYNTH_MOUSE_LEG) {
+            mouse_sample = 0;
+            mouse_dir    = (mouse_dir + 1) & 0x03;
+        }
+        synth_stat.mouse_gen++;
+        has |= SYNTH_HAS_MOUSE;
+
+        mouse_next = SynthIn_Next(now, mouse_next, pre->mouse_period_ms);
+    }
+
+    return has;
+}
+
+/**
+ * @brief 发送路径计数 (SYNTH_COUNT)
+ */
+void SynthIn_Count(uint8_t stat)
+{
+    if (stat < SYNTH_STAT_NUM && synth_stat.count[stat] < 0xFFFF) {
+        synth_stat.count[stat]++;
+    }
+}
+
+/**
+ * @brief 键盘报文入队后的队列深度 (SYNTH_QUEUE)
+ */
+void SynthIn_QueueDepth(uint8_t depth)
+{
+    if (depth > synth_stat.queue_max) synth_stat.queue_max = depth;
+}
+
+/**
+ * @brief 连接参数变化 (SYNTH_CONN_PARAMS)
+ *        输出当前段统计；连接建立/参数更新后从当前预设重新开始，断开时停止生成
+ */
+void SynthIn_ConnParams(uint16_t connInterval, uint16_t connLatency)
+{
+    if (synth_running) {
+        SynthIn_Report();
+    }
+
+    synth_interval = connInterval;
+    synth_latency  = connLatency;
+    synth_running  = (connInterval != 0);
+    if (synth_running) {
+        SynthIn_StartPhase(synth_preset);
+    }
+}
+
+#endif /* DEBUG_SYNTH_INPUT */
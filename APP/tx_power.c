@@ -0,0 +1,222 @@
+/*********************************************************************
+ * File Name          : tx_power.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 发射功率自适应
+ *                      - 连接期间每秒读取一次 RSSI，滑动平均后与上下门限比较
+ *                      - 信号强则逐级降功率，信号弱立即升功率，门限间留迟滞带防止振荡
+ *                      - 控制器未应答包数持续积压视为重传，立即升功率并暂停下调
+ *                      - 按读数统计平均发射功率，与固定 BLE_TX_POWER 对比记账
+ *                      - 断开后恢复默认功率，保证广播/回连距离
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "tx_power.h"
+#include "hidkbd.h"
+#include "debug.h"
+#include "evt_mon.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define TXPWR_DBM_MIN             (-12)   // 允许的最低发射功率 (dBm)
+#define TXPWR_DBM_MAX             4       // 允许的最高发射功率 (dBm)
+#define TXPWR_RSSI_HIGH           (-55)   // 平均 RSSI 高于此值降一级 (桌面近距离)
+#define TXPWR_RSSI_LOW            (-75)   // 平均 RSSI 低于此值升一级
+#define TXPWR_HOLD_READS          3       // 每次调整后至少间隔几次读数才允许再次下调
+#define TXPWR_UNACK_LIMIT         2       // 未应答包数达到此值视为积压
+#define TXPWR_UNACK_STREAK        2       // 连续几次积压判定为重传
+#define TXPWR_REPORT_READS        60      // 每多少次读数输出一次功率统计
+
+// ===================================================================
+// TMOS 任务事件位定义 (Task Events)
+// ===================================================================
+#define TXPWR_RSSI_READ_EVT       0x0001  // 周期读取 RSSI
+
+// ===================================================================
+// 功率档位表 (由低到高)
+// ===================================================================
+typedef struct {
+    int8_t  dbm;
+    uint8_t reg;
+} TxPowerLevel_t;
+
+static const TxPowerLevel_t tx_levels[] = {
+    {-16, LL_TX_POWEER_MINUS_16_DBM}, {-12, LL_TX_POWEER_MINUS_12_DBM},
+    { -8, LL_TX_POWEER_MINUS_8_DBM},  { -5, LL_TX_POWEER_MINUS_5_DBM},
+    { -3, LL_TX_POWEER_MINUS_3_DBM},  { -1, LL_TX_POWEER_MINUS_1_DBM},
+    {  0, LL_TX_POWEER_0_DBM},        {  1, LL_TX_POWEER_1_DBM},
+    {  2, LL_TX_POWEER_2_DBM},        {  3, LL_TX_POWEER_3_DBM},
+    {  4, LL_TX_POWEER_4_DBM},        {  5, LL_TX_POWEER_5_DBM},
+    {  6, LL_TX_POWEER_6_DBM},
+};
+#define TX_LEVEL_NUM              (sizeof(tx_levels) / sizeof(tx_levels[0]))
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static uint8_t  txPowerTaskId = INVALID_TASK_ID;
+static uint16_t conn_handle   = GAP_CONNHANDLE_INIT;
+static uint8_t  level_default = 0;   // BLE_TX_POWER 对应档位
+static uint8_t  level_min     = 0;
+static uint8_t  level_max     = 0;
+static uint8_t  level_cur     = 0;
+
+static int16_t  rssi_avg_x4   = 0;   // RSSI 滑动平均 (x4 定点, alpha = 1/4)
+static uint8_t  rssi_valid    = FALSE;
+static uint8_t  hold_reads    = 0;   // 剩余禁止下调的读数
+static uint8_t  unack_streak  = 0;   // 连续积压次数
+
+// --- 功率记账 ---
+static int32_t  acct_dbm_sum  = 0;   // 每次读数时的发射功率累加 (dBm)
+static uint16_t acct_reads    = 0;   // 读数次数
+static uint16_t acct_retries  = 0;   // 判定为重传而升功率的次数
+
+// ===================================================================
+// 档位操作
+// ===================================================================
+
+/**
+ * @brief 查找不低于指定 dBm 的最低档位
+ */
+static uint8_t TxPower_FindLevel(int8_t dbm)
+{
+    uint8_t i;
+    for (i = 0; i < TX_LEVEL_NUM - 1; i++) {
+        if (tx_levels[i].dbm >= dbm) break;
+    }
+    return i;
+}
+
+static void TxPower_Apply(uint8_t level)
+{
+    if (level == level_cur) return;
+    level_cur = level;
+    LL_SetTxPowerLevel(tx_levels[level].reg);
+    LOG_BLE("TX power -> %d dBm\n", tx_levels[level].dbm);
+}
+
+/**
+ * @brief 输出平均发射功率与重传次数，并清零统计窗口
+ */
+static void TxPower_Report(void)
+{
+    if (acct_reads == 0) return;
+    LOG_BLE("TX power avg %d dBm x10 over %d s (fixed %d dBm), retries %d\n",
+            (int)(acct_dbm_sum * 10 / acct_reads), acct_reads,
+            tx_levels[level_default].dbm, acct_retries);
+    acct_dbm_sum = 0;
+    acct_reads   = 0;
+    acct_retries = 0;
+}
+
+// ===================================================================
+// 控制环
+// ===================================================================
+
+/**
+ * @brief RSSI 读数回调 (由 hiddev 的 GAPRole RSSI 回调转发)
+ */
+void TxPower_OnRssi(uint16_t connHandle, int8_t rssi)
+{
+    int16_t avg;
+
+    if (connHandle != conn_handle) return;
+
+    // 1. 滑动平均，首个读数直接作为初值
+    if (!rssi_valid) {
+        rssi_avg_x4 = rssi * 4;
+        rssi_valid  = TRUE;
+    } else {
+        rssi_avg_x4 += rssi - rssi_avg_x4 / 4;
+    }
+    avg = rssi_avg_x4 / 4;
+
+    // 2. 可靠性反馈：未应答包持续积压说明对端没收到，立即升功率并延长下调禁止期
+    if (LL_GetNumberOfUnAckPacket(connHandle) >= TXPWR_UNACK_LIMIT) {
+        unack_streak++;
+    } else {
+        unack_streak = 0;
+    }
+
+    if (unack_streak >= TXPWR_UNACK_STREAK) {
+        unack_streak = 0;
+        acct_retries++;
+        if (level_cur < level_max) TxPower_Apply(level_cur + 1);
+        hold_reads = TXPWR_HOLD_READS * 4;
+    }
+    // 3. 迟滞控制：弱信号立即升一级，强信号在保持期过后降一级
+    else if (avg < TXPWR_RSSI_LOW) {
+        if (level_cur < level_max) TxPower_Apply(level_cur + 1);
+        hold_reads = TXPWR_HOLD_READS;
+    } else if (avg > TXPWR_RSSI_HIGH && hold_reads == 0) {
+        if (level_cur > level_min) TxPower_Apply(level_cur - 1);
+        hold_reads = TXPWR_HOLD_READS;
+    } else if (hold_reads) {
+        hold_reads--;
+    }
+
+    // 4. 记账
+    acct_dbm_sum += tx_levels[level_cur].dbm;
+    if (++acct_reads >= TXPWR_REPORT_READS) {
+        TxPower_Report();
+    }
+}
+
+static uint16_t TxPower_ProcessEvent(uint8_t task_id, uint16_t events)
+{
+    if (events & TXPWR_RSSI_READ_EVT) {
+        if (conn_handle != GAP_CONNHANDLE_INIT) {
+            GAPRole_ReadRssiCmd(conn_handle);
+            tmos_start_task(txPowerTaskId, TXPWR_RSSI_READ_EVT, TIME_TXPWR_RSSI_INTERVAL);
+        }
+        return (events ^ TXPWR_RSSI_READ_EVT);
+    }
+
+    return 0;
+}
+
+// ===================================================================
+// 初始化与连接管理
+// ===================================================================
+
+EVT_MON_DEFINE(TxPower_ProcessEvent, EVT_MON_TASK_TXPWR)
+
+void TxPower_Init(void)
+{
+    txPowerTaskId = TMOS_ProcessEventRegister(EVT_MON_FN(TxPower_ProcessEvent));
+
+    level_min = TxPower_FindLevel(TXPWR_DBM_MIN);
+    level_max = TxPower_FindLevel(TXPWR_DBM_MAX);
+    for (level_default = 0; level_default < TX_LEVEL_NUM - 1; level_default++) {
+        if (tx_levels[level_default].reg == BLE_TX_POWER) break;
+    }
+    level_cur = level_default;
+}
+
+/**
+ * @brief 连接建立：从默认功率开始闭环调节
+ */
+void TxPower_Start(uint16_t connHandle)
+{
+    conn_handle  = connHandle;
+    rssi_valid   = FALSE;
+    hold_reads   = TXPWR_HOLD_READS;
+    unack_streak = 0;
+    acct_dbm_sum = 0;
+    acct_reads   = 0;
+    acct_retries = 0;
+    tmos_start_task(txPowerTaskId, TXPWR_RSSI_READ_EVT, TIME_TXPWR_RSSI_INTERVAL);
+}
+
+/**
+ * @brief 连接断开：停止调节并恢复默认功率
+ */
+void TxPower_Stop(void)
+{
+    if (conn_handle == GAP_CONNHANDLE_INIT) return;
+
+    tmos_stop_task(txPowerTaskId, TXPWR_RSSI_READ_EVT);
+    TxPower_Report();
+    conn_handle = GAP_CONNHANDLE_INIT;
+    TxPower_Apply(level_default);
+}
@@ -11,6 +11,19 @@
 #include "CH58x_common.h"
 #include "debug.h"
 #include "hidkbd.h"
+#include "hidkbdservice.h"
+#include "usb_bridge.h"
+#include "power.h"
+#include "enum_cache.h"
+#include "usb_hub.h"
+#include "usb_device.h"
+#include "usb_capture.h"
+#include "conn_trace.h"
+#include "rf_output.h"
+#include "synth_input.h"
+#include "clk_scale.h"
+#include "abs_pointer.h"
+#include "gamepad.h"
 
 // ===================================================================
 // ? 用户配置区 (User Configuration)
@@ -20,6 +33,18 @@
 #define NIZ_KEY_OFFSET    4       // 键码偏移补偿
 #define NIZ_MOUSE_ENDP    0x84    // 强制指定的鼠标端点 (Interface 2)
 
+// 连接间隔自适应 (连接间隔单位 1.25ms = 2 TMOS ticks)
+#define BRIDGE_DEFAULT_CONN_INTERVAL  8     // 未连接时假定的连接间隔: 10ms
+#define BRIDGE_POLL_TICKS_MAX         16    // 活跃轮询周期上限: 10ms (保证短击不漏)
+#define KBD_QUEUE_MAX                 8     // 键盘报文队列最大深度
+#define KBD_RPT_MAX_LEN               HID_NKRO_IN_RPT_LEN  // 键盘报文最大长度 (NKRO)
+#define ABS_QUEUE_MAX                 8     // 数位笔样本队列最大深度
+#define BRIDGE_BACKLOG_HIGH           2     // 控制器未确认包数达到此值进入合并模式 (报文留在桥接层)
+
+// 设备插入后等待电源稳定的时间 (冷恢复时设备一直供电，可跳过)
+#define USB_ATTACH_SETTLE_MS          200
+#define USB_ATTACH_SETTLE_CACHED_MS   10    // 有枚举缓存时的等待，未命中回退完整枚举 (自带 100ms 稳定等待)
+
 // ===================================================================
 // ? 全局变量与缓冲区
 // ===================================================================
@@ -30,15 +55,64 @@ __attribute__((aligned(4))) uint8_t TxBuffer[MAX_PACKET_SIZE];
 
 // --- 状态标志 ---
 volatile uint8_t Bridge_NewDevFlag = 0; // 新设备插入事件标志
+static uint8_t  skip_attach_settle = 0; // 冷恢复：首次枚举跳过电源稳定等待
+static uint32_t attach_tick = 0;        // 设备插入时刻 (TMOS tick)
+static uint8_t  attach_key_pending = 0; // 插入后尚未送达首个按键
+static uint8_t  out_wired = 0;          // 当前输出通道：1 = USB 设备口, 0 = 蓝牙 (2.4G 模式下为私有链路)
+
+// 无线输出是否走蓝牙：2.4G 模式下射频由 rf_output.c 独占，蓝牙不发报文
+#ifdef ENABLE_RF_LINK
+#define OUT_BLE()                     0
+#else
+#define OUT_BLE()                     (!out_wired)
+#endif
+
+// 置位设备远程唤醒 (SET_FEATURE DEVICE_REMOTE_WAKEUP)
+__attribute__((aligned(4))) static const uint8_t SetupSetU2RemoteWakeup[] = {
+    USB_REQ_TYP_OUT | USB_REQ_RECIP_DEVICE, USB_SET_FEATURE, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// --- 连接间隔派生参数 (由 USB_Bridge_SetConnParams 更新) ---
+static uint16_t poll_ticks      = BRIDGE_DEFAULT_CONN_INTERVAL;      // 活跃 USB 轮询周期 (tick)
+static uint16_t mouse_window    = BRIDGE_DEFAULT_CONN_INTERVAL * 2;  // 鼠标聚合窗口 (tick)
+static uint8_t  kbd_queue_depth = 2;                                 // 键盘队列有效深度
 
 // --- 键盘状态 ---
-static uint8_t  last_kbd_report[8] = {0}; // 键盘上次数据(去重用)
-static uint8_t  kbd_send_pending = 0;     // 键盘流控重发标志
+static uint8_t  last_kbd_report[KBD_RPT_MAX_LEN] = {0};  // 键盘上次数据(去重用)
+static uint8_t  last_kbd_len = 8;                        // 当前键盘报文格式 (8 = 标准, NKRO 长度)
+static uint8_t  kbd_sent_report[KBD_RPT_MAX_LEN] = {0};  // 最近一次交给协议栈的键盘报文 (合并判断基准)
+static uint8_t  kbd_sent_len = 8;
+static uint8_t  kbd_queue[KBD_QUEUE_MAX][KBD_RPT_MAX_LEN]; // 蓝牙忙时待发的键盘报文 (FIFO)
+static uint8_t  kbd_queue_len[KBD_QUEUE_MAX];            // 各报文长度
+static uint8_t  kbd_queue_head  = 0;                 // 队首下标
+static uint8_t  kbd_queue_count = 0;                 // 队列中报文数
 
-// --- 鼠标状态 ---
-static uint8_t  last_mouse_report[4] = {0};     // 鼠标上次数据 (去重用)
-static uint8_t  mouse_send_pending = 0;          // 鼠标流控：有待发帧
-static uint8_t  pending_mouse_report[4] = {0};  // 待发帧缓存（最新帧覆写）
+// --- 鼠标状态 (按连接间隔聚合位移，避免覆写丢帧) ---
+static int16_t  mouse_acc_x = 0, mouse_acc_y = 0, mouse_acc_wheel = 0; // 未发出的累计位移
+static uint8_t  mouse_acc_btn   = 0;     // 最新按键状态
+static uint8_t  mouse_sent_btn  = 0;     // 已发出的按键状态
+static uint8_t  mouse_acc_dirty = 0;     // 有未发出的数据
+static uint32_t mouse_last_send = 0;     // 上次成功发送的时刻 (TMOS tick)
+
+#ifdef ENABLE_COMBO_REPORT
+// 键鼠合并报文 (ID 4) 在主机上是独立的键盘+指针集合，按下与释放必须走同一个报告 ID：
+// ID 4 中仍有按住的键或鼠标按键时，键盘和鼠标都继续用 ID 4，全部释放后才回到 ID 1/2
+static uint8_t  combo_sent[HID_COMBO_IN_RPT_LEN]; // 上次发出的合并报文
+static uint8_t  combo_held = 0;          // combo_sent 中有按住的键或鼠标按键
+#endif
+
+// 数位笔：绝对坐标不能累加，每个样本都是笔迹上的一个点，按连接间隔缓冲后依次发出
+static uint8_t  abs_queue[ABS_QUEUE_MAX][HID_ABS_IN_RPT_LEN]; // 蓝牙忙时待发的样本 (FIFO)
+static uint8_t  abs_queue_head  = 0;     // 队首下标
+static uint8_t  abs_queue_count = 0;     // 队列中样本数
+static uint8_t  abs_last[HID_ABS_IN_RPT_LEN] = {0}; // 上次收到的样本 (去重用)
+
+// 手柄：状态量只保留最新一帧，按键变化立即发送，轴变化按连接间隔合并
+static uint8_t  gp_state[HID_GAMEPAD_IN_RPT_LEN];  // 最新状态
+static uint8_t  gp_sent[HID_GAMEPAD_IN_RPT_LEN];   // 已发出的状态
+static uint8_t  gp_dirty  = 0;           // 有未发出的变化
+static uint8_t  gp_urgent = 0;           // 未发出的变化含按键，不等合并窗口
+static uint32_t gp_last_send = 0;        // 上次成功发送的时刻 (TMOS tick)
 
 // NiZ 鼠标专用同步记录变量
 // Bit7=同步位(0=DATA0, 1=DATA1), Bit0-6=端点号，初始期望 DATA0
@@ -48,15 +122,520 @@ static uint8_t  Var_NizMouse_Record = (NIZ_MOUSE_ENDP & 0x7F);
 // ? 外部函数引用
 // ===================================================================
 extern uint8_t HidEmu_SendUSBReport(uint8_t *pData);
+extern uint8_t HidEmu_SendNkroReport(uint8_t *pData);
+extern uint8_t HidEmu_GetKeyReportLen(void);
 extern uint8_t HidEmu_SendMouseReport(uint8_t *pData);
+extern uint8_t HidEmu_SendAbsReport(uint8_t *pData);
+extern uint8_t HidEmu_SendGamepadReport(uint8_t *pData);
+extern uint8_t HidEmu_GetBacklog(void);
+extern uint8_t HidEmu_IsConnected(void);
+#ifdef ENABLE_COMBO_REPORT
+extern uint8_t HidEmu_SendComboReport(uint8_t *pData);
+extern uint8_t HidEmu_ComboAvailable(void);
+#endif
 extern uint8_t InitRootU2Device(void);
 extern uint8_t AnalyzeRootU2Hub(void);
-extern uint8_t EnumAllU2HubPort(void);
 extern uint16_t U2SearchTypeDevice(uint8_t type);
 extern void SelectU2HubPort(uint8_t hub_port);
 extern uint8_t HidEmu_ResetIdleTimer(void);
 
 
+// ===================================================================
+// ? 连接参数自适应
+// ===================================================================
+
+/**
+ * @brief  发布主机实际授予的连接参数，派生桥接层的节拍
+ * @param  connInterval  连接间隔 (1.25ms 单位, 0 表示断开恢复默认)
+ * @param  connLatency   从机延迟
+ * @note   - USB 轮询: 每个连接间隔采样两次，上限 10ms
+ *         - 鼠标聚合: 一个连接间隔内的位移合并为一帧
+ *         - 键盘队列: 每 10ms 间隔预留一个槽位，保证快速连击不丢
+ */
+void USB_Bridge_SetConnParams(uint16_t connInterval, uint16_t connLatency) {
+    // 合成输入测试：每组连接参数单独统计 (0 = 断开，停止生成)
+    SYNTH_CONN_PARAMS(connInterval, connLatency);
+
+    if (connInterval == 0) connInterval = BRIDGE_DEFAULT_CONN_INTERVAL;
+
+    // 连接间隔 (tick) = connInterval * 2，半个间隔 = connInterval
+    poll_ticks = connInterval;
+    if (poll_ticks < TIME_USB_POLL_ACTIVE)   poll_ticks = TIME_USB_POLL_ACTIVE;
+    if (poll_ticks > BRIDGE_POLL_TICKS_MAX)  poll_ticks = BRIDGE_POLL_TICKS_MAX;
+
+    mouse_window = connInterval * 2;
+
+    kbd_queue_depth = 1 + connInterval / 8;
+    if (kbd_queue_depth > KBD_QUEUE_MAX) kbd_queue_depth = KBD_QUEUE_MAX;
+
+    LOG_USB("Bridge: Int %d Lat %d -> poll %d, mouse win %d, kbd q %d\n",
+            connInterval, connLatency, poll_ticks, mouse_window, kbd_queue_depth);
+}
+
+/**
+ * @brief  当前活跃 USB 轮询周期 (TMOS tick)
+ */
+uint16_t USB_Bridge_GetPollTicks(void) {
+    uint16_t abs_ticks = AbsPtr_GetPollTicks();
+    uint16_t gp_ticks  = (U2SearchTypeDevice(DEV_TYPE_GAMEPAD) != 0xFFFF) ? Gamepad_GetPollTicks() : 0;
+    uint16_t ticks     = poll_ticks;
+
+    if (!OUT_BLE()) return TIME_USB_POLL_WIRED;
+    // 数位板按其端点间隔轮询，设备端缓冲只有一帧，轮询慢了笔迹点会被覆盖
+    if (abs_ticks && abs_ticks < ticks) ticks = abs_ticks;
+    // 手柄按端点间隔轮询 (不慢于 250Hz)
+    if (gp_ticks && gp_ticks < ticks)   ticks = gp_ticks;
+    return ticks;
+}
+
+/**
+ * @brief  键盘队列中待发报文数 (延迟探测服务随回显上报)
+ */
+uint8_t USB_Bridge_GetQueueDepth(void) {
+    return kbd_queue_count;
+}
+
+// ===================================================================
+// ? 发送缓冲：键盘队列 / 鼠标聚合
+// ===================================================================
+
+/**
+ * @brief  控制器发送积压是否达到门限 (合并模式)
+ * @note   积压时新报文留在桥接层合并/排队，控制器队列保持很浅，
+ *         积压消退后最先发出的是键盘队列，按键沿不用排在鼠标位移之后
+ *         每轮都会多处轮询，SYNTH_BACKLOG_HOLD 只在新报文因积压被留下的调用处计数
+ */
+static uint8_t Bridge_Backlogged(void) {
+    if (!OUT_BLE()) return 0;
+    return (HidEmu_GetBacklog() >= BRIDGE_BACKLOG_HIGH);
+}
+
+/**
+ * @brief  由聚合缓冲生成一帧鼠标报文，超出 int8 范围的位移留到下一帧
+ */
+static void Mouse_Build(uint8_t *report) {
+    int16_t dx = mouse_acc_x, dy = mouse_acc_y, dw = mouse_acc_wheel;
+
+    if (dx >  127) dx =  127;
+    if (dx < -127) dx = -127;
+    if (dy >  127) dy =  127;
+    if (dy < -127) dy = -127;
+    if (dw >  127) dw =  127;
+    if (dw < -127) dw = -127;
+
+    report[0] = mouse_acc_btn;
+    report[1] = (uint8_t)(int8_t)dx;
+    report[2] = (uint8_t)(int8_t)dy;
+    report[3] = (uint8_t)(int8_t)dw;
+}
+
+/**
+ * @brief  鼠标报文发送成功后，从聚合缓冲扣除已发出的部分
+ */
+static void Mouse_Commit(uint8_t *report) {
+    mouse_acc_x     -= (int8_t)report[1];
+    mouse_acc_y     -= (int8_t)report[2];
+    mouse_acc_wheel -= (int8_t)report[3];
+    mouse_sent_btn   = report[0];
+    mouse_acc_dirty  = (mouse_acc_x || mouse_acc_y || mouse_acc_wheel);
+    mouse_last_send  = TMOS_GetSystemClock();
+}
+
+#ifdef ENABLE_COMBO_REPORT
+/**
+ * @brief  发送键鼠合并报文：键盘部分取 report，鼠标部分取聚合缓冲
+ */
+static uint8_t Combo_Send(const uint8_t *report) {
+    static const uint8_t empty[8] = {0};
+    uint8_t combo[HID_COMBO_IN_RPT_LEN];
+    uint8_t status;
+
+    memcpy(combo, report, 8);
+    Mouse_Build(combo + 8);
+    status = HidEmu_SendComboReport(combo);
+    if (status == SUCCESS) {
+        Mouse_Commit(combo + 8);
+        memcpy(combo_sent, combo, HID_COMBO_IN_RPT_LEN);
+        combo_held = (memcmp(combo, empty, 8) != 0 || combo[8] != 0);
+        SYNTH_COUNT(SYNTH_COMBO_SENT);
+    }
+    return status;
+}
+
+/**
+ * @brief  释放 ID 4 中按住的键/按键 (合并报文不再可用时，尽力发送全零报文，不排队)
+ *         之后键盘与鼠标按键按当前状态改走 ID 1/3 与 ID 2 重新按下
+ */
+static void Combo_Release(void) {
+    uint8_t combo[HID_COMBO_IN_RPT_LEN] = {0};
+
+    HidEmu_SendComboReport(combo);
+    memset(combo_sent, 0, sizeof(combo_sent));
+    memset(kbd_sent_report, 0, sizeof(kbd_sent_report));
+    mouse_sent_btn = 0;
+    combo_held = 0;
+}
+
+/**
+ * @brief  NKRO 位图转为标准 6 键报文 (超过 6 键时只取前 6 个)
+ * @return 位图中按下的键数
+ */
+static uint8_t Kbd_NkroToBoot(const uint8_t *nkro, uint8_t *boot) {
+    uint8_t n = 0;
+
+    memset(boot, 0, 8);
+    boot[0] = nkro[0];
+    for (uint16_t code = 0; code <= HID_NKRO_KEY_MAX; code++) {
+        if (nkro[1 + code / 8] & (1 << (code % 8))) {
+            if (n < 6) boot[2 + n] = (uint8_t)code;
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief  键盘报文是否改走合并报文
+ *         ID 4 中仍有按住的键/按键时必须继续用 ID 4 (NKRO 格式下超出 6 键的部分忽略)；
+ *         否则仅在鼠标也有未发出的数据、ID 1/2/3 中没有按住的键/按键、且按下的键不超过
+ *         6 个时才切入 (按下与释放不会分到两个集合)。合并报文不再可用时先释放 ID 4
+ */
+static uint8_t Combo_UseForKbd(const uint8_t *report, uint8_t len) {
+    static const uint8_t empty[KBD_RPT_MAX_LEN] = {0};
+    uint8_t boot[8];
+
+    if (!HidEmu_ComboAvailable()) {
+        if (combo_held) Combo_Release();
+        return 0;
+    }
+    if (combo_held) return 1;
+    if (len == HID_NKRO_IN_RPT_LEN && Kbd_NkroToBoot(report, boot) > 6) return 0;
+    return (mouse_acc_dirty && mouse_sent_btn == 0 &&
+            memcmp(kbd_sent_report, empty, kbd_sent_len) == 0);
+}
+
+/**
+ * @brief  键盘报文经合并报文发送 (NKRO 位图先转为标准 6 键)
+ */
+static uint8_t Combo_SendKbd(const uint8_t *report, uint8_t len) {
+    uint8_t boot[8];
+
+    if (len == HID_NKRO_IN_RPT_LEN) {
+        Kbd_NkroToBoot(report, boot);
+        return Combo_Send(boot);
+    }
+    return Combo_Send(report);
+}
+#endif
+
+/**
+ * @brief  按报文长度选择标准或 NKRO 报告发送
+ *         同一聚合窗口内鼠标也有变化时优先改用键鼠合并报文 (ENABLE_COMBO_REPORT，
+ *         见 Combo_UseForKbd)
+ */
+static uint8_t Kbd_Send(uint8_t *report, uint8_t len) {
+    uint8_t status;
+
+    if (out_wired) {
+        status = UsbDev_SendKeyboard(report);
+#ifdef ENABLE_RF_LINK
+    } else if (!OUT_BLE()) {
+        status = RfOut_SendKeyboard(report);
+#endif
+#ifdef ENABLE_COMBO_REPORT
+    } else if (Combo_UseForKbd(report, len)) {
+        status = Combo_SendKbd(report, len);
+#endif
+    } else if (len == HID_NKRO_IN_RPT_LEN) {
+        status = HidEmu_SendNkroReport(report);
+    } else {
+        status = HidEmu_SendUSBReport(report);
+    }
+
+    SYNTH_COUNT(status == SUCCESS ? SYNTH_KEY_SENT : SYNTH_KEY_RETRY);
+    if (status == SUCCESS) {
+        memcpy(kbd_sent_report, report, len);
+        kbd_sent_len = len;
+    }
+
+    // 插入到首个按键送达的耗时 (1 tick = 0.625ms)
+    if (status == SUCCESS && attach_key_pending) {
+        attach_key_pending = 0;
+        LOG_USB("Attach to first key: %d ms\n", (int)((TMOS_GetSystemClock() - attach_tick) * 5 / 8));
+    }
+    return status;
+}
+
+/**
+ * @brief  报文中某键码是否按下 (标准 8 字节报文，键码在第 2~7 字节)
+ */
+static uint8_t Kbd_KeyDown(const uint8_t *report, uint8_t code) {
+    for (uint8_t i = 2; i < 8; i++) {
+        if (report[i] == code) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  按位图比较一个字节：gone 为 NULL 时找 now 中新按下的位，否则找 was -> gone 释放后 now 又按下的位
+ */
+static uint8_t Kbd_PressBits(uint8_t was, const uint8_t *gone, uint8_t now) {
+    return gone ? (now & was & (uint8_t)~*gone) : (now & (uint8_t)~was);
+}
+
+/**
+ * @brief  now 中是否有 was 未按下的键 (含修饰键)
+ * @param  gone  非 NULL 时改为检查释放后又按下：was 按下 -> gone 释放 -> now 又按下
+ */
+static uint8_t Kbd_HasPress(const uint8_t *was, const uint8_t *gone, const uint8_t *now, uint8_t len) {
+    uint8_t i;
+
+    if (len != 8) {
+        // NKRO：修饰键字节与位图逐位比较
+        for (i = 0; i < len; i++) {
+            if (Kbd_PressBits(was[i], gone ? &gone[i] : NULL, now[i])) return 1;
+        }
+        return 0;
+    }
+    if (Kbd_PressBits(was[0], gone, now[0])) return 1;
+    for (i = 2; i < 8; i++) {
+        if (now[i] == 0) continue;
+        if (gone) {
+            if (Kbd_KeyDown(was, now[i]) && !Kbd_KeyDown(gone, now[i])) return 1;
+        } else if (!Kbd_KeyDown(was, now[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  新报文覆盖队尾 (合并一个中间状态)
+ *         队尾相对前一状态只有释放、且这些键没有在新报文中再次按下时，
+ *         主机看到的每个按键沿及按下顺序不变，只是释放与后续变化同帧到达
+ * @return 1 已合并
+ */
+static uint8_t Kbd_Queue_Collapse(uint8_t *report, uint8_t len) {
+    uint8_t        tail = (kbd_queue_head + kbd_queue_count - 1) % KBD_QUEUE_MAX;
+    uint8_t        prev_idx;
+    const uint8_t *prev;
+    uint8_t        prev_len;
+
+    if (kbd_queue_count > 1) {
+        prev_idx = (tail + KBD_QUEUE_MAX - 1) % KBD_QUEUE_MAX;
+        prev     = kbd_queue[prev_idx];
+        prev_len = kbd_queue_len[prev_idx];
+    } else {
+        prev     = kbd_sent_report;
+        prev_len = kbd_sent_len;
+    }
+    if (kbd_queue_len[tail] != len || prev_len != len) return 0;
+    if (Kbd_HasPress(prev, NULL, kbd_queue[tail], len)) return 0;    // 队尾带新按下的键
+    if (Kbd_HasPress(prev, kbd_queue[tail], report, len)) return 0;  // 释放后又按下
+
+    memcpy(kbd_queue[tail], report, len);
+    SYNTH_COUNT(SYNTH_KEY_MERGE);
+    return 1;
+}
+
+/**
+ * @brief  键盘报文入队，先尝试合并只含释放的队尾，队满时覆写队尾（保证最终按键状态正确）
+ */
+static void Kbd_Queue_Push(uint8_t *report, uint8_t len) {
+    uint8_t idx;
+    if (kbd_queue_count && Kbd_Queue_Collapse(report, len)) return;
+    if (kbd_queue_count < kbd_queue_depth) {
+        idx = (kbd_queue_head + kbd_queue_count) % KBD_QUEUE_MAX;
+        kbd_queue_count++;
+        SYNTH_QUEUE(kbd_queue_count);
+    } else {
+        idx = (kbd_queue_head + kbd_queue_count - 1) % KBD_QUEUE_MAX;
+        SYNTH_COUNT(SYNTH_KEY_DROP);
+    }
+    memcpy(kbd_queue[idx], report, len);
+    kbd_queue_len[idx] = len;
+}
+
+/**
+ * @brief  按顺序发送排队的键盘报文，直到蓝牙再次忙或控制器积压
+ */
+static void Kbd_Queue_Flush(void) {
+    while (kbd_queue_count && !Bridge_Backlogged()) {
+        if (Kbd_Send(kbd_queue[kbd_queue_head], kbd_queue_len[kbd_queue_head]) != SUCCESS) {
+            return;
+        }
+        kbd_queue_head = (kbd_queue_head + 1) % KBD_QUEUE_MAX;
+        kbd_queue_count--;
+        LOG_BLE("KBD Resend OK\n");
+    }
+}
+
+/**
+ * @brief  切换键盘报文格式 (MTU 协商完成或连接断开后)
+ *         - 旧格式的排队报文丢弃 (新连接上可能已无法发出)
+ *         - 标准报文切到 NKRO 时若仍有按键按住，先用标准报文释放，避免主机粘键
+ */
+static void Kbd_Switch_Format(uint8_t len) {
+    static const uint8_t empty[KBD_RPT_MAX_LEN] = {0};
+    uint8_t old_len = last_kbd_len;
+
+    kbd_queue_count = 0;
+    last_kbd_len = len;
+
+    if (memcmp(last_kbd_report, empty, old_len) != 0) {
+        memset(last_kbd_report, 0, sizeof(last_kbd_report));
+        if (old_len < len && Kbd_Send(last_kbd_report, old_len) != SUCCESS) {
+            Kbd_Queue_Push(last_kbd_report, old_len);
+        }
+    }
+    LOG_BLE("KBD format: %d bytes\n", len);
+}
+
+/**
+ * @brief  发送聚合后的鼠标数据
+ */
+static void Mouse_Flush(void) {
+    uint8_t report[4];
+    uint8_t status;
+
+#ifdef ENABLE_COMBO_REPORT
+    // ID 4 中仍有按住的键/按键：鼠标也走 ID 4，键盘部分保持原样
+    // 合并报文已不可用则先释放 ID 4，按住的键改经 ID 1/3 重新按下
+    if (OUT_BLE() && combo_held) {
+        if (HidEmu_ComboAvailable()) {
+            if (Combo_Send(combo_sent) != SUCCESS) {
+                SYNTH_COUNT(SYNTH_MOUSE_RETRY);
+            }
+            return;
+        }
+        Combo_Release();
+        if (memcmp(last_kbd_report, kbd_sent_report, last_kbd_len) != 0) {
+            Kbd_Queue_Push(last_kbd_report, last_kbd_len);
+        }
+    }
+#endif
+
+    Mouse_Build(report);
+#ifdef ENABLE_RF_LINK
+    status = out_wired ? UsbDev_SendMouse(report) : RfOut_SendMouse(report);
+#else
+    status = out_wired ? UsbDev_SendMouse(report) : HidEmu_SendMouseReport(report);
+#endif
+    if (status == SUCCESS) {
+        Mouse_Commit(report);
+        SYNTH_COUNT(SYNTH_MOUSE_SENT);
+    } else {
+        // 发送失败保留累计值，下一轮再试
+        SYNTH_COUNT(SYNTH_MOUSE_RETRY);
+    }
+}
+
+/**
+ * @brief  数位笔样本入队
+ *         队列深度 = 一个连接间隔内的样本数 + 1，正好跨过一次连接事件
+ *         队满时开关状态未变则覆写队尾 (笔迹少一个中间点)，否则丢弃最旧样本保证落笔/抬笔送达
+ */
+static void Abs_Queue_Push(uint8_t *report) {
+    uint16_t depth = 1 + mouse_window / AbsPtr_GetPollTicks();
+    uint8_t  idx;
+
+    if (depth > ABS_QUEUE_MAX) depth = ABS_QUEUE_MAX;
+    if (abs_queue_count >= depth) {
+        idx = (abs_queue_head + abs_queue_count - 1) % ABS_QUEUE_MAX;
+        if (abs_queue[idx][0] == report[0]) {
+            memcpy(abs_queue[idx], report, HID_ABS_IN_RPT_LEN);
+            return;
+        }
+        abs_queue_head = (abs_queue_head + 1) % ABS_QUEUE_MAX;
+        abs_queue_count--;
+    }
+    idx = (abs_queue_head + abs_queue_count) % ABS_QUEUE_MAX;
+    memcpy(abs_queue[idx], report, HID_ABS_IN_RPT_LEN);
+    abs_queue_count++;
+}
+
+/**
+ * @brief  按顺序发送排队的数位笔样本，直到蓝牙再次忙
+ */
+static void Abs_Queue_Flush(void) {
+    while (abs_queue_count && !Bridge_Backlogged()) {
+        if (HidEmu_SendAbsReport(abs_queue[abs_queue_head]) != SUCCESS) {
+            return;
+        }
+        abs_queue_head = (abs_queue_head + 1) % ABS_QUEUE_MAX;
+        abs_queue_count--;
+    }
+}
+
+/**
+ * @brief  发送手柄最新状态
+ */
+static void Gamepad_Flush(void) {
+    if (HidEmu_SendGamepadReport(gp_state) == SUCCESS) {
+        memcpy(gp_sent, gp_state, HID_GAMEPAD_IN_RPT_LEN);
+        gp_dirty = gp_urgent = 0;
+        gp_last_send = TMOS_GetSystemClock();
+    }
+}
+
+/**
+ * @brief  切换输出通道 (设备口被主机配置/挂起/拔出时)
+ *         - 旧通道上仍按住的键和鼠标按键先释放 (尽力发送，不排队)，避免另一端粘键
+ *         - 丢弃旧通道的排队报文与未发出的位移
+ */
+static void Bridge_Update_Output(void) {
+    static const uint8_t empty[KBD_RPT_MAX_LEN] = {0};
+    uint8_t wired = UsbDev_IsActive();
+
+    if (wired == out_wired) return;
+
+    if (memcmp(last_kbd_report, empty, last_kbd_len) != 0) {
+        Kbd_Send((uint8_t *)empty, last_kbd_len);
+    }
+    if (mouse_sent_btn) {
+        mouse_acc_x = mouse_acc_y = mouse_acc_wheel = 0;
+        mouse_acc_btn = 0;
+        Mouse_Flush();
+    }
+    if (abs_last[0] & (HID_ABS_SW_TIP | HID_ABS_SW_BARREL | HID_ABS_SW_ERASER)) {
+        abs_last[0] = 0;
+        HidEmu_SendAbsReport(abs_last);
+    }
+    Gamepad_Neutral(gp_state);
+    if (OUT_BLE() && memcmp(gp_sent, gp_state, HID_GAMEPAD_IN_RPT_LEN) != 0) {
+        HidEmu_SendGamepadReport(gp_state);
+    }
+
+    memset(last_kbd_report, 0, sizeof(last_kbd_report));
+    memset(kbd_sent_report, 0, sizeof(kbd_sent_report));
+    kbd_queue_count = 0;
+    mouse_acc_x = mouse_acc_y = mouse_acc_wheel = 0;
+    mouse_acc_btn = mouse_sent_btn = 0;
+    mouse_acc_dirty = 0;
+#ifdef ENABLE_COMBO_REPORT
+    combo_held = 0;
+#endif
+    memset(abs_last, 0, sizeof(abs_last));
+    abs_queue_count = 0;
+    memcpy(gp_sent, gp_state, HID_GAMEPAD_IN_RPT_LEN);
+    gp_dirty = gp_urgent = 0;
+
+    out_wired = wired;
+    LOG_USB("Output -> %s\n", wired ? "USB" : (OUT_BLE() ? "BLE" : "RF"));
+}
+
+/**
+ * @brief  鼠标新样本并入聚合缓冲
+ */
+static void Mouse_Accumulate(uint8_t *mouse_data) {
+    mouse_acc_btn    = mouse_data[0];
+    mouse_acc_x     += (int8_t)mouse_data[1];
+    mouse_acc_y     += (int8_t)mouse_data[2];
+    mouse_acc_wheel += (int8_t)mouse_data[3];
+    mouse_acc_dirty  = 1;
+}
+
+
 // ===================================================================
 // ?? 辅助函数：数据解析与调试
 // ===================================================================
@@ -101,6 +680,167 @@ void Parse_Keyboard_Data(uint8_t* in_buf, uint8_t len, uint8_t* out_buf) {
     }
 }
 
+/**
+ * @brief  键盘数据解析为 NKRO 位图 (不受 6 键限制，协商 MTU 足够时使用)
+ * @param  in_buf   USB接收到的原始数据
+ * @param  len      数据长度
+ * @param  out_buf  输出的 NKRO 报文 [Mods, 位图 usage 0x00~HID_NKRO_KEY_MAX]
+ */
+void Parse_Keyboard_Nkro(uint8_t* in_buf, uint8_t len, uint8_t* out_buf) {
+    uint16_t keycode;
+
+    memset(out_buf, 0, HID_NKRO_IN_RPT_LEN);
+    if (len < 8) return;
+
+    out_buf[0] = in_buf[0]; // 复制修饰键 (Ctrl/Shift/Alt/Win)
+
+    for (int i = 2; i < len; i++) {
+        if (in_buf[i] == 0) continue;
+
+        if (len == 8) {
+            // 情况1: 标准 8 字节 Boot Keyboard 报文，逐个键码置位
+            keycode = in_buf[i];
+            if (keycode > 3 && keycode <= HID_NKRO_KEY_MAX) {
+                out_buf[1 + keycode / 8] |= (1 << (keycode % 8));
+            }
+        } else {
+            // 情况2: NiZ 等 NKRO 变长报文，位图平移 NIZ_KEY_OFFSET 后原样保留
+            for (int bit = 0; bit < 8; bit++) {
+                if ((in_buf[i] >> bit) & 0x01) {
+                    keycode = (i - 2) * 8 + bit + NIZ_KEY_OFFSET;
+                    if (keycode <= HID_NKRO_KEY_MAX) {
+                        out_buf[1 + keycode / 8] |= (1 << (keycode % 8));
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// ===================================================================
+// ? 输入交接点：解析后的数据进入发送队列 / 鼠标聚合
+// ===================================================================
+
+/**
+ * @brief  处理一帧键盘输入 (USB 数据源与合成输入共用的交接点)
+ * @param  raw  原始键盘报文 (标准 8 字节或 NiZ 等 NKRO 变长报文)
+ * @param  len  报文长度
+ */
+static void Bridge_Kbd_Input(uint8_t *raw, uint8_t len) {
+    uint8_t temp_report[KBD_RPT_MAX_LEN] = {0};
+    uint8_t rpt_len = OUT_BLE() ? HidEmu_GetKeyReportLen() : 8;
+
+    ConnTrace_Input();
+
+    // 按协商的 MTU 选择报文格式：能单包装下则用 NKRO 位图，否则回退标准 6 键
+    // 有线与 2.4G 输出固定为 Boot 兼容的标准 6 键报文
+    if (rpt_len != last_kbd_len) {
+        Kbd_Switch_Format(rpt_len);
+    }
+    if (rpt_len == HID_NKRO_IN_RPT_LEN) {
+        Parse_Keyboard_Nkro(raw, len, temp_report);
+    } else {
+        Parse_Keyboard_Data(raw, len, temp_report);
+    }
+
+    // 【优化1】加上 memcmp：只有键盘数据发生真实变化（按下或松开）才处理
+    if (memcmp(last_kbd_report, temp_report, rpt_len) == 0) return;
+
+    if (rpt_len == 8) DBG_KEYS(temp_report);
+    memcpy(last_kbd_report, temp_report, rpt_len);
+
+    // 【优化2】处理唤醒逻辑
+    if (HidEmu_ResetIdleTimer() == TRUE && OUT_BLE()) {
+        // 如果是刚刚被敲击唤醒：丢弃这一次按键数据！
+        // （作为代价，唤醒键不会出现在电脑屏幕上，但这能彻底解决卡死粘键的问题）
+        // 有线/2.4G 输出不经过蓝牙休眠，唤醒键照常发送
+        kbd_queue_count = 0;
+    } else {
+        // 正常非休眠状态：队列为空且控制器不积压时直接发送，否则排队保序 (排队时可合并)
+        uint8_t held = Bridge_Backlogged();
+        if (held) SYNTH_COUNT(SYNTH_BACKLOG_HOLD);
+        if (kbd_queue_count || held || Kbd_Send(last_kbd_report, rpt_len) != SUCCESS) {
+            Kbd_Queue_Push(last_kbd_report, rpt_len); // 标记待重发
+        }
+    }
+}
+
+/**
+ * @brief  处理一帧鼠标输入 (USB 数据源与合成输入共用的交接点)
+ * @param  mouse_data  [Btn, X, Y, Wheel]
+ */
+static void Bridge_Mouse_Input(uint8_t *mouse_data) {
+    DBG_MOUSE(mouse_data);
+    ConnTrace_Input();
+
+    // 位移并入聚合缓冲；按键变化立即发送，否则等聚合窗口到期且控制器不积压
+    Mouse_Accumulate(mouse_data);
+    if (!OUT_BLE() || mouse_acc_btn != mouse_sent_btn) {
+        Mouse_Flush();
+    } else if ((TMOS_GetSystemClock() - mouse_last_send) >= mouse_window) {
+        if (Bridge_Backlogged()) {
+            SYNTH_COUNT(SYNTH_BACKLOG_HOLD);
+        } else {
+            Mouse_Flush();
+        }
+    }
+}
+
+/**
+ * @brief  处理一帧数位笔输入 (绝对坐标设备解码后的交接点)
+ * @param  report  [开关位, X, Y, 压力] (HID_ABS_IN_RPT_LEN 字节)
+ * @note   设备口与 2.4G 链路只有键盘/鼠标报文，非蓝牙输出时丢弃
+ */
+static void Bridge_Abs_Input(uint8_t *report) {
+    uint8_t held;
+
+    if (!OUT_BLE()) return;
+    ConnTrace_Input();
+    if (memcmp(abs_last, report, HID_ABS_IN_RPT_LEN) == 0) return;
+    memcpy(abs_last, report, HID_ABS_IN_RPT_LEN);
+    HidEmu_ResetIdleTimer();  // 只动笔时同样保持全速轮询，不进入空闲降频
+
+    // 队列为空且控制器不积压时直接发送，否则排队保序
+    held = Bridge_Backlogged();
+    if (held) SYNTH_COUNT(SYNTH_BACKLOG_HOLD);
+    if (abs_queue_count || held || HidEmu_SendAbsReport(report) != SUCCESS) {
+        Abs_Queue_Push(report);
+    }
+}
+
+/**
+ * @brief  处理一帧手柄输入 (手柄解码后的交接点，拔出时传入中位报文)
+ * @param  report  [按键 16 bit, 苜蓿键, X, Y, Z, Rx, Ry, Rz] (HID_GAMEPAD_IN_RPT_LEN 字节)
+ * @note   设备口与 2.4G 链路只有键盘/鼠标报文，非蓝牙输出时丢弃
+ */
+static void Bridge_Gamepad_Input(uint8_t *report) {
+    uint8_t chg;
+
+    if (!OUT_BLE()) return;
+    ConnTrace_Input();
+    memcpy(gp_state, report, HID_GAMEPAD_IN_RPT_LEN);
+
+    // 轴噪声 (小于阈值) 不上报；按键变化立即发送，轴变化等合并窗口到期
+    chg = Gamepad_Compare(gp_sent, gp_state);
+    if (chg == GAMEPAD_CHG_NONE) {
+        gp_dirty = gp_urgent = 0;
+        return;
+    }
+    gp_dirty = 1;
+    HidEmu_ResetIdleTimer();  // 只玩手柄时同样保持全速轮询，不进入空闲降频与软休眠
+    if (chg == GAMEPAD_CHG_BUTTON) gp_urgent = 1;
+    if (gp_urgent) {
+        Gamepad_Flush();
+    } else if ((TMOS_GetSystemClock() - gp_last_send) >= mouse_window) {
+        if (Bridge_Backlogged()) {
+            SYNTH_COUNT(SYNTH_BACKLOG_HOLD);
+        } else {
+            Gamepad_Flush();
+        }
+    }
+}
+
 
 // ===================================================================
 // ? 核心逻辑
@@ -118,9 +858,22 @@ void USB_Bridge_Init(void) {
     // 3. 初始化协议栈
     USB2_HostInit();
 
+    // 4. 设备口 (有线输出)，主机配置后自动切换
+    UsbDev_Init();
+
     Bridge_NewDevFlag  = 0;
-    kbd_send_pending   = 0;
-    mouse_send_pending = 0;
+    kbd_queue_head     = 0;
+    kbd_queue_count    = 0;
+    mouse_acc_dirty    = 0;
+    mouse_acc_x = mouse_acc_y = mouse_acc_wheel = 0;
+    Gamepad_Neutral(gp_state);
+    Gamepad_Neutral(gp_sent);
+    USB_Bridge_SetConnParams(0, 0);
+
+    // 深度关机唤醒：键盘在关机期间保持供电，首次枚举无需等待电源稳定
+    skip_attach_settle = Power_IsColdResume();
+    EnumCache_Init();
+    UsbCap_Init();
 
     // 初始化 NiZ 记录变量（清除 DATA1 标志，只保留端点号）
     Var_NizMouse_Record = (NIZ_MOUSE_ENDP & 0x7F);
@@ -128,33 +881,81 @@ void USB_Bridge_Init(void) {
     LOG_SYS("USB Init OK. Bridge Ready.\n");
 }
 
+/**
+ * @brief  深度关机前的 USB 收尾
+ *         - 根端口设备已枚举时置位远程唤醒，使其挂起后能通过 K 态唤醒本机
+ *         - 关闭主机控制器 (停止 SOF)，设备 3ms 后自行进入挂起
+ * @note   经 HUB 连接的设备不做处理，仍可通过 USER 按键唤醒
+ */
+void USB_Bridge_Shutdown(void) {
+    if (ThisUsb2Dev.DeviceStatus >= ROOT_DEV_SUCCESS) {
+        SelectU2HubPort(0);
+        CopyU2SetupReqPkg(SetupSetU2RemoteWakeup);
+        if (U2HostCtrlTransfer(NULL, NULL) != ERR_SUCCESS) {
+            LOG_USB("Remote wakeup not supported\n");
+        }
+    }
+
+    R8_USB2_INT_EN = 0;
+    R8_U2HOST_CTRL = 0;
+    R8_USB2_CTRL   = 0;
+
+    // 设备口断开上拉 (仅在有线未在线时才会关机)
+    R8_USB_INT_EN = 0;
+    R8_USB_CTRL   = 0;
+    R16_PIN_ANALOG_IE &= ~(RB_PIN_USB_IE | RB_PIN_USB_DP_PU);
+}
+
 void USB_Bridge_Poll(void) {
     uint8_t s, len, endp_addr;
     uint16_t search_res;
 
     // --------------------------------------------------------
-    // [任务 0a] 键盘流控：蓝牙忙时优先重发，保证不丢键
+    // [任务 0] 输出通道：设备口被主机配置时走有线，否则走蓝牙
     // --------------------------------------------------------
-    if (kbd_send_pending) {
-        if (HidEmu_SendUSBReport(last_kbd_report) == SUCCESS) {
-            kbd_send_pending = 0;
-            LOG_BLE("KBD Resend OK\n");
-        } else {
-            return; // 蓝牙仍忙，暂停本轮
-        }
+    Bridge_Update_Output();
+
+    // --------------------------------------------------------
+    // [任务 0a] 键盘流控：蓝牙忙时按序重发队列，保证不丢键
+    //           队列深度随连接间隔调整，本轮仍继续读取新数据
+    //           控制器积压 (未确认包数达到门限) 时暂停，排队报文在桥接层合并
+    // --------------------------------------------------------
+    Kbd_Queue_Flush();
+
+    // --------------------------------------------------------
+    // [任务 0b] 鼠标流控：聚合窗口到期后发送累计位移，控制器积压时继续累计
+    // --------------------------------------------------------
+    if (mouse_acc_dirty &&
+        (!OUT_BLE() || ((TMOS_GetSystemClock() - mouse_last_send) >= mouse_window && !Bridge_Backlogged()))) {
+        Mouse_Flush();
     }
 
     // --------------------------------------------------------
-    // [任务 0b] 鼠标流控：发送上帧缓存的最新鼠标数据
-    //           与键盘不同，鼠标不阻塞本轮轮询（保实时性）
+    // [任务 0c] 数位笔流控：蓝牙忙时按序重发缓冲的笔迹点
     // --------------------------------------------------------
-    if (mouse_send_pending) {
-        if (HidEmu_SendMouseReport(pending_mouse_report) == SUCCESS) {
-            mouse_send_pending = 0;
-        }
-        // 发送失败继续持有缓存，下一轮再试；本轮继续读新数据
+    Abs_Queue_Flush();
+
+    // --------------------------------------------------------
+    // [任务 0d] 手柄流控：按键变化重试，轴变化合并窗口到期后发送
+    // --------------------------------------------------------
+    if (gp_dirty && (gp_urgent || ((TMOS_GetSystemClock() - gp_last_send) >= mouse_window && !Bridge_Backlogged()))) {
+        Gamepad_Flush();
     }
 
+#ifdef DEBUG_SYNTH_INPUT
+    // --------------------------------------------------------
+    // [测试模式] 合成输入替代 USB 数据源，从同一交接点进入发送路径
+    // --------------------------------------------------------
+    {
+        uint8_t kbd_raw[8], mouse_data[4];
+        uint8_t has = SynthIn_Poll(kbd_raw, mouse_data);
+
+        if (has & SYNTH_HAS_KEY)   Bridge_Kbd_Input(kbd_raw, sizeof(kbd_raw));
+        if (has & SYNTH_HAS_MOUSE) Bridge_Mouse_Input(mouse_data);
+        return;
+    }
+#endif
+
     // --------------------------------------------------------
     // [任务 1] 硬件插拔检测与设备枚举
     // --------------------------------------------------------
@@ -172,18 +973,40 @@ void USB_Bridge_Poll(void) {
     // 处理新设备插入
     if(Bridge_NewDevFlag) {
         Bridge_NewDevFlag = 0;
-        mDelaymS(200); // 等待设备电源稳定
-        s = InitRootU2Device();
+        attach_tick = TMOS_GetSystemClock();
+        ClkScale_Set(CLK_TIER_FULL);    // 枚举延时按 60MHz 计时
+        if (skip_attach_settle) {
+            skip_attach_settle = 0;
+        } else if (EnumCache_HasEntry()) {
+            mDelaymS(USB_ATTACH_SETTLE_CACHED_MS);
+        } else {
+            mDelaymS(USB_ATTACH_SETTLE_MS); // 等待设备电源稳定
+        }
+
+        // 先按缓存快速枚举，未命中再走完整枚举并记录结果
+        s = EnumCache_FastInit();
+        if (s != ERR_SUCCESS) {
+            s = InitRootU2Device();
+            if (s == ERR_SUCCESS) {
+                EnumCache_Learn();
+            } else if (s == ERR_USB_UNSUPPORT) {
+                // 非 Boot 协议的 HID 设备：按报告描述符尝试接管为手柄
+                SelectU2HubPort(0);
+                s = Gamepad_Claim(0);
+            }
+        }
         if(s == ERR_SUCCESS){
-            LOG_SYS("Device Enum OK\n");
+            attach_key_pending = 1;
+            AbsPtr_Reset();             // 新设备：鼠标类接口重新探测
+            LOG_SYS("Device Enum OK (%d ms)\n", (int)((TMOS_GetSystemClock() - attach_tick) * 5 / 8));
             // 【重要】设备重新插入后，必须重置 NiZ 鼠标的同步位
             // 恢复为 0x04 (Bit7=0 表示下次期望 DATA0)
             Var_NizMouse_Record = (NIZ_MOUSE_ENDP & 0x7F);
         } 
     }
 
-    // 周期性维护 HUB 状态 (如果有 HUB)
-    EnumAllU2HubPort(); 
+    // 维护 HUB 端口 (如果有 HUB)：按状态变化端点的 bInterval 查询，无变化时不占总线
+    UsbHub_Poll();
 
     // =================================================================
     // [任务 2] 读取键盘数据
@@ -215,29 +1038,10 @@ void USB_Bridge_Poll(void) {
                 else    ThisUsb2Dev.GpVar[0] = endp_addr;
 
                 len = R8_USB2_RX_LEN;
+                UsbCap_Record((uint8_t)search_res, endp_addr & 0x7F, RxBuffer, len);
                 if(len > 0) 
                 {
-                    uint8_t temp_report[8] = {0};
-                    Parse_Keyboard_Data(RxBuffer, len, temp_report);
-                    
-                    // 【优化1】加上 memcmp：只有键盘数据发生真实变化（按下或松开）才处理
-                    if (memcmp(last_kbd_report, temp_report, 8) != 0) 
-                    {
-                        DBG_KEYS(temp_report);
-                        memcpy(last_kbd_report, temp_report, 8);
-                        
-                        // 【优化2】处理唤醒逻辑
-                        if (HidEmu_ResetIdleTimer() == TRUE) {
-                            // 如果是刚刚被敲击唤醒：丢弃这一次按键数据！
-                            // （作为代价，唤醒键不会出现在电脑屏幕上，但这能彻底解决卡死粘键的问题）
-                            kbd_send_pending = 0; 
-                        } else {
-                            // 正常非休眠状态：发送给蓝牙
-                            if (HidEmu_SendUSBReport(last_kbd_report) != SUCCESS) {
-                                kbd_send_pending = 1; // 标记待重发
-                            }
-                        }
-                    }
+                    Bridge_Kbd_Input(RxBuffer, len);
                 }
             }
         }
@@ -251,23 +1055,31 @@ void USB_Bridge_Poll(void) {
     // 无论是官方库管理的标准鼠标，还是我们自己管理的 NiZ 鼠标，都通过这个指针操作
     uint8_t *p_mouse_toggle_record = NULL; 
     uint8_t current_record_val = 0;
+    uint8_t mouse_port = 0;
 
     // A. 尝试寻找标准鼠标
     search_res = U2SearchTypeDevice(DEV_TYPE_MOUSE);
     if (search_res != 0xFFFF) {
         uint8_t hub_port = (uint8_t)search_res; 
         SelectU2HubPort(hub_port); // 物理选中端口
+        mouse_port = hub_port;
+        AbsPtr_Attach(hub_port);   // 首次出现时读报告描述符，识别数位板/绝对指针
         
         // 指向官方库结构体中的变量
         if (hub_port) p_mouse_toggle_record = &DevOnU2HubPort[hub_port - 1].GpVar[0];
         else          p_mouse_toggle_record = &ThisUsb2Dev.GpVar[0];
     } 
-    // B. 如果没找到标准鼠标，且设备已枚举，尝试强制读取 NiZ 接口
-    else if (ThisUsb2Dev.DeviceStatus >= ROOT_DEV_SUCCESS) {
+    // B. 如果没找到标准鼠标，且根端口键盘已枚举，尝试强制读取 NiZ 接口
+    //    (手柄等其他根端口设备不做，避免每轮白白多一次事务或把其 EP4 数据当鼠标解析)
+    else if (ThisUsb2Dev.DeviceStatus >= ROOT_DEV_SUCCESS && ThisUsb2Dev.DeviceType == DEV_TYPE_KEYBOARD) {
+        AbsPtr_Reset();
         SelectU2HubPort(0); // 【关键】确保操作对象是根端口设备
         // 指向我们自己定义的全局变量
         p_mouse_toggle_record = &Var_NizMouse_Record;
     }
+    else {
+        AbsPtr_Reset();
+    }
 
     // 如果确定了目标，开始传输
     if (p_mouse_toggle_record != NULL)
@@ -293,7 +1105,15 @@ void USB_Bridge_Poll(void) {
 
                 // 2. 解析数据
                 len = R8_USB2_RX_LEN;
-                if(len >= 3) 
+                UsbCap_Record(mouse_port, current_record_val & 0x7F, RxBuffer, len);
+                if (AbsPtr_IsActive()) {
+                    // 绝对坐标设备：按报告描述符解码，其他报告 ID (快捷键等) 忽略
+                    uint8_t abs_report[HID_ABS_IN_RPT_LEN];
+                    if (AbsPtr_Decode(RxBuffer, len, abs_report)) {
+                        Bridge_Abs_Input(abs_report);
+                    }
+                }
+                else if(len >= 3) 
                 {
                     uint8_t mouse_data[4] = {0}; 
                     
@@ -317,17 +1137,46 @@ void USB_Bridge_Poll(void) {
                     }
 
                     // --- 发送处理 ---
-                    DBG_MOUSE(mouse_data);
-
-                    // 蓝牙忙时用最新帧覆写缓存，下一轮优先重发
-                    if (HidEmu_SendMouseReport(mouse_data) != SUCCESS) {
-                        memcpy(pending_mouse_report, mouse_data, 4);
-                        mouse_send_pending = 1;  // 触发缓存重发
-                    } else {
-                        mouse_send_pending = 0;  // 成功发出，清除旧缓存
-                    }
+                    Bridge_Mouse_Input(mouse_data);
+                }
+            }
+        }
+    }
+
+    // =================================================================
+    // [任务 3b] 读取手柄数据 (键盘、鼠标之后读取，手柄轮询再快也不挤占键盘)
+    // =================================================================
+    search_res = U2SearchTypeDevice(DEV_TYPE_GAMEPAD);
+    if (search_res != 0xFFFF) {
+        uint8_t hub_port = (uint8_t)search_res;
+        uint8_t *p_gp_record = hub_port ? &DevOnU2HubPort[hub_port - 1].GpVar[0] : &ThisUsb2Dev.GpVar[0];
+
+        SelectU2HubPort(hub_port);
+        endp_addr = *p_gp_record;
+        if (endp_addr & USB_ENDP_ADDR_MASK) {
+            s = USB2HostTransact(USB_PID_IN << 4 | (endp_addr & 0x7F),
+                                 (endp_addr & 0x80) ? (RB_UH_R_TOG | RB_UH_T_TOG) : 0, 0);
+            if (s == ERR_SUCCESS) {
+                uint8_t gp_report[HID_GAMEPAD_IN_RPT_LEN];
+
+                *p_gp_record ^= 0x80;
+                len = R8_USB2_RX_LEN;
+                UsbCap_Record(hub_port, endp_addr & 0x7F, RxBuffer, len);
+                if (Gamepad_Decode(RxBuffer, len, gp_report)) {
+                    Bridge_Gamepad_Input(gp_report);
                 }
             }
         }
     }
+    else if (HidEmu_IsConnected() && (memcmp(gp_sent, gp_state, HID_GAMEPAD_IN_RPT_LEN) != 0 || gp_dirty)) {
+        // 手柄拔出：释放按住的键，摇杆回中 (未连接或软休眠时不发，避免重新开启广播；回连后补发)
+        uint8_t gp_report[HID_GAMEPAD_IN_RPT_LEN];
+        Gamepad_Neutral(gp_report);
+        Bridge_Gamepad_Input(gp_report);
+    }
+
+    // =================================================================
+    // [任务 4] 抓包缓冲：总线静默时写入 flash (未启用 DEBUG_USB_CAPTURE 时为空)
+    // =================================================================
+    UsbCap_Idle();
 }
\ No newline at end of file
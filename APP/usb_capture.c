@@ -0,0 +1,211 @@
+/*********************************************************************
+ * File Name          : usb_capture.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 中断 IN 抓包 (DEBUG_USB_CAPTURE)
+ *                      - 每个成功的中断 IN 数据包记为一条：
+ *                        [dt(2, LE) | 端口<<4 | 端点 (1) | 长度 (1) | 数据]
+ *                        dt 为距页内上一条记录的 TMOS tick (0.625ms)，页首条相对页头 base
+ *                      - 两个 RAM 页轮流填充：写满的页在总线静默 50ms 后才擦写 flash；
+ *                        静默 1s 时提前封存未写满的页，掉电最多丢 1s 记录
+ *                      - flash 环形区按页头序号确定新旧，写满后覆盖最旧的页
+ *                      - UsbCap_Dump() 按从旧到新逐页以十六进制输出到 UART (长按 USER 键触发)，
+ *                        由 Tools/usb_capture.py 转换为回放轨迹
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "usb_capture.h"
+
+#ifdef DEBUG_USB_CAPTURE
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+
+// 环形区放在枚举缓存页 (SNV 前一页) 之下 (EEPROM_* 使用 data flash 内偏移地址)
+#define USBCAP_PAGES              16      // 环形区页数 (每页 256 字节)
+#define USBCAP_ADDR               (BLE_SNV_ADDR - EEPROM_PAGE_SIZE * (1 + USBCAP_PAGES))
+#define USBCAP_MAGIC              0xCA01  // 页有效标志 (格式变化时修改)
+
+#define USBCAP_QUIET_MS           50      // 总线静默达到该时长才写 flash
+#define USBCAP_CLOSE_MS           1000    // 静默达到该时长时封存未写满的页
+#define USBCAP_MAX_PAYLOAD        64      // 单条记录最多保存的数据字节 (全速中断端点最大包长)
+#define USBCAP_REC_HDR            4       // 单条记录头：dt(2) + 端口/端点(1) + 长度(1)
+
+// ===================================================================
+// 页格式
+// ===================================================================
+typedef struct {
+    uint32_t base;      // 页内首条记录时刻 (TMOS tick)
+    uint16_t magic;
+    uint16_t seq;       // 页序号，环形区内最大者为最新页
+    uint8_t  drops;     // 本页之前因缓冲满丢弃的记录数 (饱和)
+    uint8_t  used;      // 记录区已用字节
+    uint16_t reserved;
+} UsbCapHdr_t;
+
+typedef struct {
+    UsbCapHdr_t hdr;
+    uint8_t     data[EEPROM_PAGE_SIZE - sizeof(UsbCapHdr_t)];
+} UsbCapPage_t;
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+__attribute__((aligned(4))) static UsbCapPage_t cap_page[2];
+
+static uint8_t  cap_cur   = 0;      // 正在填充的 RAM 页
+static uint8_t  cap_full  = FALSE;  // 另一个 RAM 页已封存，等待写入 flash
+static uint8_t  cap_slot  = 0;      // 下一个写入的 flash 页
+static uint16_t cap_seq   = 0;      // 下一个页序号
+static uint8_t  cap_drops = 0;      // 两页均满时丢弃的记录数 (记入下一页页头)
+static uint32_t cap_last  = 0;      // 最近一条记录的时刻
+
+// ===================================================================
+// 页缓冲管理
+// ===================================================================
+
+/**
+ * @brief 封存当前 RAM 页，切换到另一页继续填充 (调用前须确认 cap_full 为 FALSE)
+ */
+static void UsbCap_Close(void)
+{
+    cap_full = TRUE;
+    cap_cur ^= 1;
+    cap_page[cap_cur].hdr.used = 0;
+}
+
+/**
+ * @brief 把已封存的 RAM 页写入 flash 环形区的下一页
+ */
+static void UsbCap_Write(void)
+{
+    UsbCapPage_t *pg   = &cap_page[cap_cur ^ 1];
+    uint32_t      addr = USBCAP_ADDR + (uint32_t)cap_slot * EEPROM_PAGE_SIZE;
+
+    pg->hdr.magic = USBCAP_MAGIC;
+    pg->hdr.seq   = cap_seq++;
+    EEPROM_ERASE(addr, EEPROM_PAGE_SIZE);
+    EEPROM_WRITE(addr, pg, EEPROM_PAGE_SIZE);
+
+    cap_slot = (cap_slot + 1) % USBCAP_PAGES;
+    cap_full = FALSE;
+}
+
+// ===================================================================
+// 对外接口
+// ===================================================================
+
+/**
+ * @brief 读取环形区各页头，从最新页之后继续写入
+ */
+void UsbCap_Init(void)
+{
+    UsbCapHdr_t hdr;
+    uint8_t     i, found = FALSE;
+
+    for (i = 0; i < USBCAP_PAGES; i++) {
+        EEPROM_READ(USBCAP_ADDR + (uint32_t)i * EEPROM_PAGE_SIZE, &hdr, sizeof(hdr));
+        if (hdr.magic != USBCAP_MAGIC) continue;
+        // 序号回绕后仍按差值判断新旧
+        if (!found || (int16_t)(hdr.seq - cap_seq) >= 0) {
+            cap_seq  = hdr.seq + 1;
+            cap_slot = (i + 1) % USBCAP_PAGES;
+            found    = TRUE;
+        }
+    }
+
+    cap_cur  = 0;
+    cap_full = FALSE;
+    cap_page[0].hdr.used = 0;
+}
+
+/**
+ * @brief 记录一个中断 IN 数据包 (只写 RAM，不触发 flash 操作)
+ * @param port 0 = 根端口，N = HUB 端口 N
+ * @param endp 端点号 (不含同步位)
+ */
+void UsbCap_Record(uint8_t port, uint8_t endp, uint8_t *buf, uint8_t len)
+{
+    UsbCapPage_t *pg  = &cap_page[cap_cur];
+    uint32_t      now = TMOS_GetSystemClock();
+    uint32_t      dt  = now - cap_last;
+    uint8_t      *p;
+
+    if (len > USBCAP_MAX_PAYLOAD) len = USBCAP_MAX_PAYLOAD;
+
+    // 当前页装不下，或与上一条间隔超出 dt 范围：换新页 (新页头记录绝对时刻)
+    if (pg->hdr.used && (pg->hdr.used + USBCAP_REC_HDR + len > sizeof(pg->data) || dt > 0xFFFF)) {
+        if (cap_full) {
+            if (cap_drops < 0xFF) cap_drops++;
+            return;
+        }
+        UsbCap_Close();
+        pg = &cap_page[cap_cur];
+    }
+
+    if (pg->hdr.used == 0) {
+        pg->hdr.base  = now;
+        pg->hdr.drops = cap_drops;
+        cap_drops     = 0;
+        dt            = 0;
+    }
+
+    p = pg->data + pg->hdr.used;
+    p[0] = (uint8_t)dt;
+    p[1] = (uint8_t)(dt >> 8);
+    p[2] = (uint8_t)((port << 4) | (endp & 0x0F));
+    p[3] = len;
+    memcpy(p + USBCAP_REC_HDR, buf, len);
+    pg->hdr.used += USBCAP_REC_HDR + len;
+    cap_last = now;
+}
+
+/**
+ * @brief 空闲维护 (每个 USB 轮询节拍调用)：仅在总线静默时擦写 flash
+ */
+void UsbCap_Idle(void)
+{
+    uint32_t quiet = TMOS_GetSystemClock() - cap_last;
+
+    if (quiet < MS1_TO_SYSTEM_TIME(USBCAP_QUIET_MS)) return;
+
+    if (!cap_full && cap_page[cap_cur].hdr.used && quiet >= MS1_TO_SYSTEM_TIME(USBCAP_CLOSE_MS)) {
+        UsbCap_Close();
+    }
+    if (cap_full) {
+        UsbCap_Write();
+    }
+}
+
+/**
+ * @brief 先写入 RAM 中的记录，再按从旧到新输出整个环形区
+ *        每页一行："CAP " + 页头与已用记录区的十六进制
+ */
+void UsbCap_Dump(void)
+{
+    UsbCapPage_t *pg;
+    uint8_t       i, slot;
+    uint16_t      j, n;
+
+    if (cap_full) UsbCap_Write();
+    if (cap_page[cap_cur].hdr.used) {
+        UsbCap_Close();
+        UsbCap_Write();
+    }
+
+    // 两个 RAM 页此时均空闲，借用一页作读出缓冲
+    pg = &cap_page[cap_cur ^ 1];
+    PRINT("CAP BEGIN %u\n", USBCAP_PAGES);
+    for (i = 0, slot = cap_slot; i < USBCAP_PAGES; i++, slot = (slot + 1) % USBCAP_PAGES) {
+        EEPROM_READ(USBCAP_ADDR + (uint32_t)slot * EEPROM_PAGE_SIZE, pg, EEPROM_PAGE_SIZE);
+        if (pg->hdr.magic != USBCAP_MAGIC || pg->hdr.used > sizeof(pg->data)) continue;
+
+        n = sizeof(UsbCapHdr_t) + pg->hdr.used;
+        PRINT("CAP ");
+        for (j = 0; j < n; j++) PRINT("%02X", ((uint8_t *)pg)[j]);
+        PRINT("\n");
+    }
+    PRINT("CAP END\n");
+}
+
+#endif /* DEBUG_USB_CAPTURE */
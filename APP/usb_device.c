@@ -0,0 +1,415 @@
+/*********************************************************************
+ * File Name          : usb_device.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USB 设备口 (有线输出)
+ *                      - USB1 设备控制器枚举为复合 HID：接口 0 Boot 键盘 (EP1)，接口 1 鼠标 (EP2)
+ *                      - 两个中断端点 bInterval = 1ms，报文格式与蓝牙标准键盘/鼠标报文一致
+ *                      - 控制传输在 USB 中断内完成，桥接层只在端点空闲时装载新报文
+ *                      - 设备口被配置且未挂起 = 有线在线；插拔/挂起由总线复位与挂起中断判定
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "usb_device.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define USBDEV_VID                0x1A86  // WCH
+#define USBDEV_PID                0xE6E1  // 自定义
+#define USBDEV_EP0_SIZE           64
+#define USBDEV_KBD_RPT_LEN        8       // 接口 0：标准 8 字节键盘报文
+#define USBDEV_MOUSE_RPT_LEN      4       // 接口 1：[Btn, X, Y, Wheel]
+
+// HID 类请求
+#define HID_GET_REPORT            0x01
+#define HID_GET_IDLE              0x02
+#define HID_GET_PROTOCOL          0x03
+#define HID_SET_REPORT            0x09
+#define HID_SET_IDLE              0x0A
+#define HID_SET_PROTOCOL          0x0B
+
+// 设备口状态
+#define USBDEV_DETACHED           0       // 未连接主机 (上电后或挂起后未再复位)
+#define USBDEV_DEFAULT            1       // 已收到总线复位，枚举中
+#define USBDEV_CONFIGURED         2       // 主机已 SET_CONFIGURATION
+
+// ===================================================================
+// 描述符
+// ===================================================================
+
+// 键盘报告描述符 (与蓝牙 Report ID 1 相同，去掉 Report ID 以兼容 Boot 协议)
+static const uint8_t KbdRepDesc[] = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01,
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+    0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x05, 0x75, 0x01, 0x05, 0x08, 0x19, 0x01, 0x29, 0x05,
+    0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01, 0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65,
+    0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0
+};
+
+// 鼠标报告描述符 (与蓝牙 Report ID 2 相同，去掉 Report ID)
+static const uint8_t MouseRepDesc[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01,
+    0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01, 0x95, 0x03,
+    0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31,
+    0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06, 0xC0, 0xC0
+};
+
+static const uint8_t DevDescr[] = {
+    0x12, USB_DESCR_TYP_DEVICE, 0x10, 0x01, 0x00, 0x00, 0x00, USBDEV_EP0_SIZE,
+    LO_UINT16(USBDEV_VID), HI_UINT16(USBDEV_VID), LO_UINT16(USBDEV_PID), HI_UINT16(USBDEV_PID),
+    0x00, 0x01, 0x01, 0x02, 0x00, 0x01
+};
+
+#define CFG_DESCR_LEN             (9 + (9 + 9 + 7) * 2)
+static const uint8_t CfgDescr[] = {
+    // 配置：2 个接口，总线供电 100mA
+    0x09, USB_DESCR_TYP_CONFIG, CFG_DESCR_LEN, 0x00, 0x02, 0x01, 0x00, 0x80, 0x32,
+
+    // 接口 0：HID Boot 键盘
+    0x09, USB_DESCR_TYP_INTERF, 0x00, 0x00, 0x01, USB_DEV_CLASS_HID, 0x01, 0x01, 0x00,
+    0x09, USB_DESCR_TYP_HID, 0x11, 0x01, 0x00, 0x01, USB_DESCR_TYP_REPORT, sizeof(KbdRepDesc), 0x00,
+    0x07, USB_DESCR_TYP_ENDP, 0x81, USB_ENDP_TYPE_INTER, USBDEV_KBD_RPT_LEN, 0x00, 0x01,
+
+    // 接口 1：HID Boot 鼠标
+    0x09, USB_DESCR_TYP_INTERF, 0x01, 0x00, 0x01, USB_DEV_CLASS_HID, 0x01, 0x02, 0x00,
+    0x09, USB_DESCR_TYP_HID, 0x11, 0x01, 0x00, 0x01, USB_DESCR_TYP_REPORT, sizeof(MouseRepDesc), 0x00,
+    0x07, USB_DESCR_TYP_ENDP, 0x82, USB_ENDP_TYPE_INTER, USBDEV_MOUSE_RPT_LEN, 0x00, 0x01,
+};
+
+static const uint8_t LangDescr[] = {0x04, USB_DESCR_TYP_STRING, 0x09, 0x04};
+static const uint8_t ManuDescr[] = {0x0C, USB_DESCR_TYP_STRING, 'E', 0, 'N', 0, 'J', 0, 'O', 0, 'U', 0};
+static const uint8_t ProdDescr[] = {
+    0x24, USB_DESCR_TYP_STRING, 'E', 0, 'N', 0, 'J', 0, 'O', 0, 'U', 0, ' ', 0, 'U', 0, 'S', 0,
+    'B', 0, ' ', 0, 'A', 0, 'd', 0, 'a', 0, 'p', 0, 't', 0, 'e', 0, 'r', 0
+};
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+__attribute__((aligned(4))) static uint8_t ep0_buf[USBDEV_EP0_SIZE];
+__attribute__((aligned(4))) static uint8_t ep1_buf[64];
+__attribute__((aligned(4))) static uint8_t ep2_buf[64];
+
+static volatile uint8_t dev_state     = USBDEV_DETACHED;
+static volatile uint8_t dev_suspended = FALSE;
+static uint8_t  dev_config   = 0;
+static uint8_t  dev_idle[2]  = {0, 0};  // SET_IDLE 记录 (仅应答 GET_IDLE，报文只在变化时发送)
+static uint8_t  dev_proto[2] = {1, 1};  // 1 = 报告协议 (Boot 与报告格式相同，无需区分)
+
+static uint8_t        setup_req  = 0;
+static uint16_t       setup_len  = 0;
+static const uint8_t *setup_desc = NULL;
+
+// ===================================================================
+// 初始化
+// ===================================================================
+
+/**
+ * @brief 初始化 USB1 设备控制器：EP0 控制 + EP1/EP2 中断 IN，打开 D+ 上拉
+ */
+void UsbDev_Init(void)
+{
+    R8_USB_CTRL   = 0x00;
+    R8_UEP4_1_MOD = RB_UEP1_TX_EN;
+    R8_UEP2_3_MOD = RB_UEP2_TX_EN;
+
+    R16_UEP0_DMA  = (uint16_t)(uint32_t)ep0_buf;
+    R16_UEP1_DMA  = (uint16_t)(uint32_t)ep1_buf;
+    R16_UEP2_DMA  = (uint16_t)(uint32_t)ep2_buf;
+
+    R8_UEP0_CTRL  = UEP_R_RES_ACK | UEP_T_RES_NAK;
+    R8_UEP1_CTRL  = UEP_T_RES_NAK | RB_UEP_AUTO_TOG;
+    R8_UEP2_CTRL  = UEP_T_RES_NAK | RB_UEP_AUTO_TOG;
+
+    R8_USB_DEV_AD = 0x00;
+    R8_USB_CTRL   = RB_UC_DEV_PU_EN | RB_UC_INT_BUSY | RB_UC_DMA_EN;
+    R16_PIN_ANALOG_IE |= RB_PIN_USB_IE | RB_PIN_USB_DP_PU;
+    R8_USB_INT_FG = 0xFF;
+    R8_UDEV_CTRL  = RB_UD_PD_DIS | RB_UD_PORT_EN;
+    R8_USB_INT_EN = RB_UIE_SUSPEND | RB_UIE_BUS_RST | RB_UIE_TRANSFER;
+
+    // 睡眠中主机复位/唤醒总线时唤醒 MCU
+    PWR_PeriphWakeUpCfg(ENABLE, RB_SLP_USB_WAKE, Long_Delay);
+    PFIC_EnableIRQ(USB_IRQn);
+}
+
+// ===================================================================
+// 状态查询与发送
+// ===================================================================
+
+/**
+ * @brief 有线输出是否在线 (主机已配置且总线未挂起)
+ */
+uint8_t UsbDev_IsActive(void)
+{
+    return (dev_state == USBDEV_CONFIGURED && !dev_suspended);
+}
+
+/**
+ * @brief 设备口是否正与主机通讯 (枚举中或已配置)，此时 MCU 不能进入睡眠
+ */
+uint8_t UsbDev_KeepAwake(void)
+{
+    return (dev_state != USBDEV_DETACHED && !dev_suspended);
+}
+
+/**
+ * @brief 装载键盘报文 (8 字节)，上一帧尚未被主机取走时返回失败由调用方重试
+ */
+uint8_t UsbDev_SendKeyboard(uint8_t *report)
+{
+    if (!UsbDev_IsActive() || (R8_UEP1_CTRL & MASK_UEP_T_RES) == UEP_T_RES_ACK) {
+        return FAILURE;
+    }
+    memcpy(ep1_buf, report, USBDEV_KBD_RPT_LEN);
+    R8_UEP1_T_LEN = USBDEV_KBD_RPT_LEN;
+    R8_UEP1_CTRL  = (R8_UEP1_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK;
+    return SUCCESS;
+}
+
+/**
+ * @brief 装载鼠标报文 (4 字节)
+ */
+uint8_t UsbDev_SendMouse(uint8_t *report)
+{
+    if (!UsbDev_IsActive() || (R8_UEP2_CTRL & MASK_UEP_T_RES) == UEP_T_RES_ACK) {
+        return FAILURE;
+    }
+    memcpy(ep2_buf, report, USBDEV_MOUSE_RPT_LEN);
+    R8_UEP2_T_LEN = USBDEV_MOUSE_RPT_LEN;
+    R8_UEP2_CTRL  = (R8_UEP2_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_ACK;
+    return SUCCESS;
+}
+
+// ===================================================================
+// 控制传输
+// ===================================================================
+
+/**
+ * @brief 标准请求，需上传的数据由 setup_desc/setup_len 给出
+ * @return 0 成功，0xFF 不支持 (STALL)
+ */
+static uint8_t UsbDev_StdRequest(PUSB_SETUP_REQ req)
+{
+    uint8_t len = 0;
+
+    switch (setup_req) {
+        case USB_GET_DESCRIPTOR:
+            switch (req->wValue >> 8) {
+                case USB_DESCR_TYP_DEVICE: setup_desc = DevDescr; len = sizeof(DevDescr); break;
+                case USB_DESCR_TYP_CONFIG: setup_desc = CfgDescr; len = sizeof(CfgDescr); break;
+                case USB_DESCR_TYP_REPORT:
+                    if ((req->wIndex & 0xFF) == 0) {
+                        setup_desc = KbdRepDesc;   len = sizeof(KbdRepDesc);
+                    } else if ((req->wIndex & 0xFF) == 1) {
+                        setup_desc = MouseRepDesc; len = sizeof(MouseRepDesc);
+                    } else {
+                        return 0xFF;
+                    }
+                    break;
+                case USB_DESCR_TYP_STRING:
+                    switch (req->wValue & 0xFF) {
+                        case 0:  setup_desc = LangDescr; len = sizeof(LangDescr); break;
+                        case 1:  setup_desc = ManuDescr; len = sizeof(ManuDescr); break;
+                        case 2:  setup_desc = ProdDescr; len = sizeof(ProdDescr); break;
+                        default: return 0xFF;
+                    }
+                    break;
+                default:
+                    return 0xFF;
+            }
+            if (setup_len > len) setup_len = len;
+            return 0;  // 由发送阶段分包
+
+        case USB_SET_ADDRESS:
+            setup_len = req->wValue & MASK_USB_ADDR;  // 状态阶段完成后再生效
+            return 0;
+
+        case USB_GET_CONFIGURATION:
+            ep0_buf[0] = dev_config;
+            len = 1;
+            break;
+
+        case USB_SET_CONFIGURATION:
+            dev_config = req->wValue & 0xFF;
+            dev_state  = dev_config ? USBDEV_CONFIGURED : USBDEV_DEFAULT;
+            return 0;
+
+        case USB_GET_INTERFACE:
+            ep0_buf[0] = 0;
+            len = 1;
+            break;
+
+        case USB_SET_INTERFACE:
+        case USB_CLEAR_FEATURE:
+        case USB_SET_FEATURE:
+            return 0;
+
+        case USB_GET_STATUS:
+            ep0_buf[0] = 0;
+            ep0_buf[1] = 0;
+            len = 2;
+            break;
+
+        default:
+            return 0xFF;
+    }
+    setup_desc = ep0_buf;
+    if (setup_len > len) setup_len = len;
+    return 0;
+}
+
+/**
+ * @brief HID 类请求
+ * @return 0 成功，0xFF 不支持 (STALL)
+ */
+static uint8_t UsbDev_ClassRequest(PUSB_SETUP_REQ req)
+{
+    uint8_t itf = req->wIndex & 0x01;
+    uint8_t len = 0;
+
+    switch (setup_req) {
+        case HID_SET_IDLE:     dev_idle[itf]  = req->wValue >> 8;   return 0;
+        case HID_SET_PROTOCOL: dev_proto[itf] = req->wValue & 0xFF; return 0;
+        case HID_SET_REPORT:   return 0;  // 指示灯在数据阶段接收
+        case HID_GET_IDLE:     ep0_buf[0] = dev_idle[itf];  len = 1; break;
+        case HID_GET_PROTOCOL: ep0_buf[0] = dev_proto[itf]; len = 1; break;
+        case HID_GET_REPORT:
+            len = itf ? USBDEV_MOUSE_RPT_LEN : USBDEV_KBD_RPT_LEN;
+            memset(ep0_buf, 0, len);
+            break;
+        default:
+            return 0xFF;
+    }
+    setup_desc = ep0_buf;
+    if (setup_len > len) setup_len = len;
+    return 0;
+}
+
+/**
+ * @brief 处理 SETUP 包，装载数据阶段首包
+ */
+static void UsbDev_Setup(void)
+{
+    PUSB_SETUP_REQ req = (PUSB_SETUP_REQ)ep0_buf;
+    uint8_t type = req->bRequestType;
+    uint8_t err, len;
+
+    setup_req  = req->bRequest;
+    setup_len  = req->wLength;
+    setup_desc = NULL;
+
+    if ((type & USB_REQ_TYP_MASK) == USB_REQ_TYP_STANDARD) {
+        err = UsbDev_StdRequest(req);
+    } else if ((type & USB_REQ_TYP_MASK) == USB_REQ_TYP_CLASS) {
+        err = UsbDev_ClassRequest(req);
+    } else {
+        err = 0xFF;
+    }
+
+    if (err == 0xFF) {
+        setup_req    = 0xFF;
+        R8_UEP0_CTRL = RB_UEP_R_TOG | RB_UEP_T_TOG | UEP_R_RES_STALL | UEP_T_RES_STALL;
+        return;
+    }
+
+    len = 0;
+    if (type & USB_REQ_TYP_IN) {
+        len = (setup_len > USBDEV_EP0_SIZE) ? USBDEV_EP0_SIZE : setup_len;
+        if (setup_desc != ep0_buf) memcpy(ep0_buf, setup_desc, len);
+        setup_desc += len;
+        setup_len  -= len;
+    }
+    R8_UEP0_T_LEN = len;  // 主机到设备方向为 0 长度状态包
+    R8_UEP0_CTRL  = RB_UEP_R_TOG | RB_UEP_T_TOG | UEP_R_RES_ACK | UEP_T_RES_ACK;
+}
+
+/**
+ * @brief EP0 IN 完成：继续发送描述符，或在状态阶段后设置地址
+ */
+static void UsbDev_Ep0In(void)
+{
+    uint8_t len;
+
+    switch (setup_req) {
+        case USB_GET_DESCRIPTOR:
+            len = (setup_len > USBDEV_EP0_SIZE) ? USBDEV_EP0_SIZE : setup_len;
+            memcpy(ep0_buf, setup_desc, len);
+            setup_desc   += len;
+            setup_len    -= len;
+            R8_UEP0_T_LEN = len;
+            R8_UEP0_CTRL ^= RB_UEP_T_TOG;
+            break;
+
+        case USB_SET_ADDRESS:
+            R8_USB_DEV_AD = (R8_USB_DEV_AD & RB_UDA_GP_BIT) | (uint8_t)setup_len;
+            R8_UEP0_CTRL  = UEP_R_RES_ACK | UEP_T_RES_NAK;
+            break;
+
+        default:
+            R8_UEP0_T_LEN = 0;
+            R8_UEP0_CTRL  = UEP_R_RES_ACK | UEP_T_RES_NAK;
+            break;
+    }
+}
+
+// ===================================================================
+// 中断服务
+// ===================================================================
+
+__INTERRUPT
+__HIGH_CODE
+void USB_IRQHandler(void)
+{
+    uint8_t intflag = R8_USB_INT_FG;
+    uint8_t st;
+
+    if (intflag & RB_UIF_TRANSFER) {
+        st = R8_USB_INT_ST;
+        if ((st & MASK_UIS_TOKEN) != MASK_UIS_TOKEN) {
+            switch (st & (MASK_UIS_TOKEN | MASK_UIS_ENDP)) {
+                case UIS_TOKEN_IN:
+                    UsbDev_Ep0In();
+                    break;
+
+                case UIS_TOKEN_OUT:
+                    // SET_REPORT 指示灯数据：与蓝牙路径一致，只应答不转发
+                    break;
+
+                // 中断端点报文被主机取走，回到 NAK 等待桥接层装载下一帧
+                case UIS_TOKEN_IN | 1:
+                    R8_UEP1_CTRL = (R8_UEP1_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_NAK;
+                    break;
+
+                case UIS_TOKEN_IN | 2:
+                    R8_UEP2_CTRL = (R8_UEP2_CTRL & ~MASK_UEP_T_RES) | UEP_T_RES_NAK;
+                    break;
+
+                default:
+                    break;
+            }
+            R8_USB_INT_FG = RB_UIF_TRANSFER;
+        }
+        if (R8_USB_INT_ST & RB_UIS_SETUP_ACT) {
+            UsbDev_Setup();
+            R8_USB_INT_FG = RB_UIF_TRANSFER;
+        }
+    } else if (intflag & RB_UIF_BUS_RST) {
+        // 总线复位：主机已连接，重新枚举
+        R8_USB_DEV_AD = 0;
+        R8_UEP0_CTRL  = UEP_R_RES_ACK | UEP_T_RES_NAK;
+        R8_UEP1_CTRL  = UEP_T_RES_NAK | RB_UEP_AUTO_TOG;
+        R8_UEP2_CTRL  = UEP_T_RES_NAK | RB_UEP_AUTO_TOG;
+        dev_config    = 0;
+        dev_state     = USBDEV_DEFAULT;
+        dev_suspended = FALSE;
+        R8_USB_INT_FG = RB_UIF_BUS_RST;
+    } else if (intflag & RB_UIF_SUSPEND) {
+        // 挂起：主机休眠或线缆拔出；恢复时不复位则保持原配置
+        dev_suspended = (R8_USB_MIS_ST & RB_UMS_SUSPEND) ? TRUE : FALSE;
+        R8_USB_INT_FG = RB_UIF_SUSPEND;
+    } else {
+        R8_USB_INT_FG = intflag;
+    }
+}
@@ -0,0 +1,262 @@
+/*********************************************************************
+ * File Name          : usb_hub.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 外部 HUB 端口维护 (状态变化中断端点驱动)
+ *                      - HUB 枚举成功后补读配置描述符，取得状态变化中断 IN 端点及 bInterval
+ *                      - 按 bInterval 发一次 IN 令牌：NAK 表示无变化，不再产生任何控制传输
+ *                      - 收到位图后只对置位的端口发 GET_PORT_STATUS，处理插入/拔出并清变化标志
+ *                      - HUB 无中断端点时退回官方库的全端口查询 (降频执行)
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "usb_hub.h"
+#include "clk_scale.h"
+#include "gamepad.h"
+#include "debug.h"
+
+// ===================================================================
+// 用户配置区 (User Configuration)
+// ===================================================================
+#define HUB_ATTACH_SETTLE_MS      200     // 端口插入后等待设备电源稳定 (与官方库一致)
+#define HUB_RESET_RECOVERY_MS     100     // 端口复位完成后的恢复时间 (与官方库一致)
+#define HUB_RESET_TIMEOUT_MS      50      // 等待端口复位完成的上限
+#define HUB_FALLBACK_POLL_MS      100     // 无中断端点时全端口查询的周期
+
+// wPortStatus / wPortChange 位 (特性选择子 0~9 为状态位, 16~20 为变化位)
+#define HUB_STATUS_BIT(f)         (1U << (f))
+#define HUB_CHANGE_BIT(f)         (1U << ((f) - HUB_C_PORT_CONNECTION))
+
+// ===================================================================
+// 外部函数引用 (官方库未在头文件中声明)
+// ===================================================================
+extern uint8_t InitU2DevOnHub(uint8_t HubPortIndex);
+extern uint8_t EnumAllU2HubPort(void);
+
+// HUB 类请求 CLEAR_HUB_FEATURE (wValue 在发送前填入特性选择子)
+__attribute__((aligned(4))) static const uint8_t SetupClrHubFeature[] = {
+    HUB_CLEAR_HUB_FEATURE, HUB_CLEAR_FEATURE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// ===================================================================
+// 全局变量
+// ===================================================================
+static uint8_t  hub_ready     = FALSE;  // 已解析当前 HUB 的中断端点
+static uint8_t  hub_endp      = 0;      // Bit7=同步位, Bit0-6=端点号 (0 = 无中断端点)
+static uint16_t hub_interval  = 0;      // 查询周期 (TMOS tick)
+static uint32_t hub_last_poll = 0;      // 上次查询时刻
+static uint8_t  hub_pending   = 0;      // 待处理的变化位图 (Bit0 = HUB 自身, BitN = 端口 N)
+
+// ===================================================================
+// 中断端点解析
+// ===================================================================
+
+/**
+ * @brief 补读 HUB 配置描述符，记录状态变化中断 IN 端点与 bInterval
+ */
+static void UsbHub_ParseEndp(void)
+{
+    uint8_t *buf = U2Com_Buffer;
+    uint16_t i, total;
+    uint8_t  interval = 0;
+
+    hub_endp = 0;
+    SelectU2HubPort(0);
+    if (CtrlGetU2ConfigDescr() == ERR_SUCCESS) {
+        total = ((PUSB_CFG_DESCR)buf)->wTotalLength;
+        for (i = 0; i + 2 <= total && buf[i] >= 2; i += buf[i]) {
+            PUSB_ENDP_DESCR ep = (PUSB_ENDP_DESCR)(buf + i);
+            if (buf[i + 1] == USB_DESCR_TYP_ENDP && (ep->bEndpointAddress & USB_ENDP_DIR_MASK) &&
+                (ep->bmAttributes & USB_ENDP_TYPE_MASK) == USB_ENDP_TYPE_INTER) {
+                hub_endp = ep->bEndpointAddress & USB_ENDP_ADDR_MASK;  // 从 DATA0 开始
+                interval = ep->bInterval;
+                break;
+            }
+        }
+    }
+    SetUsb2Speed(1);
+
+    if (hub_endp) {
+        if (interval == 0) interval = 1;
+        hub_interval = MS1_TO_SYSTEM_TIME(interval);
+        if (hub_interval == 0) hub_interval = 1;
+        LOG_USB("Hub status EP %02x, interval %d ms\n", hub_endp, interval);
+    } else {
+        hub_interval = MS1_TO_SYSTEM_TIME(HUB_FALLBACK_POLL_MS);
+        LOG_USB("Hub has no status EP, fallback to port scan\n");
+    }
+
+    // 首次查询一遍全部端口，处理枚举 HUB 之前已插入的设备
+    hub_pending   = (uint8_t)(((1U << ThisUsb2Dev.GpHUBPortNum) - 1) << 1);
+    hub_last_poll = TMOS_GetSystemClock();
+    hub_ready     = TRUE;
+}
+
+// ===================================================================
+// 端口处理
+// ===================================================================
+
+/**
+ * @brief 复位端口并初始化其上的设备 (流程同官方库 EnumU2HubPort)
+ */
+static uint8_t UsbHub_AttachPort(uint8_t port, uint16_t status)
+{
+    _DevOnHubPort *dev = &DevOnU2HubPort[port - 1];
+    uint8_t i, s;
+
+    dev->DeviceStatus  = ROOT_DEV_CONNECTED;
+    dev->DeviceAddress = 0x00;
+    dev->DeviceSpeed   = (status & HUB_STATUS_BIT(HUB_PORT_LOW_SPEED)) ? 0 : 1;
+    LOG_USB("Hub port %d attach (%s speed)\n", port, dev->DeviceSpeed ? "full" : "low");
+    ClkScale_Set(CLK_TIER_FULL);    // 枚举延时按 60MHz 计时
+
+    mDelaymS(HUB_ATTACH_SETTLE_MS);
+    s = U2HubSetPortFeature(port, HUB_PORT_RESET);
+    if (s != ERR_SUCCESS) return s;
+    for (i = 0; i < HUB_RESET_TIMEOUT_MS; i++) {
+        mDelaymS(1);
+        s = U2HubGetPortStatus(port);
+        if (s != ERR_SUCCESS) return s;
+        if ((U2Com_Buffer[0] & HUB_STATUS_BIT(HUB_PORT_RESET)) == 0) break;
+    }
+    mDelaymS(HUB_RESET_RECOVERY_MS);
+    U2HubClearPortFeature(port, HUB_C_PORT_RESET);
+
+    // 复查设备是否还在
+    s = U2HubGetPortStatus(port);
+    if (s != ERR_SUCCESS) return s;
+    if ((U2Com_Buffer[0] & HUB_STATUS_BIT(HUB_PORT_CONNECTION)) == 0) {
+        dev->DeviceStatus = ROOT_DEV_DISCONNECT;
+        return ERR_USB_DISCON;
+    }
+    s = InitU2DevOnHub(port);
+    if (s == ERR_USB_UNSUPPORT) {
+        // 非 Boot 协议的 HID 设备：按报告描述符尝试接管为手柄
+        SelectU2HubPort(port);
+        s = Gamepad_Claim(port);
+    }
+    return s;
+}
+
+/**
+ * @brief 查询单个端口状态，处理插拔并清除全部变化标志
+ */
+static uint8_t UsbHub_ServicePort(uint8_t port)
+{
+    uint16_t status, change;
+    uint8_t  s;
+
+    SelectU2HubPort(0);
+    s = U2HubGetPortStatus(port);
+    if (s != ERR_SUCCESS) return s;
+    status = U2Com_Buffer[0] | ((uint16_t)U2Com_Buffer[1] << 8);
+    change = U2Com_Buffer[2] | ((uint16_t)U2Com_Buffer[3] << 8);
+
+    // 1. 连接变化：先清标志，再按当前连接状态插入或移除
+    if (change & HUB_CHANGE_BIT(HUB_C_PORT_CONNECTION)) {
+        U2HubClearPortFeature(port, HUB_C_PORT_CONNECTION);
+        if (status & HUB_STATUS_BIT(HUB_PORT_CONNECTION)) {
+            s = UsbHub_AttachPort(port, status);
+        } else {
+            if (DevOnU2HubPort[port - 1].DeviceStatus >= ROOT_DEV_CONNECTED) {
+                LOG_USB("Hub port %d removed\n", port);
+            }
+            DevOnU2HubPort[port - 1].DeviceStatus = ROOT_DEV_DISCONNECT;
+        }
+        SelectU2HubPort(0);
+    }
+    // 2. 端口被 HUB 禁用 (总线错误)：设备仍在则重新复位初始化
+    else if (change & HUB_CHANGE_BIT(HUB_C_PORT_ENABLE)) {
+        U2HubClearPortFeature(port, HUB_C_PORT_ENABLE);
+        LOG_USB("Hub port %d error\n", port);
+        if (status & HUB_STATUS_BIT(HUB_PORT_CONNECTION)) {
+            s = UsbHub_AttachPort(port, status);
+            SelectU2HubPort(0);
+        }
+    }
+
+    // 3. 其余变化位只需清除，否则 HUB 每个周期都会重复上报
+    if (change & HUB_CHANGE_BIT(HUB_C_PORT_SUSPEND))      U2HubClearPortFeature(port, HUB_C_PORT_SUSPEND);
+    if (change & HUB_CHANGE_BIT(HUB_C_PORT_OVER_CURRENT)) U2HubClearPortFeature(port, HUB_C_PORT_OVER_CURRENT);
+    if (change & HUB_CHANGE_BIT(HUB_C_PORT_RESET))        U2HubClearPortFeature(port, HUB_C_PORT_RESET);
+
+    return s;
+}
+
+/**
+ * @brief HUB 自身状态变化 (本地供电/过流)：清除标志
+ */
+static void UsbHub_ServiceHub(void)
+{
+    uint8_t f;
+
+    SelectU2HubPort(0);
+    for (f = HUB_C_HUB_LOCAL_POWER; f <= HUB_C_HUB_OVER_CURRENT; f++) {
+        CopyU2SetupReqPkg(SetupClrHubFeature);
+        pU2SetupReq->wValue = f;
+        U2HostCtrlTransfer(NULL, NULL);
+    }
+    LOG_USB("Hub status change\n");
+}
+
+// ===================================================================
+// 周期查询
+// ===================================================================
+
+/**
+ * @brief 维护外部 HUB 端口 (每个 USB 轮询节拍调用)
+ *        未到 bInterval 时立即返回；到期只发一个 IN 令牌，无变化时 HUB 回 NAK
+ */
+void UsbHub_Poll(void)
+{
+    uint8_t s, len, port;
+
+    // 根端口不是已枚举的 HUB：清状态，下次 HUB 插入时重新解析
+    if (ThisUsb2Dev.DeviceStatus < ROOT_DEV_SUCCESS || ThisUsb2Dev.DeviceType != USB_DEV_CLASS_HUB) {
+        hub_ready = FALSE;
+        return;
+    }
+    if (!hub_ready) UsbHub_ParseEndp();
+
+    if (hub_pending == 0) {
+        if ((TMOS_GetSystemClock() - hub_last_poll) < hub_interval) return;
+        hub_last_poll = TMOS_GetSystemClock();
+
+        // 无中断端点：退回官方库逐端口查询
+        if (hub_endp == 0) {
+            EnumAllU2HubPort();
+            return;
+        }
+
+        SelectU2HubPort(0);
+        s = USB2HostTransact(USB_PID_IN << 4 | (hub_endp & 0x7F),
+                             (hub_endp & 0x80) ? (RB_UH_R_TOG | RB_UH_T_TOG) : 0, 0);
+        SetUsb2Speed(1);
+
+        if (s == ERR_SUCCESS) {
+            hub_endp ^= 0x80;
+            len = R8_USB2_RX_LEN;
+            hub_pending = len ? pU2HOST_RX_RAM_Addr[0] : 0;
+        } else if (s != (USB_PID_NAK | ERR_USB_TRANSFER)) {
+            // 端点出错：同步位回到 DATA0，并全端口复查一次以免漏掉事件
+            LOG_USB("Hub status EP err = %02x\n", s);
+            hub_endp &= 0x7F;
+            hub_pending = (uint8_t)(((1U << ThisUsb2Dev.GpHUBPortNum) - 1) << 1);
+        }
+        if (hub_pending == 0) return;
+    }
+
+    // 处理变化位图：HUB 自身在 Bit0，端口 N 在 BitN
+    if (hub_pending & 0x01) {
+        UsbHub_ServiceHub();
+    }
+    for (port = 1; port <= ThisUsb2Dev.GpHUBPortNum; port++) {
+        if (hub_pending & (1U << port)) {
+            s = UsbHub_ServicePort(port);
+            if (s != ERR_SUCCESS) {
+                LOG_USB("Hub port %d err = %02x\n", port, s);
+            }
+        }
+    }
+    hub_pending = 0;
+    SetUsb2Speed(1);
+}
@@ -0,0 +1,191 @@
+/*********************************************************************
+ * File Name          : user_key.c
+ * Author             : DIY User & AI Assistant
+ * Description        : USER 按键驱动 (PB4, 低电平按下)
+ *                      - 电平中断代替 100ms 轮询，空闲时零周期唤醒
+ *                      - 中断只负责唤醒与置位去抖事件，状态机在 TMOS 任务中运行
+ *                      - 短按 / 长按 / 超长按 / 双击识别 (超长按途中先上报一次长按)
+ *                      - GPIO 唤醒源，低功耗睡眠中按键可直接唤醒
+ *********************************************************************/
+
+#include "CONFIG.h"
+#include "user_key.h"
+#include "hidkbd.h"
+#include "debug.h"
+#include "evt_mon.h"
+
+// ===================================================================
+// TMOS 任务事件位定义 (Task Events)
+// ===================================================================
+#define USER_KEY_DEBOUNCE_EVT     0x0001  // 边沿后去抖到期，采样电平
+#define USER_KEY_LONG_EVT         0x0002  // 按住达到长按时长
+#define USER_KEY_DOUBLE_EVT       0x0004  // 双击等待窗口超时
+#define USER_KEY_VERY_LONG_EVT    0x0008  // 按住达到超长按时长
+
+// ===================================================================
+// 状态机
+// ===================================================================
+typedef enum {
+    KEY_STATE_IDLE = 0,      // 松开，等待第一次按下
+    KEY_STATE_PRESSED,       // 按下中 (长按计时)
+    KEY_STATE_LONG_HELD,     // 已上报长按，等待松开
+    KEY_STATE_WAIT_DOUBLE,   // 第一次短按已松开，等待第二次按下
+    KEY_STATE_SECOND_PRESS,  // 第二次按下中，松开即双击
+} KeyState_t;
+
+static uint8_t     userKeyTaskId = INVALID_TASK_ID;  // TMOS 任务ID
+static UserKeyCB_t userKeyCB     = NULL;             // 事件上报回调
+static KeyState_t  key_state     = KEY_STATE_IDLE;
+static uint8_t     key_pressed   = FALSE;            // 去抖后的电平 (TRUE = 按下)
+
+// ===================================================================
+// 中断配置
+// ===================================================================
+
+/**
+ * @brief 按当前去抖后的电平重新布防中断：松开等低电平，按下等高电平
+ *        使用电平触发而非边沿触发，布防前已发生的变化也不会丢失
+ */
+static void UserKey_ArmIRQ(void)
+{
+    GPIOB_ITModeCfg(USER_KEY_PIN, key_pressed ? GPIO_ITMode_HighLevel : GPIO_ITMode_LowLevel);
+}
+
+/**
+ * @brief GPIOB 中断：关闭按键中断 (屏蔽抖动)，启动去抖定时
+ */
+__INTERRUPT
+__HIGH_CODE
+void GPIOB_IRQHandler(void)
+{
+    if (GPIOB_ReadITFlagBit(USER_KEY_PIN)) {
+        R16_PB_INT_EN &= ~USER_KEY_PIN;
+        GPIOB_ClearITFlagBit(USER_KEY_PIN);
+        tmos_start_task(userKeyTaskId, USER_KEY_DEBOUNCE_EVT, TIME_KEY_DEBOUNCE);
+    }
+}
+
+// ===================================================================
+// 状态机处理
+// ===================================================================
+
+static void UserKey_Report(uint8_t keyEvt)
+{
+    LOG_SYS("User key evt: %d\n", keyEvt);
+    if (userKeyCB) {
+        userKeyCB(keyEvt);
+    }
+}
+
+/**
+ * @brief 去抖完成后的电平变化
+ */
+static void UserKey_OnLevel(uint8_t pressed)
+{
+    if (pressed) {
+        switch (key_state) {
+            case KEY_STATE_IDLE:
+                key_state = KEY_STATE_PRESSED;
+                tmos_start_task(userKeyTaskId, USER_KEY_LONG_EVT, TIME_KEY_LONG_PRESS);
+                break;
+
+            case KEY_STATE_WAIT_DOUBLE:
+                tmos_stop_task(userKeyTaskId, USER_KEY_DOUBLE_EVT);
+                key_state = KEY_STATE_SECOND_PRESS;
+                break;
+
+            default: break;
+        }
+    } else {
+        switch (key_state) {
+            case KEY_STATE_PRESSED:
+                // 短按松开，先等待双击窗口，超时才确认为短按
+                tmos_stop_task(userKeyTaskId, USER_KEY_LONG_EVT);
+                key_state = KEY_STATE_WAIT_DOUBLE;
+                tmos_start_task(userKeyTaskId, USER_KEY_DOUBLE_EVT, TIME_KEY_DOUBLE_WINDOW);
+                break;
+
+            case KEY_STATE_SECOND_PRESS:
+                key_state = KEY_STATE_IDLE;
+                UserKey_Report(USER_KEY_DOUBLE);
+                break;
+
+            case KEY_STATE_LONG_HELD:
+                tmos_stop_task(userKeyTaskId, USER_KEY_VERY_LONG_EVT);
+                key_state = KEY_STATE_IDLE;
+                break;
+
+            default: break;
+        }
+    }
+}
+
+// ===================================================================
+// TMOS 任务
+// ===================================================================
+static uint16_t UserKey_ProcessEvent(uint8_t task_id, uint16_t events)
+{
+    // 去抖到期：采样电平，只有确实发生变化才推进状态机
+    if (events & USER_KEY_DEBOUNCE_EVT) {
+        uint8_t pressed = (READ_USER_KEY() == 0);
+        if (pressed != key_pressed) {
+            key_pressed = pressed;
+            UserKey_OnLevel(pressed);
+        }
+        UserKey_ArmIRQ();
+        return (events ^ USER_KEY_DEBOUNCE_EVT);
+    }
+
+    // 长按到期：松开前立即上报
+    if (events & USER_KEY_LONG_EVT) {
+        if (key_state == KEY_STATE_PRESSED) {
+            key_state = KEY_STATE_LONG_HELD;
+            tmos_start_task(userKeyTaskId, USER_KEY_VERY_LONG_EVT, TIME_KEY_PAIRING_PRESS - TIME_KEY_LONG_PRESS);
+            UserKey_Report(USER_KEY_LONG);
+        }
+        return (events ^ USER_KEY_LONG_EVT);
+    }
+
+    // 超长按到期：仍未松开则上报 (每次按住只上报一次)
+    if (events & USER_KEY_VERY_LONG_EVT) {
+        if (key_state == KEY_STATE_LONG_HELD) {
+            UserKey_Report(USER_KEY_VERY_LONG);
+        }
+        return (events ^ USER_KEY_VERY_LONG_EVT);
+    }
+
+    // 双击窗口超时：确认为短按
+    if (events & USER_KEY_DOUBLE_EVT) {
+        if (key_state == KEY_STATE_WAIT_DOUBLE) {
+            key_state = KEY_STATE_IDLE;
+            UserKey_Report(USER_KEY_SHORT);
+        }
+        return (events ^ USER_KEY_DOUBLE_EVT);
+    }
+
+    return 0;
+}
+
+// ===================================================================
+// 初始化
+// ===================================================================
+
+EVT_MON_DEFINE(UserKey_ProcessEvent, EVT_MON_TASK_USERKEY)
+
+/**
+ * @brief 初始化 USER 按键：上拉输入 + 电平中断 + GPIO 唤醒
+ * @param cb 按键事件回调 (USER_KEY_SHORT / USER_KEY_LONG / USER_KEY_VERY_LONG / USER_KEY_DOUBLE)
+ */
+void UserKey_Init(UserKeyCB_t cb)
+{
+    userKeyTaskId = TMOS_ProcessEventRegister(EVT_MON_FN(UserKey_ProcessEvent));
+    userKeyCB     = cb;
+    key_state     = KEY_STATE_IDLE;
+
+    GPIOB_ModeCfg(USER_KEY_PIN, GPIO_ModeIN_PU);
+    key_pressed = (READ_USER_KEY() == 0);  // 上电时按住的按键不算一次按下
+    UserKey_ArmIRQ();
+
+    PFIC_EnableIRQ(GPIO_B_IRQn);
+    PWR_PeriphWakeUpCfg(ENABLE, RB_SLP_GPIO_WAKE, Long_Delay);
+}
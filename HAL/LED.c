@@ -59,9 +59,8 @@ void HAL_LedInit(void)
 {
     /* Initialize all LEDs to OFF */
     LED1_DDR;
+    LED2_DDR;
     HalLedSet(HAL_LED_ALL, HAL_LED_MODE_OFF);
-    // just test
-    HalLedBlink(HAL_LED_1, 10, 30, 4000);
     /* Initialize sleepActive to FALSE */
     HalLedStatusControl.sleepActive = FALSE;
 }
@@ -245,7 +244,8 @@ void HalLedUpdate(void)
                         }
                         if(sts->mode & HAL_LED_MODE_BLINK)
                         {
-                            wait = (((uint32_t)pct * (uint32_t)sts->time) / 100);
+                            /* period is in msec, TMOS timers run in 625us ticks */
+                            wait = MS1_TO_SYSTEM_TIME(((uint32_t)pct * (uint32_t)sts->time) / 100);
                             sts->next = time + wait;
                         }
                         else
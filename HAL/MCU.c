@@ -13,6 +13,7 @@
 /******************************************************************************/
 /* ͷļ */
 #include "HAL.h"
+#include "evt_mon.h"
 
 tmosTaskID halTaskID;
 
@@ -216,6 +217,8 @@ tmosEvents HAL_ProcessEvent(tmosTaskID task_id, tmosEvents events)
     return 0;
 }
 
+EVT_MON_DEFINE(HAL_ProcessEvent, EVT_MON_TASK_HAL)
+
 /*******************************************************************************
  * @fn      HAL_Init
  *
@@ -227,7 +230,7 @@ tmosEvents HAL_ProcessEvent(tmosTaskID task_id, tmosEvents events)
  */
 void HAL_Init()
 {
-    halTaskID = TMOS_ProcessEventRegister(HAL_ProcessEvent);
+    halTaskID = TMOS_ProcessEventRegister(EVT_MON_FN(HAL_ProcessEvent));
     HAL_TimeInit();
 #if(defined HAL_SLEEP) && (HAL_SLEEP == TRUE)
     HAL_SleepInit();
@@ -13,6 +13,7 @@
 /******************************************************************************/
 /* ͷļ */
 #include "HAL.h"
+#include "usb_device.h"
 
 /*******************************************************************************
  * @fn          CH58X_LowPower
@@ -47,6 +48,12 @@ uint32_t CH58X_LowPower(uint32_t time)
 
     RTC_SetTignTime(time);
     SYS_RecoverIrq(irq_status);
+    // USB 豸ͨѶУ˯߻ͣ USB ʱӣֻģʽȴ RTC/USB ж
+    if(UsbDev_KeepAwake())
+    {
+        LowPower_Idle();
+        return 0;
+    }
   #if(DEBUG == Debug_UART1) // ʹӡϢҪ޸д
     while((R8_UART1_LSR & RB_LSR_TX_ALL_EMP) == 0)
     {
@@ -67,6 +74,17 @@ uint32_t CH58X_LowPower(uint32_t time)
             RTC_SetTignTime(time);
             LowPower_Idle();
         }
+        else
+        {
+            //  GPIO ȷRTCԴǰѣͬȴ32Mȶٷ
+            time = RTC_GetCycle32k() + WAKE_UP_RTC_MAX_TIME;
+            if(time > 0xA8C00000)
+            {
+                time -= 0xA8C00000;
+            }
+            RTC_SetTignTime(time);
+            LowPower_Idle();
+        }
         HSECFG_Current(HSE_RCur_100); // Ϊ(͹ĺHSEƫõ)
     }
     else
@@ -61,7 +61,7 @@
  BLE_MEMHEAP_SIZE                           - ЭջʹõRAMСС6K ( Ĭ:(1024*6) )
 
  DATA
- BLE_BUFF_MAX_LEN                           - ( Ĭ:27 (ATT_MTU=23)ȡֵΧ[27~516] )
+ BLE_BUFF_MAX_LEN                           - ( Ĭ:71 (ATT_MTU=67)ȡֵΧ[27~516] )
  BLE_BUFF_NUM                               - İ( Ĭ:5 )
  BLE_TX_NUM_EVENT                           - ¼Էٸݰ( Ĭ:1 )
  BLE_TX_POWER                               - 书( Ĭ:LL_TX_POWEER_0_DBM (0dBm) )
@@ -97,8 +97,12 @@
 #define HAL_KEY                             FALSE
 #endif
 #ifndef HAL_LED
+#ifdef ENABLE_LED
+#define HAL_LED                             TRUE    // ״̬˸ HAL LED ͳһ
+#else
 #define HAL_LED                             FALSE
 #endif
+#endif
 #ifndef TEM_SAMPLE
 #define TEM_SAMPLE                          TRUE
 #endif
@@ -127,7 +131,7 @@
 #define BLE_MEMHEAP_SIZE                    (1024*6)
 #endif
 #ifndef BLE_BUFF_MAX_LEN
-#define BLE_BUFF_MAX_LEN                    27
+#define BLE_BUFF_MAX_LEN                    71  // ATT_MTU=67ԶЭݳչ29 ֽ NKRO ĵ
 #endif
 #ifndef BLE_BUFF_NUM
 #define BLE_BUFF_NUM                        5
@@ -20,14 +20,12 @@
 #include "devinfoservice.h"
 #include "hidkbd.h"
 #include "hiddev.h"
+#include "evt_mon.h"
 
 /*********************************************************************
  * MACROS
  */
 
-// Battery measurement period in (625us)
-#define DEFAULT_BATT_PERIOD               15000
-
 // TRUE to run scan parameters refresh notify test
 #define DEFAULT_SCAN_PARAM_NOTIFY_TEST    TRUE
 
@@ -46,7 +44,6 @@
 
 // Heart Rate Task Events
 #define START_DEVICE_EVT                  0x0001
-#define BATT_PERIODIC_EVT                 0x0002
 
 /*********************************************************************
  * CONSTANTS
@@ -84,9 +81,29 @@ static uint8_t hidDevConnSecure = FALSE;
 // GAP connection handle
 static uint16_t gapConnHandle;
 
+// ATT MTU negotiated on the current connection
+static uint16_t hidDevMTU = ATT_MTU_SIZE;
+
+// TRUE once the MTU exchange has been started on the current connection
+static uint8_t hidDevMTUExchanged = FALSE;
+
 // Status of last pairing
 static uint8_t pairingStatus = SUCCESS;
 
+// Explicit pairing mode: advertising accepts requests from any host
+static uint8_t hidDevPairingMode = FALSE;
+
+// TRUE while the open advertising of the current pairing mode is running
+static uint8_t hidDevPairingAdv = FALSE;
+
+// Scan requests that passed the advertising filter
+static uint32_t hidDevScanReqCount = 0;
+
+// Reconnect advertising timing, tuned by the application from the host's scan parameters
+static hidDevAdvParam_t hidDevReconnAdv = {
+    HID_HIGH_ADV_INT_MIN, HID_HIGH_ADV_INT_MAX, HID_HIGH_ADV_TIMEOUT,
+    HID_LOW_ADV_INT_MIN, HID_LOW_ADV_INT_MAX};
+
 static hidRptMap_t *pHidDevRptTbl;
 
 static uint8_t hidDevRptTblLen;
@@ -106,12 +123,12 @@ static void hidDevDisconnected(void);
 static void hidDevGapStateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent);
 static void hidDevParamUpdateCB(uint16_t connHandle, uint16_t connInterval,
                                 uint16_t connSlaveLatency, uint16_t connTimeout);
+static void hidDevRssiCB(uint16_t connHandle, int8_t newRSSI);
 static void hidDevPairStateCB(uint16_t connHandle, uint8_t state, uint8_t status);
 static void hidDevPasscodeCB(uint8_t *deviceAddr, uint16_t connectionHandle,
                              uint8_t uiInputs, uint8_t uiOutputs);
 static void hidDevBattCB(uint8_t event);
 static void hidDevScanParamCB(uint8_t event);
-static void hidDevBattPeriodicTask(void);
 
 static hidRptMap_t *hidDevRptByHandle(uint16_t handle);
 static hidRptMap_t *hidDevRptById(uint8_t id, uint8_t type);
@@ -121,8 +138,11 @@ static uint8_t hidDevSendReport(uint8_t id, uint8_t type, uint8_t len, uint8_t *
 static void    hidDevHighAdvertising(void);
 static void    hidDevLowAdvertising(void);
 static void    hidDevInitialAdvertising(void);
+static void    hidDevSetAdvFilter(void);
+static void    hidDevEndPairing(void);
 static uint8_t hidDevBondCount(void);
 static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData);
+static void    hidDevExchangeMTU(void);
 /*********************************************************************
  * PROFILE CALLBACKS
  */
@@ -130,7 +150,7 @@ static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData);
 // GAP Role Callbacks
 static gapRolesCBs_t hidDev_PeripheralCBs = {
     hidDevGapStateCB, // Profile State Change Callbacks
-    NULL,             // When a valid RSSI is read from controller
+    hidDevRssiCB,     // When a valid RSSI is read from controller
     hidDevParamUpdateCB
 };
 
@@ -145,6 +165,8 @@ static gapBondCBs_t hidDevBondCB = {
  * PUBLIC FUNCTIONS
  */
 
+EVT_MON_DEFINE(HidDev_ProcessEvent, EVT_MON_TASK_HIDDEV)
+
 /*********************************************************************
  * @fn      HidDev_Init
  *
@@ -161,17 +183,23 @@ static gapBondCBs_t hidDevBondCB = {
  */
 void HidDev_Init()
 {
-    hidDevTaskId = TMOS_ProcessEventRegister(HidDev_ProcessEvent);
+    hidDevTaskId = TMOS_ProcessEventRegister(EVT_MON_FN(HidDev_ProcessEvent));
 
     // Setup the GAP Bond Manager
     {
         uint8_t syncWL = TRUE;
+        uint8_t syncRL = TRUE;
 
         // If a bond is created, the HID Device should write the address of the
         // HID Host in the HID Device controller's white list and set the HID
         // Device controller's advertising filter policy to 'process scan and
         // connection requests only from devices in the White List'.
         GAPBondMgr_SetParameter(GAPBOND_AUTO_SYNC_WL, sizeof(uint8_t), &syncWL);
+
+        // Hosts advertise and scan with resolvable private addresses; the
+        // resolving list lets the controller match them to the bonded identity
+        // address in the white list.
+        GAPBondMgr_SetParameter(GAPBOND_AUTO_SYNC_RL, sizeof(uint8_t), &syncRL);
     }
 
     // Set up services
@@ -181,6 +209,9 @@ void HidDev_Init()
     Batt_AddService();
     ScanParam_AddService();
 
+    // GATT client is needed to initiate the ATT MTU exchange
+    GATT_InitClient();
+
     // Register for Battery service callback
     Batt_Register(hidDevBattCB);
 
@@ -232,14 +263,6 @@ uint16_t HidDev_ProcessEvent(uint8_t task_id, uint16_t events)
         return (events ^ START_DEVICE_EVT);
     }
 
-    if(events & BATT_PERIODIC_EVT)
-    {
-        // Perform periodic battery task
-        hidDevBattPeriodicTask();
-
-        return (events ^ BATT_PERIODIC_EVT);
-    }
-
     return 0;
 }
 
@@ -318,6 +341,48 @@ uint8_t HidDev_Report(uint8_t id, uint8_t type, uint8_t len, uint8_t *pData)
     return bleNotReady;
 }
 
+/*********************************************************************
+ * @fn      HidDev_GetMaxReportLen
+ *
+ * @brief   Largest report that fits in one notification on the
+ *          current connection (ATT_MTU - 3).
+ *
+ * @return  Report length in bytes.
+ */
+uint8_t HidDev_GetMaxReportLen(void)
+{
+    return (hidDevMTU - 3 > 0xFF) ? 0xFF : (uint8_t)(hidDevMTU - 3);
+}
+
+/*********************************************************************
+ * @fn      HidDev_IsNotifyEnabled
+ *
+ * @brief   Whether the host has enabled notifications for a report
+ *          on the current connection.
+ *
+ * @param   id - HID report ID.
+ * @param   type - HID report type.
+ *
+ * @return  TRUE if enabled, FALSE otherwise.
+ */
+uint8_t HidDev_IsNotifyEnabled(uint8_t id, uint8_t type)
+{
+    hidRptMap_t     *pRpt;
+    gattAttribute_t *pAttr;
+    uint16_t         retHandle;
+
+    if(hidDevGapState != GAPROLE_CONNECTED || !hidDevConnSecure)
+    {
+        return FALSE;
+    }
+    if((pRpt = hidDevRptById(id, type)) == NULL ||
+       (pAttr = GATT_FindHandle(pRpt->cccdHandle, &retHandle)) == NULL)
+    {
+        return FALSE;
+    }
+    return (GATTServApp_ReadCharCfg(gapConnHandle, (gattCharCfg_t *)pAttr->pValue) & GATT_CLIENT_CFG_NOTIFY) ? TRUE : FALSE;
+}
+
 /*********************************************************************
  * @fn      HidDev_Close
  *
@@ -373,6 +438,56 @@ bStatus_t HidDev_SetParameter(uint8_t param, uint8_t len, void *pValue)
 
                 // Erase bonding info
                 GAPBondMgr_SetParameter(GAPBOND_ERASE_ALLBONDS, 0, NULL);
+                hidDevSetAdvFilter();
+            }
+            else
+            {
+                ret = bleInvalidRange;
+            }
+            break;
+
+        case HIDDEV_RECONNECT_ADV:
+            if(len == sizeof(hidDevAdvParam_t))
+            {
+                tmos_memcpy(&hidDevReconnAdv, pValue, sizeof(hidDevAdvParam_t));
+            }
+            else
+            {
+                ret = bleInvalidRange;
+            }
+            break;
+
+        case HIDDEV_PAIRING_MODE:
+            if(len == sizeof(uint8_t))
+            {
+                if(*((uint8_t *)pValue) == FALSE)
+                {
+                    hidDevEndPairing();
+                }
+                else if(!hidDevPairingMode)
+                {
+                    uint8_t param = FALSE;
+
+                    hidDevPairingMode = TRUE;
+                    hidDevPairingAdv = FALSE;
+                    hidDevSetAdvFilter();
+
+                    // Drop the current host or restart advertising with the
+                    // filter open; open advertising starts once the link or
+                    // the filtered advertising has stopped
+                    if(hidDevGapState == GAPROLE_CONNECTED)
+                    {
+                        GAPRole_TerminateLink(gapConnHandle);
+                    }
+                    else if((hidDevGapState & GAPROLE_STATE_ADV_MASK) == GAPROLE_ADVERTISING)
+                    {
+                        GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &param);
+                    }
+                    else
+                    {
+                        hidDevInitialAdvertising();
+                    }
+                }
             }
             else
             {
@@ -407,6 +522,18 @@ bStatus_t HidDev_GetParameter(uint8_t param, void *pValue)
 
     switch(param)
     {
+        case HIDDEV_RECONNECT_ADV:
+            tmos_memcpy(pValue, &hidDevReconnAdv, sizeof(hidDevAdvParam_t));
+            break;
+
+        case HIDDEV_PAIRING_MODE:
+            *((uint8_t *)pValue) = hidDevPairingMode;
+            break;
+
+        case HIDDEV_SCAN_REQ_COUNT:
+            *((uint32_t *)pValue) = hidDevScanReqCount;
+            break;
+
         default:
             ret = INVALIDPARAMETER;
             break;
@@ -564,7 +691,10 @@ bStatus_t HidDev_WriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
             if(pValue[0] == HID_CMD_SUSPEND || pValue[0] == HID_CMD_EXIT_SUSPEND)
             {
                 // execute HID app event callback
-                (*pHidDevCB->evtCB)((pValue[0] == HID_CMD_SUSPEND) ? HID_DEV_SUSPEND_EVT : HID_DEV_EXIT_SUSPEND_EVT);
+                if(pHidDevCB && pHidDevCB->evtCB)
+                {
+                    (*pHidDevCB->evtCB)((pValue[0] == HID_CMD_SUSPEND) ? HID_DEV_SUSPEND_EVT : HID_DEV_EXIT_SUSPEND_EVT);
+                }
             }
             else
             {
@@ -604,7 +734,10 @@ bStatus_t HidDev_WriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
                 pAttr->pValue[0] = pValue[0];
 
                 // execute HID app event callback
-                (*pHidDevCB->evtCB)((pValue[0] == HID_PROTOCOL_MODE_BOOT) ? HID_DEV_SET_BOOT_EVT : HID_DEV_SET_REPORT_EVT);
+                if(pHidDevCB && pHidDevCB->evtCB)
+                {
+                    (*pHidDevCB->evtCB)((pValue[0] == HID_PROTOCOL_MODE_BOOT) ? HID_DEV_SET_BOOT_EVT : HID_DEV_SET_REPORT_EVT);
+                }
             }
             else
             {
@@ -659,6 +792,19 @@ static void hidDev_ProcessTMOSMsg(tmos_event_hdr_t *pMsg)
  */
 static void hidDevProcessGattMsg(gattMsgEvent_t *pMsg)
 {
+    if(pMsg->method == ATT_MTU_UPDATED_EVENT)
+    {
+        hidDevMTU = pMsg->msg.mtuEvt.MTU;
+        PRINT("MTU updated: %d\n", hidDevMTU);
+    }
+    else if(pMsg->method == ATT_ERROR_RSP &&
+            pMsg->msg.errorRsp.reqOpcode == ATT_EXCHANGE_MTU_REQ)
+    {
+        // host refused, keep the default MTU and the compact reports
+        PRINT("MTU exchange refused\n");
+    }
+
+    GATT_bm_free(&pMsg->msg, pMsg->method);
 }
 
 /*********************************************************************
@@ -676,10 +822,8 @@ static void hidDevProcessGAPMsg(gapRoleEvent_t *pEvent)
     {
         case GAP_SCAN_REQUEST_EVENT:
         {
-            PRINT("recv scan Req addr ");
-            for(int i = 0; i < B_ADDR_LEN; i++)
-                PRINT("%02x ", pEvent->scanReqEvt.scannerAddr[i]);
-            PRINT("\n");
+            // counted rather than printed, a crowded room sends hundreds per minute
+            hidDevScanReqCount++;
             break;
         }
 
@@ -747,11 +891,18 @@ static void hidDevDisconnected(void)
 
     // Reset state variables
     hidDevConnSecure = FALSE;
+    hidDevMTU = ATT_MTU_SIZE;
+    hidDevMTUExchanged = FALSE;
     hidProtocolMode = HID_PROTOCOL_MODE_REPORT;
 
+    // in pairing mode reopen advertising to any host
+    if(hidDevPairingMode)
+    {
+        hidDevInitialAdvertising();
+    }
     // if bonded and normally connectable start advertising
-    if((hidDevBondCount() > 0) &&
-       (pHidDevCfg->hidFlags & HID_FLAGS_NORMALLY_CONNECTABLE))
+    else if((hidDevBondCount() > 0) &&
+            (pHidDevCfg->hidFlags & HID_FLAGS_NORMALLY_CONNECTABLE))
     {
         hidDevLowAdvertising();
     }
@@ -779,6 +930,8 @@ static void hidDevGapStateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent)
 
         // connection not secure yet
         hidDevConnSecure = FALSE;
+        hidDevMTU = ATT_MTU_SIZE;
+        hidDevMTUExchanged = FALSE;
 
         // don't start advertising when connection is closed
         param = FALSE;
@@ -798,10 +951,25 @@ static void hidDevGapStateCB(gapRole_States_t newState, gapRoleEvent_t *pEvent)
             pairingStatus = SUCCESS;
         }
     }
+    // if advertising stopped in pairing mode
+    else if((newState & GAPROLE_STATE_ADV_MASK) == GAPROLE_WAITING && hidDevPairingMode)
+    {
+        if(!hidDevPairingAdv)
+        {
+            // filtered advertising stopped, start the open advertising
+            hidDevInitialAdvertising();
+        }
+        else
+        {
+            // no host paired before the open advertising timed out
+            hidDevEndPairing();
+        }
+    }
     // if started
     else if(newState == GAPROLE_STARTED)
     {
-        // nothing to do for now!
+        // bonds are loaded, set the filter before advertising starts
+        hidDevSetAdvFilter();
     }
 
     if(pHidDevCB && pHidDevCB->pfnStateChange)
@@ -829,6 +997,31 @@ static void hidDevParamUpdateCB(uint16_t connHandle, uint16_t connInterval,
                                 uint16_t connSlaveLatency, uint16_t connTimeout)
 {
     PRINT("Update %d - Int 0x%x - Latency %d\n", connHandle, connInterval, connSlaveLatency);
+
+    if(pHidDevCB && pHidDevCB->pfnParamUpdate)
+    {
+        // execute HID app parameter update callback
+        (*pHidDevCB->pfnParamUpdate)(connHandle, connInterval, connSlaveLatency, connTimeout);
+    }
+}
+
+/*********************************************************************
+ * @fn      hidDevRssiCB
+ *
+ * @brief   RSSI read complete callback
+ *
+ * @param   connHandle - connect handle
+ *          newRSSI - RSSI of the last packet received (dBm)
+ *
+ * @return  none
+ */
+static void hidDevRssiCB(uint16_t connHandle, int8_t newRSSI)
+{
+    if(pHidDevCB && pHidDevCB->pfnRssiRead)
+    {
+        // execute HID app RSSI callback
+        (*pHidDevCB->pfnRssiRead)(connHandle, newRSSI);
+    }
 }
 
 /*********************************************************************
@@ -845,6 +1038,8 @@ static void hidDevPairStateCB(uint16_t connHandle, uint8_t state, uint8_t status
         if(status == SUCCESS)
         {
             hidDevConnSecure = TRUE;
+            hidDevExchangeMTU();
+            hidDevEndPairing();
         }
 
         pairingStatus = status;
@@ -854,6 +1049,8 @@ static void hidDevPairStateCB(uint16_t connHandle, uint8_t state, uint8_t status
         if(status == SUCCESS)
         {
             hidDevConnSecure = TRUE;
+            hidDevExchangeMTU();
+            hidDevEndPairing();
 
 #if DEFAULT_SCAN_PARAM_NOTIFY_TEST == TRUE
             ScanParam_RefreshNotify(gapConnHandle);
@@ -863,6 +1060,12 @@ static void hidDevPairStateCB(uint16_t connHandle, uint8_t state, uint8_t status
     else if(state == GAPBOND_PAIRING_STATE_BOND_SAVED)
     {
     }
+
+    if(pHidDevCB && pHidDevCB->pairStateCB)
+    {
+        // execute HID app pairing state callback
+        (*pHidDevCB->pairStateCB)(connHandle, state, status);
+    }
 }
 
 /*********************************************************************
@@ -906,15 +1109,9 @@ static void hidDevPasscodeCB(uint8_t *deviceAddr, uint16_t connectionHandle,
  */
 static void hidDevBattCB(uint8_t event)
 {
-    if(event == BATT_LEVEL_NOTI_ENABLED)
-    {
-        tmos_start_task(hidDevTaskId, BATT_PERIODIC_EVT, DEFAULT_BATT_PERIOD);
-    }
-    else if(event == BATT_LEVEL_NOTI_DISABLED)
-    {
-        // stop periodic measurement
-        tmos_stop_task(hidDevTaskId, BATT_PERIODIC_EVT);
-    }
+    // Battery sampling is owned by the application battery subsystem
+    // (single ADC schedule), which pushes level changes through
+    // Batt_SetParameter(). Nothing to start or stop here.
 }
 
 /*********************************************************************
@@ -928,24 +1125,19 @@ static void hidDevBattCB(uint8_t event)
  */
 static void hidDevScanParamCB(uint8_t event)
 {
-}
+    uint16_t interval, window;
 
-/*********************************************************************
- * @fn      hidDevBattPeriodicTask
- *
- * @brief   Perform a periodic task for battery measurement.
- *
- * @param   none
- *
- * @return  none
- */
-static void hidDevBattPeriodicTask(void)
-{
-    // perform battery level check
-    Batt_MeasLevel();
+    if(event == SCAN_INTERVAL_WINDOW_SET)
+    {
+        ScanParam_GetParameter(SCAN_PARAM_PARAM_INTERVAL, &interval);
+        ScanParam_GetParameter(SCAN_PARAM_PARAM_WINDOW, &window);
 
-    // Restart timer
-    tmos_start_task(hidDevTaskId, BATT_PERIODIC_EVT, DEFAULT_BATT_PERIOD);
+        // execute HID app scan parameter callback
+        if(pHidDevCB && pHidDevCB->scanParamCB)
+        {
+            (*pHidDevCB->scanParamCB)(gapConnHandle, interval, window);
+        }
+    }
 }
 
 /*********************************************************************
@@ -1100,6 +1292,32 @@ static uint8_t HidDev_sendNoti(uint16_t handle, uint8_t len, uint8_t *pData)
     return status;
 }
 
+/*********************************************************************
+ * @fn      hidDevExchangeMTU
+ *
+ * @brief   Request the largest ATT MTU the controller buffer allows,
+ *          once per connection and only if the host has not already
+ *          exchanged it.  Data length is negotiated by the controller
+ *          itself from BLE_BUFF_MAX_LEN.
+ *
+ * @return  none
+ */
+static void hidDevExchangeMTU(void)
+{
+    attExchangeMTUReq_t req;
+
+    if(hidDevMTUExchanged || hidDevMTU > ATT_MTU_SIZE || BLE_BUFF_MAX_LEN - 4 <= ATT_MTU_SIZE)
+    {
+        return;
+    }
+
+    req.clientRxMTU = BLE_BUFF_MAX_LEN - 4;
+    if(GATT_ExchangeMTU(gapConnHandle, &req, hidDevTaskId) == SUCCESS)
+    {
+        hidDevMTUExchanged = TRUE;
+    }
+}
+
 /*********************************************************************
  * @fn      hidDevHighAdvertising
  *
@@ -1113,9 +1331,10 @@ static void hidDevHighAdvertising(void)
 {
     uint8_t param;
 
-    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, HID_HIGH_ADV_INT_MIN);
-    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, HID_HIGH_ADV_INT_MAX);
-    GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, HID_HIGH_ADV_TIMEOUT);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, hidDevReconnAdv.highIntMin);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, hidDevReconnAdv.highIntMax);
+    GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, hidDevReconnAdv.highTimeout);
+    hidDevSetAdvFilter();
 
     param = TRUE;
     GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &param);
@@ -1134,9 +1353,10 @@ static void hidDevLowAdvertising(void)
 {
     uint8_t param;
 
-    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, HID_LOW_ADV_INT_MIN);
-    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, HID_LOW_ADV_INT_MAX);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, hidDevReconnAdv.lowIntMin);
+    GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, hidDevReconnAdv.lowIntMax);
     GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, HID_LOW_ADV_TIMEOUT);
+    hidDevSetAdvFilter();
 
     param = TRUE;
     GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &param);
@@ -1156,11 +1376,55 @@ static void hidDevInitialAdvertising(void)
     GAP_SetParamValue(TGAP_DISC_ADV_INT_MIN, HID_INITIAL_ADV_INT_MIN);
     GAP_SetParamValue(TGAP_DISC_ADV_INT_MAX, HID_INITIAL_ADV_INT_MAX);
     GAP_SetParamValue(TGAP_LIM_ADV_TIMEOUT, HID_INITIAL_ADV_TIMEOUT);
+    hidDevSetAdvFilter();
+    hidDevPairingAdv = hidDevPairingMode;
 
     param = TRUE;
     GAPRole_SetParameter(GAPROLE_ADVERT_ENABLED, sizeof(uint8_t), &param);
 }
 
+/*********************************************************************
+ * @fn      hidDevSetAdvFilter
+ *
+ * @brief   Restrict scan and connection requests to bonded hosts (the
+ *          white list kept in sync by the bond manager), unless there
+ *          are no bonds yet or pairing mode is on.  Takes effect the
+ *          next time advertising starts.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+static void hidDevSetAdvFilter(void)
+{
+    uint8_t policy = GAP_FILTER_POLICY_WHITE;
+
+    if(hidDevPairingMode || hidDevBondCount() == 0)
+    {
+        policy = GAP_FILTER_POLICY_ALL;
+    }
+    GAPRole_SetParameter(GAPROLE_ADV_FILTER_POLICY, sizeof(uint8_t), &policy);
+}
+
+/*********************************************************************
+ * @fn      hidDevEndPairing
+ *
+ * @brief   Leave pairing mode; later advertising is filtered again.
+ *
+ * @param   None.
+ *
+ * @return  None.
+ */
+static void hidDevEndPairing(void)
+{
+    if(hidDevPairingMode)
+    {
+        hidDevPairingMode = FALSE;
+        hidDevPairingAdv = FALSE;
+        hidDevSetAdvFilter();
+    }
+}
+
 /*********************************************************************
  * @fn      hidDevBondCount
  *
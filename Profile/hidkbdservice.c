@@ -36,7 +36,7 @@ static const uint8_t hidInfo[HID_INFORMATION_LEN] = {
 };
 
 // ===================================================================
-// 1. HID Report Map (֤ + )
+// 1. HID Report Map (֤ +  + NKRO  + ϲ + λ + ֱ)
 // ===================================================================
 static const uint8_t hidReportMap[] = {
     // --- Keyboard (ID 1) ---
@@ -50,7 +50,40 @@ static const uint8_t hidReportMap[] = {
     0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x02, 
     0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01, 0x95, 0x03, 
     0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x03, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 
-    0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06, 0xC0, 0xC0
+    0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06, 0xC0, 0xC0,
+
+    // --- NKRO Keyboard (ID 3): 8 bit Mods + 224 bit λͼ (usage 0x00~0xDF) ---
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x03,
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+    0x19, 0x00, 0x29, HID_NKRO_KEY_MAX, 0x95, HID_NKRO_KEY_MAX + 1, 0x81, 0x02, 0xC0,
+
+#ifdef ENABLE_COMBO_REPORT
+    // --- Combo (ID 4): ׼ 8 ֽ +  4 ֽڣͬʱ仯ʱһ֪ͨ ---
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x04,
+    0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+    0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x25, 0x65,
+    0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00,
+    0x05, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01,
+    0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x03, 0x05, 0x01, 0x09, 0x30,
+    0x09, 0x31, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06, 0xC0, 0xC0,
+#endif
+
+    // --- Digitizer Pen (ID 5): ʼ//Ƥ/ͣ 4 bit +  4 bit +  X/Y + ѹ ---
+    0x05, 0x0D, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x05, 0x09, 0x20, 0xA1, 0x00,
+    0x09, 0x42, 0x09, 0x44, 0x09, 0x45, 0x09, 0x32, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x04, 0x81, 0x02,
+    0x95, 0x04, 0x81, 0x03,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x26, LO_UINT16(HID_ABS_XY_MAX), HI_UINT16(HID_ABS_XY_MAX),
+    0x75, 0x10, 0x95, 0x02, 0x81, 0x02,
+    0x05, 0x0D, 0x09, 0x30, 0x26, LO_UINT16(HID_ABS_PRESSURE_MAX), HI_UINT16(HID_ABS_PRESSURE_MAX),
+    0x95, 0x01, 0x81, 0x02, 0xC0, 0xC0,
+
+    // --- Gamepad (ID 6): 16  + ޣ 4 bit (ΧΪɿ) +  4 bit + 6  int8 ---
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01, 0x85, 0x06,
+    0x05, 0x09, 0x19, 0x01, 0x29, HID_GAMEPAD_BUTTONS, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, HID_GAMEPAD_BUTTONS, 0x81, 0x02,
+    0x05, 0x01, 0x09, 0x39, 0x15, 0x00, 0x25, 0x07, 0x35, 0x00, 0x46, 0x3B, 0x01, 0x65, 0x14,
+    0x75, 0x04, 0x95, 0x01, 0x81, 0x42, 0x65, 0x00, 0x45, 0x00, 0x81, 0x03,
+    0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x33, 0x09, 0x34, 0x09, 0x35,
+    0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, HID_GAMEPAD_AXES, 0x81, 0x02, 0xC0,
 };
 
 // HID report map length
@@ -100,6 +133,12 @@ static uint8_t       hidReportMouseIn;
 static gattCharCfg_t hidReportMouseInClientCharCfg[GATT_MAX_NUM_CONN];
 static uint8_t hidReportRefMouseIn[HID_REPORT_REF_LEN] = {HID_RPT_ID_MOUSE_IN, HID_REPORT_TYPE_INPUT};
 
+// --- Report 3: NKRO Keyboard Input ---
+static uint8_t       hidReportNkroInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8_t       hidReportNkroIn;
+static gattCharCfg_t hidReportNkroInClientCharCfg[GATT_MAX_NUM_CONN];
+static uint8_t hidReportRefNkroIn[HID_REPORT_REF_LEN] = {HID_RPT_ID_NKRO_IN, HID_REPORT_TYPE_INPUT};
+
 // --- Boot Keyboard ---
 static uint8_t       hidReportBootKeyInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
 static uint8_t       hidReportBootKeyIn;
@@ -107,6 +146,26 @@ static gattCharCfg_t hidReportBootKeyInClientCharCfg[GATT_MAX_NUM_CONN];
 static uint8_t hidReportBootKeyOutProps = GATT_PROP_READ | GATT_PROP_WRITE | GATT_PROP_WRITE_NO_RSP;
 static uint8_t hidReportBootKeyOut;
 
+#ifdef ENABLE_COMBO_REPORT
+// --- Report 4: Keyboard + Mouse Combo Input ---
+static uint8_t       hidReportComboInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8_t       hidReportComboIn;
+static gattCharCfg_t hidReportComboInClientCharCfg[GATT_MAX_NUM_CONN];
+static uint8_t hidReportRefComboIn[HID_REPORT_REF_LEN] = {HID_RPT_ID_COMBO_IN, HID_REPORT_TYPE_INPUT};
+#endif
+
+// --- Report 5: Digitizer Pen Input ---
+static uint8_t       hidReportAbsInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8_t       hidReportAbsIn;
+static gattCharCfg_t hidReportAbsInClientCharCfg[GATT_MAX_NUM_CONN];
+static uint8_t hidReportRefAbsIn[HID_REPORT_REF_LEN] = {HID_RPT_ID_ABS_IN, HID_REPORT_TYPE_INPUT};
+
+// --- Report 6: Gamepad Input ---
+static uint8_t       hidReportGamepadInProps = GATT_PROP_READ | GATT_PROP_NOTIFY;
+static uint8_t       hidReportGamepadIn;
+static gattCharCfg_t hidReportGamepadInClientCharCfg[GATT_MAX_NUM_CONN];
+static uint8_t hidReportRefGamepadIn[HID_REPORT_REF_LEN] = {HID_RPT_ID_GAMEPAD_IN, HID_REPORT_TYPE_INPUT};
+
 // Feature Report
 static uint8_t hidReportFeatureProps = GATT_PROP_READ | GATT_PROP_WRITE;
 static uint8_t hidReportFeature;
@@ -172,6 +231,40 @@ static gattAttribute_t hidAttrTbl[] = {
     { {ATT_BT_UUID_SIZE, characterUUID}, GATT_PERMIT_READ, 0, &hidReportFeatureProps},
     { {ATT_BT_UUID_SIZE, hidReportUUID}, GATT_PERMIT_ENCRYPT_READ | GATT_PERMIT_ENCRYPT_WRITE, 0, &hidReportFeature},
     { {ATT_BT_UUID_SIZE, reportRefUUID}, GATT_PERMIT_READ, 0, hidReportRefFeature},
+
+#ifdef ENABLE_COMBO_REPORT
+    // --------------------------------------------------------
+    // Report 4: Keyboard + Mouse Combo Input (ڱβӰǰԵľ)
+    // --------------------------------------------------------
+    { {ATT_BT_UUID_SIZE, characterUUID}, GATT_PERMIT_READ, 0, &hidReportComboInProps},
+    { {ATT_BT_UUID_SIZE, hidReportUUID}, GATT_PERMIT_ENCRYPT_READ, 0, &hidReportComboIn},
+    { {ATT_BT_UUID_SIZE, clientCharCfgUUID}, GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE, 0, (uint8_t *)&hidReportComboInClientCharCfg},
+    { {ATT_BT_UUID_SIZE, reportRefUUID}, GATT_PERMIT_READ, 0, hidReportRefComboIn},
+#endif
+
+    // --------------------------------------------------------
+    // Report 5: Digitizer Pen Input (ͬڱβ)
+    // --------------------------------------------------------
+    { {ATT_BT_UUID_SIZE, characterUUID}, GATT_PERMIT_READ, 0, &hidReportAbsInProps},
+    { {ATT_BT_UUID_SIZE, hidReportUUID}, GATT_PERMIT_ENCRYPT_READ, 0, &hidReportAbsIn},
+    { {ATT_BT_UUID_SIZE, clientCharCfgUUID}, GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE, 0, (uint8_t *)&hidReportAbsInClientCharCfg},
+    { {ATT_BT_UUID_SIZE, reportRefUUID}, GATT_PERMIT_READ, 0, hidReportRefAbsIn},
+
+    // --------------------------------------------------------
+    // Report 6: Gamepad Input (ͬڱβ)
+    // --------------------------------------------------------
+    { {ATT_BT_UUID_SIZE, characterUUID}, GATT_PERMIT_READ, 0, &hidReportGamepadInProps},
+    { {ATT_BT_UUID_SIZE, hidReportUUID}, GATT_PERMIT_ENCRYPT_READ, 0, &hidReportGamepadIn},
+    { {ATT_BT_UUID_SIZE, clientCharCfgUUID}, GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE, 0, (uint8_t *)&hidReportGamepadInClientCharCfg},
+    { {ATT_BT_UUID_SIZE, reportRefUUID}, GATT_PERMIT_READ, 0, hidReportRefGamepadIn},
+
+    // --------------------------------------------------------
+    // Report 3: NKRO Keyboard Input (ͬڱβ󶨵 Boot/Feature )
+    // --------------------------------------------------------
+    { {ATT_BT_UUID_SIZE, characterUUID}, GATT_PERMIT_READ, 0, &hidReportNkroInProps},
+    { {ATT_BT_UUID_SIZE, hidReportUUID}, GATT_PERMIT_ENCRYPT_READ, 0, &hidReportNkroIn},
+    { {ATT_BT_UUID_SIZE, clientCharCfgUUID}, GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE, 0, (uint8_t *)&hidReportNkroInClientCharCfg},
+    { {ATT_BT_UUID_SIZE, reportRefUUID}, GATT_PERMIT_READ, 0, hidReportRefNkroIn},
 };
 
 // Աö
@@ -194,7 +287,17 @@ enum
     HID_BOOT_KEY_IN_DECL_IDX, HID_BOOT_KEY_IN_IDX, HID_BOOT_KEY_IN_CCCD_IDX,
     HID_BOOT_KEY_OUT_DECL_IDX, HID_BOOT_KEY_OUT_IDX,
     // Feature
-    HID_FEATURE_DECL_IDX, HID_FEATURE_IDX, HID_REPORT_REF_FEATURE_IDX
+    HID_FEATURE_DECL_IDX, HID_FEATURE_IDX, HID_REPORT_REF_FEATURE_IDX,
+#ifdef ENABLE_COMBO_REPORT
+    // Combo Input
+    HID_REPORT_COMBO_IN_DECL_IDX, HID_REPORT_COMBO_IN_IDX, HID_REPORT_COMBO_IN_CCCD_IDX, HID_REPORT_REF_COMBO_IN_IDX,
+#endif
+    // Digitizer Pen Input
+    HID_REPORT_ABS_IN_DECL_IDX, HID_REPORT_ABS_IN_IDX, HID_REPORT_ABS_IN_CCCD_IDX, HID_REPORT_REF_ABS_IN_IDX,
+    // Gamepad Input
+    HID_REPORT_GAMEPAD_IN_DECL_IDX, HID_REPORT_GAMEPAD_IN_IDX, HID_REPORT_GAMEPAD_IN_CCCD_IDX, HID_REPORT_REF_GAMEPAD_IN_IDX,
+    // NKRO Keyboard Input
+    HID_REPORT_NKRO_IN_DECL_IDX, HID_REPORT_NKRO_IN_IDX, HID_REPORT_NKRO_IN_CCCD_IDX, HID_REPORT_REF_NKRO_IN_IDX,
 };
 
 /*********************************************************************
@@ -218,6 +321,12 @@ bStatus_t Hid_AddService(void)
     GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportKeyInClientCharCfg);
     GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportMouseInClientCharCfg); // ʼ
     GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportBootKeyInClientCharCfg);
+#ifdef ENABLE_COMBO_REPORT
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportComboInClientCharCfg);
+#endif
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportAbsInClientCharCfg);
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportGamepadInClientCharCfg);
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, hidReportNkroInClientCharCfg);
 
     // Register GATT
     status = GATTServApp_RegisterService(hidAttrTbl, GATT_NUM_ATTRS(hidAttrTbl), GATT_MAX_ENCRYPT_KEY_SIZE, &hidKbdCBs);
@@ -267,8 +376,38 @@ bStatus_t Hid_AddService(void)
     hidRptMap[5].cccdHandle = 0;
     hidRptMap[5].mode = HID_PROTOCOL_MODE_REPORT;
 
-    // Battery level
-    Batt_GetParameter(BATT_PARAM_BATT_LEVEL_IN_REPORT, &(hidRptMap[6]));
+#ifdef ENABLE_COMBO_REPORT
+    // Combo Input
+    hidRptMap[6].id = hidReportRefComboIn[0];
+    hidRptMap[6].type = hidReportRefComboIn[1];
+    hidRptMap[6].handle = hidAttrTbl[HID_REPORT_COMBO_IN_IDX].handle;
+    hidRptMap[6].cccdHandle = hidAttrTbl[HID_REPORT_COMBO_IN_CCCD_IDX].handle;
+    hidRptMap[6].mode = HID_PROTOCOL_MODE_REPORT;
+#endif
+
+    // Digitizer Pen Input
+    hidRptMap[HID_NUM_REPORTS - 4].id = hidReportRefAbsIn[0];
+    hidRptMap[HID_NUM_REPORTS - 4].type = hidReportRefAbsIn[1];
+    hidRptMap[HID_NUM_REPORTS - 4].handle = hidAttrTbl[HID_REPORT_ABS_IN_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 4].cccdHandle = hidAttrTbl[HID_REPORT_ABS_IN_CCCD_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 4].mode = HID_PROTOCOL_MODE_REPORT;
+
+    // Gamepad Input
+    hidRptMap[HID_NUM_REPORTS - 3].id = hidReportRefGamepadIn[0];
+    hidRptMap[HID_NUM_REPORTS - 3].type = hidReportRefGamepadIn[1];
+    hidRptMap[HID_NUM_REPORTS - 3].handle = hidAttrTbl[HID_REPORT_GAMEPAD_IN_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 3].cccdHandle = hidAttrTbl[HID_REPORT_GAMEPAD_IN_CCCD_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 3].mode = HID_PROTOCOL_MODE_REPORT;
+
+    // NKRO Keyboard Input
+    hidRptMap[HID_NUM_REPORTS - 2].id = hidReportRefNkroIn[0];
+    hidRptMap[HID_NUM_REPORTS - 2].type = hidReportRefNkroIn[1];
+    hidRptMap[HID_NUM_REPORTS - 2].handle = hidAttrTbl[HID_REPORT_NKRO_IN_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 2].cccdHandle = hidAttrTbl[HID_REPORT_NKRO_IN_CCCD_IDX].handle;
+    hidRptMap[HID_NUM_REPORTS - 2].mode = HID_PROTOCOL_MODE_REPORT;
+
+    // Battery level ( HID_NUM_REPORTSһ)
+    Batt_GetParameter(BATT_PARAM_BATT_LEVEL_IN_REPORT, &(hidRptMap[HID_NUM_REPORTS - 1]));
 
     HidDev_RegisterReports(HID_NUM_REPORTS, hidRptMap);
 
@@ -281,6 +420,12 @@ uint16_t Hid_GetAttrHandle(uint8_t id, uint8_t type)
     if (type == HID_REPORT_TYPE_INPUT) {
         if (id == HID_RPT_ID_KEY_IN) return hidAttrTbl[HID_REPORT_KEY_IN_IDX].handle;
         if (id == HID_RPT_ID_MOUSE_IN) return hidAttrTbl[HID_REPORT_MOUSE_IN_IDX].handle;
+        if (id == HID_RPT_ID_NKRO_IN) return hidAttrTbl[HID_REPORT_NKRO_IN_IDX].handle;
+#ifdef ENABLE_COMBO_REPORT
+        if (id == HID_RPT_ID_COMBO_IN) return hidAttrTbl[HID_REPORT_COMBO_IN_IDX].handle;
+#endif
+        if (id == HID_RPT_ID_ABS_IN) return hidAttrTbl[HID_REPORT_ABS_IN_IDX].handle;
+        if (id == HID_RPT_ID_GAMEPAD_IN) return hidAttrTbl[HID_REPORT_GAMEPAD_IN_IDX].handle;
     }
     else if (type == HID_REPORT_TYPE_OUTPUT) {
         if (id == HID_RPT_ID_LED_OUT) return hidAttrTbl[HID_REPORT_LED_OUT_IDX].handle;
@@ -306,6 +451,12 @@ uint8_t Hid_SetParameter(uint8_t id, uint8_t type, uint16_t uuid, uint8_t len, v
         // ҵӦ CCCD 
         if (id == HID_RPT_ID_KEY_IN) pCharCfg = hidReportKeyInClientCharCfg;
         else if (id == HID_RPT_ID_MOUSE_IN) pCharCfg = hidReportMouseInClientCharCfg;
+        else if (id == HID_RPT_ID_NKRO_IN) pCharCfg = hidReportNkroInClientCharCfg;
+#ifdef ENABLE_COMBO_REPORT
+        else if (id == HID_RPT_ID_COMBO_IN) pCharCfg = hidReportComboInClientCharCfg;
+#endif
+        else if (id == HID_RPT_ID_ABS_IN) pCharCfg = hidReportAbsInClientCharCfg;
+        else if (id == HID_RPT_ID_GAMEPAD_IN) pCharCfg = hidReportGamepadInClientCharCfg;
 
         if (pCharCfg != NULL)
         {
@@ -31,6 +31,9 @@ extern "C" {
 
 // HID Device Parameters
 #define HIDDEV_ERASE_ALLBONDS             0     // Erase all of the bonded devices. Write Only. No Size.
+#define HIDDEV_RECONNECT_ADV              1     // Reconnect advertising timing. Read/Write. Size is hidDevAdvParam_t.
+#define HIDDEV_PAIRING_MODE               2     // Open advertising to any host until a host pairs or it times out. Read/Write. Size is uint8_t.
+#define HIDDEV_SCAN_REQ_COUNT             3     // Scan requests accepted while advertising (needs TGAP_ADV_SCAN_REQ_NOTIFY). Read only. Size is uint32_t.
 
 // HID read/write operation
 #define HID_DEV_OPER_WRITE                0     // Write operation
@@ -241,6 +244,16 @@ typedef struct
 
 } hidDevCfg_t;
 
+// Reconnect advertising timing (advertising units of 0.625 ms)
+typedef struct
+{
+    uint16_t highIntMin;  // High duty cycle advertising interval
+    uint16_t highIntMax;
+    uint16_t highTimeout; // High duty cycle advertising duration in seconds
+    uint16_t lowIntMin;   // Low duty cycle advertising interval (no timeout)
+    uint16_t lowIntMax;
+} hidDevAdvParam_t;
+
 /*********************************************************************
  * Global Variables
  */
@@ -268,12 +281,23 @@ typedef void (*hidDevEvtCB_t)(uint8_t evt);
 typedef void (*hidDevPasscodeCB_t)(uint8_t *deviceAddr, uint16_t connectionHandle,
                                    uint8_t uiInputs, uint8_t uiOutputs);
 
+// Scan Interval Window written by the host (units of 0.625 ms)
+typedef void (*hidDevScanParamCB_t)(uint16_t connHandle, uint16_t scanInterval,
+                                    uint16_t scanWindow);
+
+// Pairing state (GAPBOND_PAIRING_STATE_COMPLETE / _BONDED) with its status
+typedef void (*hidDevPairStateCB_t)(uint16_t connHandle, uint8_t state, uint8_t status);
+
 typedef struct
 {
     hidDevReportCB_t      reportCB;
     hidDevEvtCB_t         evtCB;
     hidDevPasscodeCB_t    passcodeCB;
     gapRolesStateNotify_t pfnStateChange; //!< Whenever the device changes state
+    gapRolesParamUpdateCB_t pfnParamUpdate; //!< When the connection parameters are updated
+    gapRolesRssiRead_t    pfnRssiRead;    //!< When a valid RSSI is read from controller
+    hidDevScanParamCB_t   scanParamCB;    //!< When the host writes its scan interval and window
+    hidDevPairStateCB_t   pairStateCB;    //!< When pairing completes or a bonded link is encrypted
 } hidDevCB_t;
 
 /*********************************************************************
@@ -345,6 +369,29 @@ extern void HidDev_RegisterReports(uint8_t numReports, hidRptMap_t *pRpt);
  */
 extern uint8_t HidDev_Report(uint8_t id, uint8_t type, uint8_t len, uint8_t *pData);
 
+/*********************************************************************
+ * @fn      HidDev_GetMaxReportLen
+ *
+ * @brief   Largest report that fits in one notification on the
+ *          current connection (negotiated ATT_MTU - 3).
+ *
+ * @return  Report length in bytes.
+ */
+extern uint8_t HidDev_GetMaxReportLen(void);
+
+/*********************************************************************
+ * @fn      HidDev_IsNotifyEnabled
+ *
+ * @brief   Whether the host has enabled notifications for a report
+ *          on the current connection.
+ *
+ * @param   id - HID report ID.
+ * @param   type - HID report type.
+ *
+ * @return  TRUE if enabled, FALSE otherwise.
+ */
+extern uint8_t HidDev_IsNotifyEnabled(uint8_t id, uint8_t type);
+
 /*********************************************************************
  * @fn      HidDev_Close
  *
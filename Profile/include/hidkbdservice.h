@@ -15,16 +15,47 @@ extern "C" {
  */
 
 // Number of HID reports defined in the service
-// Keyboard In, Mouse In, LED Out, Boot In, Boot Out, Feature
-#define HID_NUM_REPORTS        6
+// Keyboard In, LED Out, Mouse In, Boot In, Boot Out, Feature, (Combo In), Abs In, Gamepad In, NKRO In, Battery
+#ifdef ENABLE_COMBO_REPORT
+#define HID_NUM_REPORTS        11
+#else
+#define HID_NUM_REPORTS        10
+#endif
 
 // HID Report IDs for the service
 // ע⣺豸ʹ÷0 ID
 #define HID_RPT_ID_KEY_IN      1                      // Keyboard input report ID
 #define HID_RPT_ID_MOUSE_IN    2                      // Mouse input report ID
+#define HID_RPT_ID_NKRO_IN     3                      // NKRO keyboard input report ID
+#define HID_RPT_ID_COMBO_IN    4                      // Keyboard + mouse combined input report ID
+#define HID_RPT_ID_ABS_IN      5                      // Digitizer pen (absolute pointer) input report ID
+#define HID_RPT_ID_GAMEPAD_IN  6                      // Gamepad input report ID
 #define HID_RPT_ID_LED_OUT     1                      // LED output report ID
 #define HID_RPT_ID_FEATURE     0                      // Feature report ID (δõ)
 
+// NKRO ģ[Mods, λͼ usage 0x00~0xDF]Э ATT_MTU >= 32 ܵ
+#define HID_NKRO_KEY_MAX       0xDF                   // λͼǵ
+#define HID_NKRO_IN_RPT_LEN    (1 + (HID_NKRO_KEY_MAX + 1) / 8)
+
+// ϲ (ENABLE_COMBO_REPORT)[Mods, , 6 , 갴, X, Y, ]
+// ̼Ƕָ뼯ϣWindows е÷ĬϹر
+#define HID_COMBO_IN_RPT_LEN   12
+
+// λʱģ[λ, X 16 bit, Y 16 bit, ѹ 16 bit]USB ߼ΧԤŵΧ
+#define HID_ABS_IN_RPT_LEN     7
+#define HID_ABS_XY_MAX         32767
+#define HID_ABS_PRESSURE_MAX   4095
+#define HID_ABS_SW_TIP         0x01                   // ʼӴ
+#define HID_ABS_SW_BARREL      0x02                   // 
+#define HID_ABS_SW_ERASER      0x04                   // Ƥ
+#define HID_ABS_SW_IN_RANGE    0x08                   // ڸӦΧ (ͣ)
+
+// ֱģ[ 16 bit, ޣ (0~78 = ɿ), X, Y, Z, Rx, Ry, Rz (int8 -127~127)]
+#define HID_GAMEPAD_IN_RPT_LEN 9
+#define HID_GAMEPAD_BUTTONS    16
+#define HID_GAMEPAD_AXES       6
+#define HID_GAMEPAD_HAT_NULL   8
+
 // HID feature flags
 #define HID_FEATURE_FLAGS      HID_FLAGS_REMOTE_WAKE
 
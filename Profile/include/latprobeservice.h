@@ -0,0 +1,101 @@
+/*********************************************************************
+ * File Name          : latprobeservice.h
+ * Author             : DIY User & AI Assistant
+ * Description        : տӳ̽ (Զ GATT )
+ *********************************************************************/
+
+#ifndef LATPROBESERVICE_H
+#define LATPROBESERVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// 128-bit vendor UUID base: 7a1c0000-5d3e-4b8a-9f21-3c6d8e0b4a17
+// (little endian, 16-bit short UUID goes into bytes 12-13)
+#define LATPROBE_UUID(uuid)    0x17, 0x4a, 0x0b, 0x8e, 0x6d, 0x3c, 0x21, 0x9f, \
+                               0x8a, 0x4b, 0x3e, 0x5d, LO_UINT16(uuid), HI_UINT16(uuid), 0x1c, 0x7a
+
+#define LATPROBE_SERV_UUID     0x0001
+#define LATPROBE_ECHO_UUID     0x0002
+
+// Probe request written by the host (write without response):
+//   [0..1] sequence number, [2..5] host timestamp (opaque to the adapter)
+#define LATPROBE_REQ_LEN       6
+
+// Echo notification:
+//   [0..5]   request, echoed unchanged
+//   [6..9]   receive time, RTC 32768 Hz cycles
+//   [10..13] notification queued time, RTC 32768 Hz cycles
+//   [14]     keyboard report queue depth
+//   [15]     link layer packets not yet acknowledged by the host
+#define LATPROBE_ECHO_LEN      16
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * Profile Callbacks
+ */
+
+// Returns the application's current report queue depth
+typedef uint8_t (*latProbeDepthCB_t)(void);
+
+/*********************************************************************
+ * API FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      LatProbe_AddService
+ *
+ * @brief   Initializes the Latency Probe Service by registering
+ *          GATT attributes with the GATT server.
+ *
+ * @return  Success or Failure
+ */
+extern bStatus_t LatProbe_AddService(void);
+
+/*********************************************************************
+ * @fn      LatProbe_Register
+ *
+ * @brief   Register the queue depth callback with the Latency Probe Service.
+ *
+ * @param   pfnDepthCB - Callback function.
+ *
+ * @return  None.
+ */
+extern void LatProbe_Register(latProbeDepthCB_t pfnDepthCB);
+
+/*********************************************************************
+ * @fn          LatProbe_HandleConnStatusCB
+ *
+ * @brief       Latency Probe Service link status change handler function.
+ *
+ * @param       connHandle - connection handle
+ * @param       changeType - type of change
+ *
+ * @return      none
+ */
+extern void LatProbe_HandleConnStatusCB(uint16_t connHandle, uint8_t changeType);
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATPROBESERVICE_H */
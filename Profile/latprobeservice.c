@@ -0,0 +1,315 @@
+/*********************************************************************
+ * File Name          : latprobeservice.c
+ * Author             : DIY User & AI Assistant
+ * Description        : տӳ̽ (Զ GATT )
+ *                      - Ӧдʱյʱ̣
+ *                        һ֪ͨ (һ¼)ʱļ̶
+ *                        ·δӦűݴͳӳ붶
+ *                      - δ֪ͨʱдֱӺԣռκλ
+ *                      -  HID ֮עᣬѰľӰ
+ *********************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "CONFIG.h"
+#include "latprobeservice.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+// Latency probe service
+const uint8_t latProbeServUUID[ATT_UUID_SIZE] = {LATPROBE_UUID(LATPROBE_SERV_UUID)};
+
+// Echo characteristic
+const uint8_t latProbeEchoUUID[ATT_UUID_SIZE] = {LATPROBE_UUID(LATPROBE_ECHO_UUID)};
+
+/*********************************************************************
+ * EXTERNAL VARIABLES
+ */
+
+/*********************************************************************
+ * EXTERNAL FUNCTIONS
+ */
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Application callback
+static latProbeDepthCB_t latProbeDepthCB = NULL;
+
+/*********************************************************************
+ * Profile Attributes - variables
+ */
+
+// Latency Probe Service attribute
+static const gattAttrType_t latProbeService = {ATT_UUID_SIZE, latProbeServUUID};
+
+// Echo characteristic
+static uint8_t       latProbeEchoProps = GATT_PROP_WRITE_NO_RSP | GATT_PROP_NOTIFY;
+static uint8_t       latProbeEcho[LATPROBE_REQ_LEN];
+static gattCharCfg_t latProbeEchoClientCharCfg[GATT_MAX_NUM_CONN];
+
+/*********************************************************************
+ * Profile Attributes - Table
+ */
+
+static gattAttribute_t latProbeAttrTbl[] = {
+    // Latency Probe Service attribute
+    {
+        {ATT_BT_UUID_SIZE, primaryServiceUUID}, /* type */
+        GATT_PERMIT_READ,                       /* permissions */
+        0,                                      /* handle */
+        (uint8_t *)&latProbeService             /* pValue */
+    },
+
+    // Echo declaration
+    {
+        {ATT_BT_UUID_SIZE, characterUUID},
+        GATT_PERMIT_READ,
+        0,
+        &latProbeEchoProps},
+
+    // Echo characteristic
+    {
+        {ATT_UUID_SIZE, latProbeEchoUUID},
+        GATT_PERMIT_ENCRYPT_WRITE,
+        0,
+        latProbeEcho},
+
+    // Echo characteristic client characteristic configuration
+    {
+        {ATT_BT_UUID_SIZE, clientCharCfgUUID},
+        GATT_PERMIT_READ | GATT_PERMIT_ENCRYPT_WRITE,
+        0,
+        (uint8_t *)&latProbeEchoClientCharCfg}
+};
+
+// Attribute index enumeration-- these indexes match array elements above
+enum
+{
+    LATPROBE_SERVICE_IDX,   // Latency Probe Service
+    LATPROBE_ECHO_DECL_IDX, // Echo declaration
+    LATPROBE_ECHO_IDX,      // Echo characteristic
+    LATPROBE_ECHO_CCCD_IDX  // Echo characteristic client characteristic configuration
+};
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+static bStatus_t latProbeWriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
+                                     uint8_t *pValue, uint16_t len, uint16_t offset, uint8_t method);
+static bStatus_t latProbeReadAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
+                                    uint8_t *pValue, uint16_t *pLen, uint16_t offset, uint16_t maxLen, uint8_t method);
+static void      latProbeEchoNotify(uint16_t connHandle, uint8_t *pReq, uint32_t rxTime);
+
+/*********************************************************************
+ * PROFILE CALLBACKS
+ */
+
+// Service Callbacks
+gattServiceCBs_t latProbeCBs = {
+    latProbeReadAttrCB,  // Read callback function pointer
+    latProbeWriteAttrCB, // Write callback function pointer
+    NULL                 // Authorization callback function pointer
+};
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+/*********************************************************************
+ * @fn      LatProbe_AddService
+ *
+ * @brief   Initializes the Latency Probe Service by registering
+ *          GATT attributes with the GATT server.
+ *
+ * @return  Success or Failure
+ */
+bStatus_t LatProbe_AddService(void)
+{
+    uint8_t status = SUCCESS;
+
+    // Initialize Client Characteristic Configuration attributes
+    GATTServApp_InitCharCfg(INVALID_CONNHANDLE, latProbeEchoClientCharCfg);
+
+    // Register GATT attribute list and CBs with GATT Server App
+    status = GATTServApp_RegisterService(latProbeAttrTbl, GATT_NUM_ATTRS(latProbeAttrTbl), GATT_MAX_ENCRYPT_KEY_SIZE,
+                                         &latProbeCBs);
+
+    return (status);
+}
+
+/*********************************************************************
+ * @fn      LatProbe_Register
+ *
+ * @brief   Register the queue depth callback with the Latency Probe Service.
+ *
+ * @param   pfnDepthCB - Callback function.
+ *
+ * @return  None.
+ */
+void LatProbe_Register(latProbeDepthCB_t pfnDepthCB)
+{
+    latProbeDepthCB = pfnDepthCB;
+}
+
+/*********************************************************************
+ * @fn          latProbeEchoNotify
+ *
+ * @brief       Echo a probe request back to the host. The notification is
+ *              queued here and goes out on the next connection event.
+ *
+ * @param       connHandle - connection handle
+ * @param       pReq - probe request written by the host
+ * @param       rxTime - receive time, RTC 32768 Hz cycles
+ *
+ * @return      none
+ */
+static void latProbeEchoNotify(uint16_t connHandle, uint8_t *pReq, uint32_t rxTime)
+{
+    attHandleValueNoti_t noti;
+    uint32_t             unack, txTime;
+
+    noti.pValue = GATT_bm_alloc(connHandle, ATT_HANDLE_VALUE_NOTI, LATPROBE_ECHO_LEN, NULL, 0);
+    if(noti.pValue == NULL)
+    {
+        return;
+    }
+
+    noti.handle = latProbeAttrTbl[LATPROBE_ECHO_IDX].handle;
+    noti.len = LATPROBE_ECHO_LEN;
+    tmos_memcpy(noti.pValue, pReq, LATPROBE_REQ_LEN);
+    noti.pValue[6] = BREAK_UINT32(rxTime, 0);
+    noti.pValue[7] = BREAK_UINT32(rxTime, 1);
+    noti.pValue[8] = BREAK_UINT32(rxTime, 2);
+    noti.pValue[9] = BREAK_UINT32(rxTime, 3);
+    noti.pValue[14] = (latProbeDepthCB != NULL) ? (*latProbeDepthCB)() : 0;
+    unack = LL_GetNumberOfUnAckPacket(connHandle);
+    noti.pValue[15] = (unack > 0xFF) ? 0xFF : (uint8_t)unack;
+
+    // Stamp as late as possible so that the host can subtract the adapter's own processing time
+    txTime = RTC_GetCycle32k();
+    noti.pValue[10] = BREAK_UINT32(txTime, 0);
+    noti.pValue[11] = BREAK_UINT32(txTime, 1);
+    noti.pValue[12] = BREAK_UINT32(txTime, 2);
+    noti.pValue[13] = BREAK_UINT32(txTime, 3);
+
+    if(GATT_Notification(connHandle, &noti, FALSE) != SUCCESS)
+    {
+        GATT_bm_free((gattMsg_t *)&noti, ATT_HANDLE_VALUE_NOTI);
+    }
+}
+
+/*********************************************************************
+ * @fn          latProbeReadAttrCB
+ *
+ * @brief       Read an attribute.
+ *
+ * @param       connHandle - connection message was received on
+ * @param       pAttr - pointer to attribute
+ * @param       pValue - pointer to data to be read
+ * @param       pLen - length of data to be read
+ * @param       offset - offset of the first octet to be read
+ * @param       maxLen - maximum length of data to be read
+ *
+ * @return      Success or Failure
+ */
+static bStatus_t latProbeReadAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
+                                    uint8_t *pValue, uint16_t *pLen, uint16_t offset, uint16_t maxLen, uint8_t method)
+{
+    // No readable characteristic values in this service
+    return (ATT_ERR_ATTR_NOT_FOUND);
+}
+
+/*********************************************************************
+ * @fn      latProbeWriteAttrCB
+ *
+ * @brief   Validate attribute data prior to a write operation
+ *
+ * @param   connHandle - connection message was received on
+ * @param   pAttr - pointer to attribute
+ * @param   pValue - pointer to data to be written
+ * @param   len - length of data
+ * @param   offset - offset of the first octet to be written
+ *
+ * @return  Success or Failure
+ */
+static bStatus_t latProbeWriteAttrCB(uint16_t connHandle, gattAttribute_t *pAttr,
+                                     uint8_t *pValue, uint16_t len, uint16_t offset, uint8_t method)
+{
+    bStatus_t status = SUCCESS;
+
+    // Make sure it's not a blob operation (no attributes in the profile are long)
+    if(offset > 0)
+    {
+        return (ATT_ERR_ATTR_NOT_LONG);
+    }
+
+    if(pAttr->type.len == ATT_UUID_SIZE)
+    {
+        // Echo characteristic: stamp first, everything else is off the measured path
+        uint32_t rxTime = RTC_GetCycle32k();
+
+        if(len != LATPROBE_REQ_LEN)
+        {
+            status = ATT_ERR_INVALID_VALUE_SIZE;
+        }
+        else if(GATTServApp_ReadCharCfg(connHandle, latProbeEchoClientCharCfg) & GATT_CLIENT_CFG_NOTIFY)
+        {
+            latProbeEchoNotify(connHandle, pValue, rxTime);
+        }
+    }
+    else if(BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]) == GATT_CLIENT_CHAR_CFG_UUID)
+    {
+        status = GATTServApp_ProcessCCCWriteReq(connHandle, pAttr, pValue, len,
+                                                offset, GATT_CLIENT_CFG_NOTIFY);
+    }
+    else
+    {
+        status = ATT_ERR_ATTR_NOT_FOUND;
+    }
+
+    return (status);
+}
+
+/*********************************************************************
+ * @fn          LatProbe_HandleConnStatusCB
+ *
+ * @brief       Latency Probe Service link status change handler function.
+ *
+ * @param       connHandle - connection handle
+ * @param       changeType - type of change
+ *
+ * @return      none
+ */
+void LatProbe_HandleConnStatusCB(uint16_t connHandle, uint8_t changeType)
+{
+    // Make sure this is not loopback connection
+    if(connHandle != LOOPBACK_CONNHANDLE)
+    {
+        // Reset Client Char Config if connection has dropped
+        if((changeType == LINKDB_STATUS_UPDATE_REMOVED) ||
+           ((changeType == LINKDB_STATUS_UPDATE_STATEFLAGS) &&
+            (!linkDB_Up(connHandle))))
+        {
+            GATTServApp_InitCharCfg(connHandle, latProbeEchoClientCharCfg);
+        }
+    }
+}
+
+/*********************************************************************
+*********************************************************************/
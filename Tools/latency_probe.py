@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+空口往返延迟测量工具 (配合固件延迟探测服务 latprobeservice.c)
+
+按固定间隔向回显特征值无响应写入 <序号 u16><主机时间戳 u32>，收到回显通知后计算:
+
+- rtt    : 主机写入到收到通知的往返时间
+- hold   : 适配器从收到写入到通知入队的处理时间 (RTC 32768Hz 计时)
+- queue  : 回显时的键盘队列深度
+- unack  : 回显时链路层未应答包数
+
+结束后输出分位数统计；加 --csv 时逐条输出原始数据。
+需要先与适配器完成配对绑定 (服务要求加密)。
+
+依赖:
+    pip install bleak
+
+用法:
+    python3 latency_probe.py <地址> [-n 500] [-i 0.05] [--csv]
+"""
+
+import argparse
+import asyncio
+import struct
+import sys
+import time
+
+from bleak import BleakClient
+
+ECHO_UUID = "7a1c0002-5d3e-4b8a-9f21-3c6d8e0b4a17"
+ECHO_FMT = "<HIIIBB"      # seq, host_ts, rx, tx, queue, unack
+RTC_HZ = 32768
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def summary(out, name, values, unit):
+    if not values:
+        return
+    out.write("%-6s min %7.2f  p50 %7.2f  p90 %7.2f  p99 %7.2f  max %7.2f  %s" % (
+        name, min(values), percentile(values, 50), percentile(values, 90),
+        percentile(values, 99), max(values), unit))
+    out.write("\n")
+
+
+async def run(args):
+    sent = {}
+    rows = []
+    t0 = time.perf_counter()
+
+    def host_us():
+        return int((time.perf_counter() - t0) * 1e6) & 0xFFFFFFFF
+
+    def on_echo(_, data):
+        now = host_us()
+        if len(data) < struct.calcsize(ECHO_FMT):
+            return
+        seq, ts, rx, tx, queue, unack = struct.unpack_from(ECHO_FMT, data)
+        if sent.pop(seq, None) is None:
+            return
+        rtt_ms = ((now - ts) & 0xFFFFFFFF) / 1000.0
+        hold_ms = ((tx - rx) & 0xFFFFFFFF) * 1000.0 / RTC_HZ
+        rows.append((seq, rtt_ms, hold_ms, queue, unack))
+        if args.csv:
+            print("%d,%.3f,%.3f,%d,%d" % rows[-1])
+
+    async with BleakClient(args.address) as client:
+        await client.start_notify(ECHO_UUID, on_echo)
+        if args.csv:
+            print("seq,rtt_ms,hold_ms,queue,unack")
+        for seq in range(args.count):
+            seq &= 0xFFFF
+            ts = host_us()
+            sent[seq] = ts
+            await client.write_gatt_char(ECHO_UUID, struct.pack("<HI", seq, ts), response=False)
+            await asyncio.sleep(args.interval)
+        await asyncio.sleep(0.5)
+        await client.stop_notify(ECHO_UUID)
+
+    out = sys.stderr if args.csv else sys.stdout
+    out.write("sent %d  echoed %d  lost %d\n" % (args.count, len(rows), len(sent)))
+    summary(out, "rtt", [r[1] for r in rows], "ms")
+    summary(out, "hold", [r[2] for r in rows], "ms")
+    summary(out, "queue", [r[3] for r in rows], "")
+    summary(out, "unack", [r[4] for r in rows], "")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="BLE round-trip latency probe")
+    parser.add_argument("address", help="适配器蓝牙地址 (macOS 上为设备 UUID)")
+    parser.add_argument("-n", "--count", type=int, default=500, help="探测次数")
+    parser.add_argument("-i", "--interval", type=float, default=0.05, help="探测间隔 (秒)")
+    parser.add_argument("--csv", action="store_true", help="逐条输出原始数据 (统计输出到 stderr)")
+    asyncio.run(run(parser.parse_args()))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,431 @@
+/*********************************************************************
+ * File Name          : rf_link_sim.c
+ * Author             : DIY User & AI Assistant
+ * Description        : 2.4G 私有链路协议主机模拟器 (配合固件 APP/rf_link.c)
+ *                      - 在 Linux 上按 1ms 时隙驱动适配器与接收器两端的协议核心
+ *                      - 信道模型：帧与 ACK 各自独立随机丢失；Wi-Fi 干扰覆盖连续 10 个信道，
+ *                        突发开关 (平均开 5ms / 关 20ms)；可选中途完全遮挡一段时间 (检验失步重捕获)
+ *                      - 负载：泊松按键 (在几个键与一个修饰键间随机按下/松开，可重叠，每次变化
+ *                        一帧 Boot 键盘状态) + 周期性 1kHz 鼠标移动突发，入队规则与固件桥接层
+ *                        一致：键盘排队保序，鼠标已有一帧在排队时继续累计位移
+ *                      - 每个样本带唯一编号 (按链路序号对应)，接收端按类型校验顺序与完整性，
+ *                        输出产生到投递的延迟分位数、重传率、丢失与重复统计
+ *                      - 接收端由相邻两次投递的键盘状态还原按下/松开沿，与产生的沿逐个计数
+ *                        比对 (放弃的报文不得丢沿)，并校验最终状态
+ *
+ * 编译:
+ *     gcc -O2 -I APP/include Tools/rf_link_sim.c APP/rf_link.c -o rf_link_sim
+ *
+ * 用法:
+ *     ./rf_link_sim [-t 秒] [-p 丢包率] [-j 干扰丢包率] [-b 遮挡ms] [-s 种子] [--sweep | --edges]
+ *
+ *     --edges: 多个种子下在鼠标静止期遮挡 1 秒，迫使键盘报文重传超限，
+ *              检查放弃报文后接收端仍看到每个按下/松开沿，有遗漏时返回 1
+ *********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rf_link.h"
+
+// ===================================================================
+// 模拟参数
+// ===================================================================
+#define SIM_LINK_SEED             0x5EED1224  // 跳频表种子 (两端一致)
+#define SIM_KEY_RATE              8.0         // 平均按键次数/秒 (每次按下+松开两帧)
+#define SIM_KEY_NUM               4           // 参与的普通键 (键码 0x04 起)，另加左 Shift
+#define SIM_KEY_MOD               0x02        // 左 Shift 修饰位
+#define SIM_MOUSE_BURST_MS        400         // 鼠标移动突发时长 (期间每 1ms 一个样本)
+#define SIM_MOUSE_GAP_MS          1600        // 鼠标静止时长
+#define SIM_JAM_FIRST             12          // 干扰覆盖信道 12~21 (约一个 20MHz Wi-Fi 信道)
+#define SIM_JAM_WIDTH             10
+#define SIM_JAM_ON_MS             5.0         // 干扰突发平均持续
+#define SIM_JAM_OFF_MS            20.0
+#define SIM_KBD_BACKLOG           64          // 模拟桥接层键盘队列
+#define SIM_MAX_SECONDS           1000
+#define SIM_MAX_MSGS              (SIM_MAX_SECONDS * 1000 * 2)
+
+typedef struct {
+    double   loss;          // 帧/ACK 独立丢失概率
+    double   jam;           // 干扰开启时落在干扰信道上的帧丢失概率 (0 = 无干扰)
+    uint32_t block_ms;      // 中途完全遮挡时长
+    uint32_t seconds;
+    uint32_t seed;
+} SimCfg_t;
+
+typedef struct {
+    uint32_t gen;           // 产生时刻 (时隙)
+    uint32_t done;          // 投递时刻 (0 = 未投递)
+    uint32_t carrier;       // 鼠标样本并入的报文编号 (自身 = 未合并)
+    uint8_t  type;
+} SimMsg_t;
+
+typedef struct {
+    uint32_t  n;
+    uint32_t  lost;
+    uint32_t  superseded;
+    uint64_t  sum;
+    uint32_t *lat;
+} SimLat_t;
+
+static SimMsg_t *msgs;
+static uint32_t  msg_count;
+static uint32_t  now;
+static int64_t   last_id[3];       // 按报文类型的最近投递编号
+static uint32_t  out_of_order;
+static uint32_t  redelivered;
+static uint32_t  seq_id[256];      // 链路序号 -> 样本编号 (在途报文不超过队列深度)
+static uint8_t   rx_seq;           // 正在处理的帧的序号
+
+// 按键沿 [0] = 按下, [1] = 松开；下标为键 (SIM_KEY_NUM = 修饰键)
+static uint32_t  edge_gen[2][SIM_KEY_NUM + 1];
+static uint32_t  edge_rx[2][SIM_KEY_NUM + 1];
+static uint8_t   kbd_rx[RFL_PAYLOAD_MAX];  // 接收端最近投递的键盘状态
+
+// ===================================================================
+// 随机数与信道模型
+// ===================================================================
+static uint64_t rng_state;
+static int      jam_on;
+
+static double Sim_Rand(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (double)(rng_state >> 11) / (double)(1ULL << 53);
+}
+
+/**
+ * @brief 推进一个时隙的干扰状态 (两态马尔可夫)
+ */
+static void Sim_JamStep(const SimCfg_t *cfg)
+{
+    if (cfg->jam <= 0) return;
+    if (jam_on) {
+        if (Sim_Rand() < 1.0 / SIM_JAM_ON_MS) jam_on = 0;
+    } else {
+        if (Sim_Rand() < 1.0 / SIM_JAM_OFF_MS) jam_on = 1;
+    }
+}
+
+/**
+ * @brief 一次空中传输是否成功
+ */
+static int Sim_Pass(const SimCfg_t *cfg, uint8_t ch, uint32_t t)
+{
+    uint32_t mid = cfg->seconds * 500;
+
+    if (cfg->block_ms && t >= mid && t < mid + cfg->block_ms) return 0;
+    if (jam_on && ch >= SIM_JAM_FIRST && ch < SIM_JAM_FIRST + SIM_JAM_WIDTH &&
+        Sim_Rand() < cfg->jam) {
+        return 0;
+    }
+    return Sim_Rand() >= cfg->loss;
+}
+
+// ===================================================================
+// 负载与接收端投递
+// ===================================================================
+static uint32_t Sim_NewMsg(uint8_t type)
+{
+    msgs[msg_count].gen     = now;
+    msgs[msg_count].done    = 0;
+    msgs[msg_count].carrier = msg_count;
+    msgs[msg_count].type    = type;
+    return msg_count++;
+}
+
+/**
+ * @brief Boot 键盘状态中第 k 个模拟键是否按下
+ */
+static int Sim_KeyDown(const uint8_t *rpt, int k)
+{
+    int i;
+
+    if (k == SIM_KEY_NUM) return (rpt[0] & SIM_KEY_MOD) != 0;
+    for (i = 2; i < 8; i++) {
+        if (rpt[i] == 0x04 + k) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 由相邻两个键盘状态累计按下/松开沿
+ */
+static void Sim_CountEdges(uint32_t edges[2][SIM_KEY_NUM + 1], const uint8_t *prev, const uint8_t *cur)
+{
+    int k, a, b;
+
+    for (k = 0; k <= SIM_KEY_NUM; k++) {
+        a = Sim_KeyDown(prev, k);
+        b = Sim_KeyDown(cur, k);
+        if (!a && b) edges[0][k]++;
+        if (a && !b) edges[1][k]++;
+    }
+}
+
+static void Sim_Deliver(uint8_t type, const uint8_t *data, uint8_t len)
+{
+    uint32_t id = seq_id[rx_seq];
+
+    if (type > RFL_TYPE_MOUSE) return;
+    if (type == RFL_TYPE_KBD && len == 8) {
+        Sim_CountEdges(edge_rx, kbd_rx, data);
+        memcpy(kbd_rx, data, 8);
+    }
+    if ((int64_t)id <= last_id[type]) {
+        if (msgs[id].done) redelivered++;
+        else out_of_order++;
+        return;
+    }
+    last_id[type] = id;
+    msgs[id].done = now;
+}
+
+static int Sim_CmpU32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 汇总某类样本的产生到投递延迟
+ *        未投递的键盘状态若之后有已投递的键盘状态，按被取代计 (其按键沿是否送达由
+ *        Sim_CountEdges 另行核对)
+ */
+static void Sim_Collect(SimLat_t *s, uint8_t type, uint32_t slots)
+{
+    uint32_t i, done, later_done = 0;
+
+    memset(s, 0, sizeof(*s));
+    s->lat = malloc(sizeof(uint32_t) * (msg_count + 1));
+
+    for (i = msg_count; i-- > 0;) {
+        if (msgs[i].type != type) continue;
+        done = msgs[msgs[i].carrier].done;
+        if (done) {
+            s->lat[s->n++] = done - msgs[i].gen + 1;
+            s->sum += done - msgs[i].gen + 1;
+            later_done = 1;
+        } else if (msgs[i].gen + 1000 < slots) {
+            // 结束前 1 秒内产生的样本可能仍在途，不计入
+            if (type == RFL_TYPE_KBD && later_done) s->superseded++;
+            else s->lost++;
+        }
+    }
+    qsort(s->lat, s->n, sizeof(uint32_t), Sim_CmpU32);
+}
+
+static void Sim_PrintLat(const char *name, const SimLat_t *s)
+{
+    if (!s->n) return;
+    printf("%-5s latency avg %.2f  p50 %u  p90 %u  p99 %u  p99.9 %u  max %u ms "
+           "(%u samples, %u superseded, %u lost)\n",
+           name, (double)s->sum / s->n, s->lat[s->n / 2], s->lat[s->n * 9 / 10],
+           s->lat[s->n * 99 / 100], s->lat[(uint32_t)(s->n * 0.999)], s->lat[s->n - 1],
+           s->n, s->superseded, s->lost);
+}
+
+// ===================================================================
+// 主循环
+// ===================================================================
+
+/**
+ * @brief 运行一次模拟
+ * @param verbose  1 = 输出完整报告，0 = 输出一行 (扫描模式)
+ * @return 接收端遗漏的按键沿数 (最终状态不一致另计 1)
+ */
+static uint32_t Sim_Run(const SimCfg_t *cfg, int verbose)
+{
+    static RfLink_t dev, dgl;
+    uint8_t  frame[RFL_FRAME_MAX], ack[RFL_ACK_LEN], ack_len, len, ch;
+    uint8_t  payload[RFL_PAYLOAD_MAX];
+    uint8_t  kbd_state[8] = {0}, kbd_prev[8];
+    uint8_t  kbd_backlog[SIM_KBD_BACKLOG][8];
+    uint32_t kbd_backlog_id[SIM_KBD_BACKLOG], kbd_head = 0, kbd_count = 0;
+    uint32_t mouse_held = 0, slots = cfg->seconds * 1000, i, id;
+    uint32_t edges_missed = 0, gen_press = 0, gen_release = 0, rx_press = 0, rx_release = 0;
+    int      has_mouse = 0, k, n;
+    double   key_p = SIM_KEY_RATE * 2 / 1000.0;
+    SimLat_t kl, ml;
+
+    rng_state = 0x9E3779B97F4A7C15ULL ^ cfg->seed;
+    jam_on = 0;
+    last_id[0] = last_id[1] = last_id[2] = -1;
+    out_of_order = redelivered = 0;
+    msg_count = 0;
+    memset(edge_gen, 0, sizeof(edge_gen));
+    memset(edge_rx, 0, sizeof(edge_rx));
+    memset(kbd_rx, 0, sizeof(kbd_rx));
+
+    RfLink_Init(&dev, RFL_ROLE_DEVICE, SIM_LINK_SEED);
+    RfLink_Init(&dgl, RFL_ROLE_DONGLE, SIM_LINK_SEED);
+
+    for (now = 1; now <= slots; now++) {
+        // --- 桥接层 (时隙之间)：产生样本并入队 ---
+        // 最后 1 秒不再按键，让在途的键盘状态送达后比对按键沿
+        if (now + 1000 <= slots && Sim_Rand() < key_p && kbd_count < SIM_KBD_BACKLOG) {
+            memcpy(kbd_prev, kbd_state, 8);
+            k = (int)(Sim_Rand() * (SIM_KEY_NUM + 1));
+            if (k == SIM_KEY_NUM) {
+                kbd_state[0] ^= SIM_KEY_MOD;
+            } else if (Sim_KeyDown(kbd_state, k)) {
+                // 松开：其余键前移，保持按下顺序
+                for (i = 2, n = 2; i < 8; i++) {
+                    if (kbd_state[i] != 0x04 + k) kbd_state[n++] = kbd_state[i];
+                }
+                while (n < 8) kbd_state[n++] = 0;
+            } else {
+                for (i = 2; i < 8 && kbd_state[i]; i++);
+                kbd_state[i] = (uint8_t)(0x04 + k);
+            }
+            Sim_CountEdges(edge_gen, kbd_prev, kbd_state);
+            memcpy(kbd_backlog[(kbd_head + kbd_count) % SIM_KBD_BACKLOG], kbd_state, 8);
+            kbd_backlog_id[(kbd_head + kbd_count) % SIM_KBD_BACKLOG] = Sim_NewMsg(RFL_TYPE_KBD);
+            kbd_count++;
+        }
+        if (now % (SIM_MOUSE_BURST_MS + SIM_MOUSE_GAP_MS) < SIM_MOUSE_BURST_MS) {
+            id = Sim_NewMsg(RFL_TYPE_MOUSE);
+            if (has_mouse) {
+                msgs[id].carrier = mouse_held;   // 并入尚未入队的累计位移
+            } else {
+                mouse_held = id;
+                has_mouse  = 1;
+            }
+        }
+        while (kbd_count) {
+            seq_id[dev.tx_seq] = kbd_backlog_id[kbd_head];
+            if (RfLink_Submit(&dev, RFL_TYPE_KBD, kbd_backlog[kbd_head], 8) != RFL_OK) break;
+            kbd_head = (kbd_head + 1) % SIM_KBD_BACKLOG;
+            kbd_count--;
+        }
+        if (has_mouse && RfLink_Pending(&dev, RFL_TYPE_MOUSE) == 0) {
+            memset(payload, 0, sizeof(payload));
+            seq_id[dev.tx_seq] = mouse_held;
+            if (RfLink_Submit(&dev, RFL_TYPE_MOUSE, payload, 4) == RFL_OK) has_mouse = 0;
+        }
+
+        // --- 时隙边界：两端推进，发送端结束上一时隙并在新时隙发帧 ---
+        RfLink_Tick(&dev);
+        RfLink_Tick(&dgl);
+        Sim_JamStep(cfg);
+
+        len = RfLink_BuildFrame(&dev, frame);
+        if (!len) continue;
+        ch = RfLink_Channel(&dev);
+        if (ch != RfLink_Channel(&dgl) || !Sim_Pass(cfg, ch, now)) continue;
+        rx_seq  = frame[1];
+        ack_len = RfLink_OnFrame(&dgl, frame, len, ack, Sim_Deliver);
+        if (ack_len && Sim_Pass(cfg, ch, now)) {
+            RfLink_OnAck(&dev, ack, ack_len);
+        }
+    }
+
+    Sim_Collect(&kl, RFL_TYPE_KBD, slots);
+    Sim_Collect(&ml, RFL_TYPE_MOUSE, slots);
+
+    // 接收端看到的沿应与产生的沿逐个相等 (放弃的报文只能是沿已被后续状态带到的)
+    for (k = 0; k <= SIM_KEY_NUM; k++) {
+        edges_missed += (edge_gen[0][k] > edge_rx[0][k]) ? edge_gen[0][k] - edge_rx[0][k] : 0;
+        edges_missed += (edge_gen[1][k] > edge_rx[1][k]) ? edge_gen[1][k] - edge_rx[1][k] : 0;
+        gen_press   += edge_gen[0][k];
+        gen_release += edge_gen[1][k];
+        rx_press    += edge_rx[0][k];
+        rx_release  += edge_rx[1][k];
+    }
+    if (memcmp(kbd_rx, kbd_state, 8) != 0) edges_missed++;
+
+    if (verbose) {
+        printf("slots %u (%u s), loss %.0f%%, jammer %.0f%%, block %u ms\n",
+               slots, cfg->seconds, cfg->loss * 100, cfg->jam * 100, cfg->block_ms);
+        printf("hop table:");
+        for (i = 0; i < RFL_HOP_NUM; i++) printf(" %u", dev.hop[i]);
+        printf("\n");
+        printf("reports submitted %u, acked %u, delivered %u, superseded %u\n",
+               dev.stat.submitted, dev.stat.acked, dgl.stat.delivered, dev.stat.superseded);
+        printf("integrity out-of-order %u, redelivered %u, dongle dups dropped %u\n",
+               out_of_order, redelivered, dgl.stat.duplicates);
+        printf("key edges generated %u/%u, seen %u/%u (press/release), missed %u, final state %s\n",
+               gen_press, gen_release, rx_press, rx_release,
+               edges_missed, memcmp(kbd_rx, kbd_state, 8) ? "MISMATCH" : "ok");
+        printf("frames tx %u, retrans %u (%.1f%%), keepalive %u, rx %u, resyncs %u\n",
+               dev.stat.frames_tx, dev.stat.retrans,
+               dev.stat.frames_tx ? 100.0 * dev.stat.retrans / dev.stat.frames_tx : 0.0,
+               dev.stat.keepalives, dgl.stat.frames_rx, dgl.stat.resyncs);
+        printf("submit->ack slots 1:%u 2:%u 3-4:%u 5+:%u  max %u\n",
+               dev.stat.lat_hist[0], dev.stat.lat_hist[1], dev.stat.lat_hist[2],
+               dev.stat.lat_hist[3], dev.stat.lat_max);
+        Sim_PrintLat("key", &kl);
+        Sim_PrintLat("mouse", &ml);
+    } else {
+        printf("%5.0f%% %5.0f%% %6.1f%% %7.2f %5u %5u %5u %7.2f %5u %5u %5u %5u %5u\n",
+               cfg->loss * 100, cfg->jam * 100,
+               dev.stat.frames_tx ? 100.0 * dev.stat.retrans / dev.stat.frames_tx : 0.0,
+               kl.n ? (double)kl.sum / kl.n : 0.0, kl.n ? kl.lat[kl.n * 99 / 100] : 0,
+               kl.n ? kl.lat[kl.n - 1] : 0, kl.lost,
+               ml.n ? (double)ml.sum / ml.n : 0.0, ml.n ? ml.lat[ml.n * 99 / 100] : 0,
+               ml.n ? ml.lat[ml.n - 1] : 0, ml.lost, dev.stat.superseded, edges_missed);
+    }
+    free(kl.lat);
+    free(ml.lat);
+    return edges_missed;
+}
+
+int main(int argc, char **argv)
+{
+    SimCfg_t cfg = { 0.05, 0.9, 0, 60, 1 };
+    int      sweep = 0, edges = 0, i;
+    uint32_t missed = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--sweep")) {
+            sweep = 1;
+        } else if (!strcmp(argv[i], "--edges")) {
+            edges = 1;
+        } else if (i + 1 < argc && !strcmp(argv[i], "-t")) {
+            cfg.seconds = (uint32_t)atoi(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-p")) {
+            cfg.loss = atof(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-j")) {
+            cfg.jam = atof(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-b")) {
+            cfg.block_ms = (uint32_t)atoi(argv[++i]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            cfg.seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-t s] [-p loss] [-j jam] [-b block_ms] [-s seed] [--sweep | --edges]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.seconds == 0 || cfg.seconds > SIM_MAX_SECONDS) cfg.seconds = 60;
+
+    msgs = malloc(sizeof(SimMsg_t) * SIM_MAX_MSGS);
+    if (!msgs) return 1;
+
+    if (sweep || edges) {
+        static const double losses[] = { 0.0, 0.05, 0.1, 0.2, 0.3, 0.5 };
+        printf(" loss   jam retrans key_avg   p99   max  lost mou_avg   p99   max  lost  drop  miss\n");
+        if (edges) {
+            // 遮挡起点 (中点 30.5 s) 落在鼠标静止期，键盘报文在队首重传超限
+            cfg.seconds  = 61;
+            cfg.block_ms = 1000;
+            for (i = 1; i <= 8; i++) {
+                cfg.seed = (uint32_t)i;
+                missed += Sim_Run(&cfg, 0);
+            }
+            printf("key edges missed: %u\n", missed);
+        } else {
+            for (i = 0; i < (int)(sizeof(losses) / sizeof(losses[0])); i++) {
+                cfg.loss = losses[i];
+                missed += Sim_Run(&cfg, 0);
+            }
+        }
+    } else {
+        missed = Sim_Run(&cfg, 1);
+    }
+
+    free(msgs);
+    return missed ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+USB 抓包导出转换工具 (配合固件 DEBUG_USB_CAPTURE)
+
+从 UART 日志中提取 UsbCap_Dump() 输出的 "CAP <hex>" 行，按页序号排序去重，
+转换为回放轨迹 (每行一个中断 IN 数据包):
+
+    <时刻 ms> <端口> <端点> <数据十六进制>
+
+- 时刻相对第一条记录，端口 0 = 根端口，N = HUB 端口 N
+- 页之间有丢弃记录时插入注释行 "# dropped <n>"
+
+用法:
+    python3 usb_capture.py uart.log > trace.txt
+    python3 usb_capture.py < uart.log
+"""
+
+import struct
+import sys
+
+TICK_MS = 0.625           # TMOS tick
+PAGE_MAGIC = 0xCA01
+HDR_FMT = "<IHHBBH"       # base, magic, seq, drops, used, reserved
+HDR_LEN = struct.calcsize(HDR_FMT)
+REC_HDR = 4               # dt(2) + 端口/端点(1) + 长度(1)
+
+
+def parse_pages(lines):
+    """返回 {seq: (base, drops, records)}，同一页多次导出只保留一份"""
+    pages = {}
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("CAP ") or line == "CAP END" or line.startswith("CAP BEGIN"):
+            continue
+        raw = bytes.fromhex(line[4:])
+        if len(raw) < HDR_LEN:
+            continue
+        base, magic, seq, drops, used, _ = struct.unpack_from(HDR_FMT, raw)
+        if magic != PAGE_MAGIC or len(raw) < HDR_LEN + used:
+            continue
+        pages[seq] = (base, drops, raw[HDR_LEN:HDR_LEN + used])
+    return pages
+
+
+def order_seqs(seqs):
+    """按 16 位序号回绕规则排序：从最大间隙之后开始"""
+    seqs = sorted(seqs)
+    if len(seqs) < 2:
+        return seqs
+    gaps = [((seqs[(i + 1) % len(seqs)] - seqs[i]) & 0xFFFF, i) for i in range(len(seqs))]
+    _, last = max(gaps)
+    start = (last + 1) % len(seqs)
+    return seqs[start:] + seqs[:start]
+
+
+def convert(lines, out):
+    pages = parse_pages(lines)
+    t0 = None
+    for seq in order_seqs(pages.keys()):
+        base, drops, data = pages[seq]
+        if drops:
+            out.write("# dropped %d\n" % drops)
+        t = base
+        pos = 0
+        while pos + REC_HDR <= len(data):
+            dt, tag, n = struct.unpack_from("<HBB", data, pos)
+            payload = data[pos + REC_HDR:pos + REC_HDR + n]
+            pos += REC_HDR + n
+            t = (t + dt) & 0xFFFFFFFF
+            if t0 is None:
+                t0 = t
+            ms = ((t - t0) & 0xFFFFFFFF) * TICK_MS
+            out.write("%.3f %d %d %s\n" % (ms, tag >> 4, tag & 0x0F, payload.hex().upper()))
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], encoding="utf-8", errors="replace") as f:
+            convert(f, sys.stdout)
+    else:
+        convert(sys.stdin, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()